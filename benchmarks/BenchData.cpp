@@ -0,0 +1,78 @@
+#include "BenchData.h"
+#include "utils/Database.h"
+#include <filesystem>
+#include <map>
+#include <memory>
+
+namespace BenchData
+{
+    const char *const DATA_DIR = "bench_data/";
+
+    namespace
+    {
+        const char *const CATEGORIES[] = {"Electronics", "Books", "Clothing", "Garden", "Toys"};
+
+        std::map<size_t, std::unique_ptr<ProductManager>> &managers()
+        {
+            static std::map<size_t, std::unique_ptr<ProductManager>> cache;
+            return cache;
+        }
+    }
+
+    Product product(int id)
+    {
+        return Product(id, "Product " + std::to_string(id), "Description of product " + std::to_string(id),
+                       CATEGORIES[id % 5], 5.0 + (id % 1000) * 0.25, 100 + id % 50, 10);
+    }
+
+    Order order(int id, int itemCount)
+    {
+        Order result(id, 1 + id % 1000, "Customer " + std::to_string(id % 1000));
+        result.setShippingAddress(std::to_string(id) + " Main St, Springfield");
+        result.setNotes("Leave at the door");
+        for (int i = 0; i < itemCount; ++i)
+        {
+            int productId = 1 + (id * 7 + i) % 5000;
+            result.addItem(OrderItem(productId, "Product " + std::to_string(productId), 1 + i % 3,
+                                     5.0 + productId * 0.25));
+        }
+        return result;
+    }
+
+    std::vector<std::string> productLines(size_t count)
+    {
+        std::vector<std::string> lines;
+        lines.reserve(count);
+        for (size_t i = 1; i <= count; ++i)
+        {
+            lines.push_back(product(static_cast<int>(i)).serialize());
+        }
+        return lines;
+    }
+
+    void useDirectory(const std::string &name)
+    {
+        std::string path = std::string(DATA_DIR) + name + "/";
+        std::filesystem::create_directories(path); // Database only creates the last level
+        Database::getInstance().initialize(path);
+    }
+
+    ProductManager &products(size_t count)
+    {
+        std::unique_ptr<ProductManager> &manager = managers()[count];
+        if (!manager)
+        {
+            // Each size gets its own directory, so the manager loads only its own file
+            useDirectory("products_" + std::to_string(count));
+            Database::getInstance().saveProducts(productLines(count));
+            manager = std::make_unique<ProductManager>();
+        }
+        return *manager;
+    }
+
+    void cleanUp()
+    {
+        managers().clear();
+        std::filesystem::remove_all(DATA_DIR);
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "managers/ProductManager.h"
+#include "models/Order.h"
+#include "models/Product.h"
+#include <string>
+#include <vector>
+
+// Synthetic records shared by the benchmarks. Everything is derived from the id,
+// so every run sees the same data.
+namespace BenchData
+{
+    // Where the benchmarks keep their data files; removed when the run ends
+    extern const char *const DATA_DIR;
+
+    Product product(int id);
+    // An order with itemCount items and a free-text note
+    Order order(int id, int itemCount = 3);
+    // Serialized products, as the data file holds them
+    std::vector<std::string> productLines(size_t count);
+
+    // Points Database at DATA_DIR + name, creating it first
+    void useDirectory(const std::string &name);
+
+    // A ProductManager loaded with count products, built on first use and kept for
+    // the rest of the run so its set-up is not timed
+    ProductManager &products(size_t count);
+    // Drops the cached managers and removes DATA_DIR
+    void cleanUp();
+}
@@ -0,0 +1,42 @@
+#include "BenchData.h"
+#include "utils/Database.h"
+#include <benchmark/benchmark.h>
+
+static int64_t totalBytes(const std::vector<std::string> &lines)
+{
+    int64_t bytes = 0;
+    for (const auto &line : lines)
+    {
+        bytes += static_cast<int64_t>(line.size()) + 1;
+    }
+    return bytes;
+}
+
+static void BM_SaveToFile(benchmark::State &state)
+{
+    BenchData::useDirectory("database");
+    Database &db = Database::getInstance();
+    std::vector<std::string> lines = BenchData::productLines(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(db.saveToFile("products.txt", lines));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * totalBytes(lines));
+}
+BENCHMARK(BM_SaveToFile)->ArgName("rows")->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadFromFile(benchmark::State &state)
+{
+    BenchData::useDirectory("database");
+    Database &db = Database::getInstance();
+    std::vector<std::string> lines = BenchData::productLines(static_cast<size_t>(state.range(0)));
+    db.saveToFile("products.txt", lines);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(db.loadFromFile("products.txt"));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * totalBytes(lines));
+}
+BENCHMARK(BM_LoadFromFile)->ArgName("rows")->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,24 @@
+#include "BenchData.h"
+#include "utils/Logger.h"
+#include <benchmark/benchmark.h>
+
+// Like BENCHMARK_MAIN, but with quiet logging and the data files removed afterwards.
+// Pass --benchmark_out=results.json --benchmark_out_format=json to keep the results.
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    Logger &logger = Logger::getInstance();
+    logger.initialize("bench_logs/bench.log", LogLevel::WARNING);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    BenchData::cleanUp();
+    logger.close();
+    return 0;
+}
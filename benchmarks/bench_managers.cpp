@@ -0,0 +1,29 @@
+#include "BenchData.h"
+#include <benchmark/benchmark.h>
+
+// Looks up ids spread over the whole catalogue
+static void BM_GetProduct(benchmark::State &state)
+{
+    ProductManager &manager = BenchData::products(static_cast<size_t>(state.range(0)));
+    int count = static_cast<int>(state.range(0));
+    int id = 0;
+    for (auto _ : state)
+    {
+        id = (id + 7919) % count;
+        benchmark::DoNotOptimize(manager.getProduct(id + 1));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetProduct)->ArgName("rows")->Arg(1000)->Arg(100000)->Arg(1000000);
+
+// A substring that matches about one product in ten
+static void BM_SearchByName(benchmark::State &state)
+{
+    ProductManager &manager = BenchData::products(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(manager.searchByName("product 1"));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SearchByName)->ArgName("rows")->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,25 @@
+#include "BenchData.h"
+#include <benchmark/benchmark.h>
+
+static void BM_OrderSerialize(benchmark::State &state)
+{
+    Order order = BenchData::order(42, static_cast<int>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(order.serialize());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderSerialize)->Arg(1)->Arg(3)->Arg(20);
+
+static void BM_OrderDeserialize(benchmark::State &state)
+{
+    std::string line = BenchData::order(42, static_cast<int>(state.range(0))).serialize();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Order::deserialize(line));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(line.size()));
+}
+BENCHMARK(BM_OrderDeserialize)->Arg(1)->Arg(3)->Arg(20);
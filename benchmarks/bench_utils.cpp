@@ -0,0 +1,37 @@
+#include "BenchData.h"
+#include "utils/Utils.h"
+#include <benchmark/benchmark.h>
+
+static void BM_Split(benchmark::State &state)
+{
+    std::string line = BenchData::order(42, static_cast<int>(state.range(0))).serialize();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Utils::split(line, '|'));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(line.size()));
+}
+BENCHMARK(BM_Split)->Arg(1)->Arg(20);
+
+static void BM_ToLower(benchmark::State &state)
+{
+    std::string text(static_cast<size_t>(state.range(0)), 'A');
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Utils::toLower(text));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ToLower)->Arg(16)->Arg(256);
+
+static void BM_IsValidEmail(benchmark::State &state)
+{
+    // range(0) picks a well-formed address or one the pattern rejects
+    std::string email = state.range(0) ? "jane.smith+orders@example.com" : "jane.smith@@example";
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Utils::isValidEmail(email));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsValidEmail)->ArgName("valid")->Arg(1)->Arg(0);
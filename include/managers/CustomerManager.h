@@ -1,17 +1,46 @@
 #pragma once
 #include "models/Customer.h"
+#include "utils/Batch.h"
+#include "utils/Csv.h"
+#include "utils/Export.h"
+#include "utils/Memory.h"
+#include "utils/Query.h"
+#include "utils/Scan.h"
 #include <vector>
 #include <memory>
+#include <shared_mutex>
+#include <unordered_map>
 
+// Thread-safe: reads (lookups, searches, statistics) share dataMutex, writes take it
+// exclusively. Pointers returned by getCustomer are not protected by the lock; use
+// getCustomerCopy when another thread may be writing. Customers are kept in
+// ascending id order, which getCustomersPage relies on.
 class CustomerManager
 {
 private:
     std::vector<Customer> customers;
+    std::unordered_map<std::string, int> emailIndex; // lower-case email -> customer id
+    std::unordered_map<std::string, int> phoneIndex; // phone -> customer id
+    QueryEngine<Customer> queryEngine;
     int nextCustomerId;
+    mutable std::shared_mutex dataMutex;
 
     void loadCustomers();
     void saveCustomers();
     int generateNextId();
+    void setUpQueries();
+    // Adds the valid rows of batch without saving
+    BatchResult insertCustomers(const std::vector<Customer> &batch);
+
+    // Helpers below expect dataMutex to be held by the caller
+    void rebuildIndexLocked();
+    void indexCustomerLocked(const Customer &customer);
+    void unindexCustomerLocked(const Customer &customer);
+    Customer *findCustomerLocked(int customerId);
+    bool isEmailUniqueLocked(const std::string &email, int excludeCustomerId) const;
+    bool isPhoneUniqueLocked(const std::string &phone, int excludeCustomerId) const;
+    bool validateCustomerLocked(const Customer &customer) const;
+    int getActiveCustomersCountLocked() const;
 
 public:
     CustomerManager();
@@ -19,8 +48,20 @@ public:
 
     // CRUD operations
     bool addCustomer(const Customer &customer);
+    // As above, and sets customerId to the new customer's id
+    bool addCustomer(const Customer &customer, int &customerId);
+    // Validates every row, adds the valid ones and saves once; see BatchResult
+    BatchResult addCustomers(const std::vector<Customer> &batch);
     Customer *getCustomer(int customerId);
+    bool getCustomerCopy(int customerId, Customer &customer);
+    // Visits the customers passing filter (all if empty), at most limit of them, without
+    // copying; see Scan::run. The shared lock is held throughout, so the visitor must not
+    // call back into this manager. Returns the number visited.
+    size_t forEach(const Scan::Visitor<Customer> &visitor, const Scan::Filter<Customer> &filter = nullptr,
+                   size_t limit = Scan::NO_LIMIT) const;
     std::vector<Customer> getAllCustomers();
+    // Up to pageSize customers after id afterId (0 for the first page), in id order
+    Page<Customer> getCustomersPage(int afterId, size_t pageSize);
     std::vector<Customer> getActiveCustomers();
     bool updateCustomer(const Customer &customer);
     bool deleteCustomer(int customerId);
@@ -33,6 +74,9 @@ public:
     std::vector<Customer> searchByPhone(const std::string &phone);
     std::vector<Customer> getCustomersByCity(const std::string &city);
     std::vector<Customer> getCustomersByCountry(const std::string &country);
+    // Fields: id, name, email, phone, address, city, country, active (1 or 0)
+    std::vector<Customer> query(const Query &query);
+    std::string explain(const Query &query) const;
 
     // Validation
     bool isEmailUnique(const std::string &email, int excludeCustomerId = -1);
@@ -41,6 +85,8 @@ public:
 
     // Statistics
     int getTotalCustomers();
+    // Memory held by the records and their indexes; see MemoryUsage
+    MemoryUsage getMemoryUsage();
     int getActiveCustomersCount();
     int getInactiveCustomersCount();
     std::vector<std::string> getTopCities(int limit = 5);
@@ -49,6 +95,14 @@ public:
     // Utility
     void printCustomer(const Customer &customer);
     void printAllCustomers();
+    // Columns: id, name, email, phone, address, city, country, active. exportToFile
+    // writes the customers matching query (all of them by default); the shared lock
+    // is held until the file is written.
     bool exportToCSV(const std::string &filename);
+    Export::Report exportToFile(const std::string &filename, const Export::Options &options,
+                                const Query &query = Query());
+    // Columns: name, email, phone, address, city, country and optionally active.
+    // Streams the file through addCustomers; see Csv::import.
     bool importFromCSV(const std::string &filename);
+    Csv::ImportReport importFromCSV(const std::string &filename, const Csv::ImportOptions &options);
 };
\ No newline at end of file
@@ -2,24 +2,71 @@
 #include "models/Order.h"
 #include "models/Customer.h"
 #include "models/Product.h"
+#include "utils/Batch.h"
+#include "utils/Csv.h"
+#include "utils/Export.h"
+#include "utils/Memory.h"
+#include "utils/Query.h"
+#include "utils/Scan.h"
+#include "utils/VersionedVector.h"
 #include <vector>
 #include <memory>
 #include <map>
+#include <shared_mutex>
+#include <unordered_map>
 
 class ProductManager;
 class CustomerManager;
+enum class StockMove;
 
+using OrderSnapshot = Snapshot<Order>;
+
+// Thread-safe: reads (lookups, searches, statistics) share dataMutex, writes take it
+// exclusively. Lock order is OrderManager before ProductManager/CustomerManager.
+// Changes that also move stock run in a Transaction, so orders.txt and products.txt
+// are committed together; callers can wrap several calls in their own Transaction.
+// Pointers returned by getOrder are for reading and are not protected by the lock;
+// use getOrderCopy when another thread may be writing. Scans and reports read a
+// snapshot instead of holding the lock, so they never hold up order entry. Orders
+// are kept in ascending id order, which getOrdersPage relies on.
 class OrderManager
 {
 private:
-    std::vector<Order> orders;
+    VersionedVector<Order> orders;
+    std::unordered_map<int, size_t> orderIndex;                 // order id -> position in orders
+    std::unordered_map<int, std::vector<size_t>> customerIndex; // customer id -> positions
+    QueryEngine<Order> queryEngine;
     int nextOrderId;
     ProductManager *productManager;
     CustomerManager *customerManager;
+    mutable std::shared_mutex dataMutex;
 
     void loadOrders();
     void saveOrders();
     int generateNextId();
+    void setUpQueries();
+    // Adds the valid rows of batch without saving
+    BatchResult insertOrders(const std::vector<Order> &batch);
+
+    // Inside a transaction, registers restoring the order to before (or removing
+    // it, if before is null) to run if the transaction aborts
+    void undoOrderOnAbort(int orderId, const Order *before);
+
+    // Helpers below expect dataMutex to be held by the caller
+    void rebuildIndexLocked();
+    int indexOfOrderLocked(int orderId) const;
+    const Order *findOrderLocked(int orderId) const;
+    Order *mutableOrderLocked(int orderId);
+    bool updateOrderStatusLocked(int orderId, OrderStatus newStatus);
+    int itemQuantityLocked(const Order &order, int productId) const;
+    bool holdsReservationLocked(const Order &order) const;
+    // The ledger movement a status change needs; false if it needs none
+    bool stockMoveForTransitionLocked(const Order &order, OrderStatus newStatus, StockMove &move) const;
+    bool applyStockForTransitionLocked(const Order &order, OrderStatus newStatus);
+    // Changes the status and records it, without moving stock or saving
+    bool setStatusLocked(Order &order, OrderStatus newStatus);
+    void reconcileReservations();
+    static std::vector<std::pair<int, int>> stockItemsOf(const Order &order);
 
 public:
     OrderManager(ProductManager *prodMgr = nullptr, CustomerManager *custMgr = nullptr);
@@ -31,13 +78,33 @@ public:
 
     // CRUD operations
     bool createOrder(int customerId);
+    // As above, and sets orderId to the new order's id
+    bool createOrder(int customerId, int &orderId);
+    // Adds pending orders, taking each customer's name and (unless the order has one)
+    // address, and each item's name and price, from the other managers. Ids are
+    // assigned here; see BatchResult.
+    BatchResult addOrders(const std::vector<Order> &batch);
     Order *getOrder(int orderId);
+    bool getOrderCopy(int orderId, Order &order);
+    // Immutable view of every order, taken in O(1). Prefer it to getAllOrders,
+    // which copies each order.
+    OrderSnapshot getSnapshot() const;
+    // Visits the orders passing filter (all if empty), at most limit of them, without
+    // copying; see Scan::run. Runs over a snapshot with no lock held, so the visitor
+    // may call back into this manager. Returns the number visited.
+    size_t forEach(const Scan::Visitor<Order> &visitor, const Scan::Filter<Order> &filter = nullptr,
+                   size_t limit = Scan::NO_LIMIT) const;
     std::vector<Order> getAllOrders();
+    // Up to pageSize orders after id afterId (0 for the first page), in id order
+    Page<Order> getOrdersPage(int afterId, size_t pageSize);
     bool updateOrder(const Order &order);
     bool deleteOrder(int orderId);
 
     // Order item management
     bool addItemToOrder(int orderId, int productId, int quantity);
+    // Batch variants validate every row, apply the valid ones and save once, in one
+    // Transaction with the stock they move; see BatchResult
+    BatchResult addItemsToOrder(int orderId, const std::vector<std::pair<int, int>> &items); // product id, quantity
     bool removeItemFromOrder(int orderId, int productId);
     bool updateOrderItemQuantity(int orderId, int productId, int newQuantity);
 
@@ -48,12 +115,17 @@ public:
     bool shipOrder(int orderId);
     bool deliverOrder(int orderId);
     bool cancelOrder(int orderId);
+    BatchResult updateOrderStatuses(const std::vector<int> &orderIds, OrderStatus newStatus);
 
     // Search and filter operations
     std::vector<Order> getOrdersByCustomer(int customerId);
     std::vector<Order> getOrdersByStatus(OrderStatus status);
     std::vector<Order> getOrdersByDateRange(const std::string &startDate, const std::string &endDate);
-    std::vector<Order> searchOrders(const std::string &searchTerm);
+    std::vector<Order> searchOrders(const std::string &searchTerm); // customer name, address or notes
+    // Fields: id, customer, customerName, status (e.g. "Confirmed"), date, address,
+    // notes, items, total, discount, final. id and customer are indexed.
+    std::vector<Order> query(const Query &query);
+    std::string explain(const Query &query) const;
 
     // Financial operations
     bool applyDiscount(int orderId, double discountPercent);
@@ -69,6 +141,8 @@ public:
 
     // Statistics and reports
     int getTotalOrders();
+    // Memory held by the records and their indexes; see MemoryUsage
+    MemoryUsage getMemoryUsage();
     int getOrdersByStatusCount(OrderStatus status);
     std::map<OrderStatus, int> getOrderStatusDistribution();
     std::vector<std::pair<int, int>> getTopCustomers(int limit = 10); // customerId, orderCount
@@ -88,6 +162,15 @@ public:
     void printOrderSummary(const Order &order);
     void printAllOrders();
     void printOrdersByStatus(OrderStatus status);
+    // Columns: id, customer, customerName, status, date, address, notes, items
+    // ("productId:quantity;..."), total, discount, final. exportToFile writes the orders
+    // matching query (all of them by default; its sort and page apply too) from one
+    // snapshot, so no lock is held while the file is written.
     bool exportToCSV(const std::string &filename);
+    Export::Report exportToFile(const std::string &filename, const Export::Options &options,
+                                const Query &query = Query());
+    // One order per row. Columns: customer (id), items ("productId:quantity;..."), and
+    // optionally address and notes. Streams the file through addOrders; see Csv::import.
     bool importFromCSV(const std::string &filename);
+    Csv::ImportReport importFromCSV(const std::string &filename, const Csv::ImportOptions &options);
 };
\ No newline at end of file
@@ -1,17 +1,95 @@
 #pragma once
 #include "models/Product.h"
+#include "utils/Batch.h"
+#include "utils/Csv.h"
+#include "utils/Export.h"
+#include "utils/Memory.h"
+#include "utils/Query.h"
+#include "utils/Scan.h"
+#include "utils/VersionedVector.h"
 #include <vector>
 #include <memory>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <map>
+#include <utility>
 
+using ProductSnapshot = Snapshot<Product>;
+
+// Reservation ledger movements, for ProductManager::moveStockEach
+enum class StockMove
+{
+    RESERVE,
+    COMMIT,
+    RELEASE
+};
+
+// Thread-safe: reads (lookups, searches, statistics) share dataMutex, writes take it
+// exclusively. Stock changes only need the shared lock: each product's stock is an
+// atomic counter, so order entry on different (or the same) products runs in parallel.
+// Pointers returned by getProduct are for reading and are not protected by the lock;
+// use getProductCopy when another thread may be writing. Products are stored
+// copy-on-write, so a report can hold a snapshot without holding up stock updates.
+// Lookups and snapshots take the shared lock; only writers copy records. Products are kept
+// in ascending id order, which getProductsPage relies on.
 class ProductManager
 {
 private:
-    std::vector<Product> products;
+    VersionedVector<Product> products;
+    std::unordered_map<int, size_t> productIndex; // product id -> position in products
+    std::unordered_map<std::string, std::vector<size_t>> categoryIndex; // lower-case category -> positions
+    std::unordered_map<std::string, int> nameIndex;                      // lower-case name -> product id
+    QueryEngine<Product> queryEngine;
     int nextProductId;
+    bool legacyReservations; // products.txt predates the reserved-quantity field
+    mutable std::shared_mutex dataMutex;
+
+    // Serializes writes of products.txt. Stock updates racing a save only flag
+    // savePending; the thread already saving writes the file again for them.
+    std::mutex saveMutex;
+    std::atomic<bool> savePending;
 
     void loadProducts();
     void saveProducts();
     int generateNextId();
+    void setUpQueries();
+    // Adds the valid rows of batch without saving
+    BatchResult insertProducts(const std::vector<Product> &batch);
+
+    // Inside a transaction, registers the inverse of a stock movement of
+    // quantity * sign per item (on-hand, reserved) to run if it aborts
+    void undoStockOnAbort(const std::vector<std::pair<int, int>> &items, int onHandSign, int reservedSign);
+    // Records a stock change in the event log (and, with audit, the log file) once
+    // the transaction making it commits
+    static void recordStockUpdate(int productId, int oldStock, int newStock, bool audit = false);
+
+    // Shared lock under which the items' products can have their stock changed in
+    // place, i.e. no snapshot can see them. Snapshots wait while write is held, so
+    // callers end it once the stock has changed, before saving.
+    struct StockLock
+    {
+        std::shared_lock<std::shared_mutex> lock;
+        InPlaceWrite<Product> write;
+    };
+    StockLock lockForStockUpdate(const std::vector<std::pair<int, int>> &items);
+    // Ledger movements for one set of items, all or nothing, under lockForStockUpdate
+    bool reserveItemsLocked(const std::vector<std::pair<int, int>> &items);
+    bool commitItemsLocked(const std::vector<std::pair<int, int>> &items, std::vector<int> &previousStock);
+    // Returns the items with the quantities actually released, which may be less
+    std::vector<std::pair<int, int>> releaseItemsLocked(const std::vector<std::pair<int, int>> &items);
+
+    // Helpers below expect dataMutex to be held by the caller
+    void rebuildIndexLocked();
+    std::vector<std::string> serializeLocked() const;
+    int indexOfProductLocked(int productId) const;
+    const Product *findProductLocked(int productId) const;
+    Product *mutableProductLocked(int productId); // exclusive lock only
+    Product *stockProductLocked(int productId);   // under lockForStockUpdate only
+    bool isProductNameUniqueLocked(const std::string &name, int excludeProductId) const;
+    bool validateProductLocked(const Product &product) const;
+    int getActiveProductsCountLocked() const;
 
 public:
     ProductManager();
@@ -19,27 +97,62 @@ public:
 
     // CRUD operations
     bool addProduct(const Product &product);
+    // As above, and sets productId to the new product's id
+    bool addProduct(const Product &product, int &productId);
     Product *getProduct(int productId);
+    bool getProductCopy(int productId, Product &product);
+    // Immutable view of every product, taken in O(1)
+    ProductSnapshot getSnapshot() const;
+    // Visits the products passing filter (all if empty), at most limit of them, without
+    // copying; see Scan::run. Runs over a snapshot with no lock held, so the visitor
+    // may call back into this manager. Returns the number visited.
+    size_t forEach(const Scan::Visitor<Product> &visitor, const Scan::Filter<Product> &filter = nullptr,
+                   size_t limit = Scan::NO_LIMIT) const;
     std::vector<Product> getAllProducts();
+    // Up to pageSize products after id afterId (0 for the first page), in id order
+    Page<Product> getProductsPage(int afterId, size_t pageSize);
     std::vector<Product> getActiveProducts();
     bool updateProduct(const Product &product);
     bool deleteProduct(int productId);
     bool deactivateProduct(int productId);
     bool activateProduct(int productId);
+    // Batch variants validate every row, apply the valid ones and save once; see BatchResult
+    BatchResult addProducts(const std::vector<Product> &batch);
 
     // Stock management
     bool updateStock(int productId, int newQuantity);
+    BatchResult updateStocks(const std::vector<std::pair<int, int>> &levels); // product id, new quantity
     bool addStock(int productId, int quantity);
-    bool reduceStock(int productId, int quantity);
+    bool reduceStock(int productId, int quantity); // atomic check-and-decrement of available stock
     std::vector<Product> getLowStockProducts();
     std::vector<Product> getOutOfStockProducts();
     bool isProductAvailable(int productId, int quantity = 1);
+    int getAvailableQuantity(int productId);
+
+    // Reservation ledger, driven by the order lifecycle. Items are (product id, quantity)
+    // pairs; each call applies to all items or, on failure, to none of them.
+    bool reserveStock(const std::vector<std::pair<int, int>> &items);
+    bool commitReservedStock(const std::vector<std::pair<int, int>> &items);
+    void releaseReservedStock(const std::vector<std::pair<int, int>> &items);
+    // One movement per group of items, each group all or nothing on its own, saving
+    // products.txt once. A group's row in the result is its position in groups.
+    BatchResult moveStockEach(StockMove move, const std::vector<std::vector<std::pair<int, int>>> &groups);
+    // True if the loaded file has no reserved quantities yet, so the ledger must be
+    // rebuilt from open orders once
+    bool reservationsNeedRebuild();
+    // Overwrites reserved quantities (product id -> reserved, missing ids -> 0).
+    // Returns the number of products whose ledger was corrected.
+    int reconcileReservations(const std::map<int, int> &reserved);
 
     // Search and filter operations
     std::vector<Product> searchByName(const std::string &name);
     std::vector<Product> getProductsByCategory(const std::string &category);
     std::vector<Product> getProductsByPriceRange(double minPrice, double maxPrice);
     std::vector<Product> getProductsInStock();
+    // Fields: id, name, description, category, price, stock, reserved, available,
+    // minStock, active (1 or 0). id and category are indexed.
+    std::vector<Product> query(const Query &query);
+    std::string explain(const Query &query) const;
 
     // Price management
     bool updatePrice(int productId, double newPrice);
@@ -56,6 +169,8 @@ public:
 
     // Statistics
     int getTotalProducts();
+    // Memory held by the records and their indexes; see MemoryUsage
+    MemoryUsage getMemoryUsage();
     int getActiveProductsCount();
     int getInactiveProductsCount();
     double getTotalInventoryValue();
@@ -71,6 +186,14 @@ public:
     void printProduct(const Product &product);
     void printAllProducts();
     void printProductsTable();
+    // Columns: id, name, description, category, price, stock, reserved, minStock,
+    // active. exportToFile writes the products matching query (all of them by
+    // default) from one snapshot, so no lock is held while the file is written.
     bool exportToCSV(const std::string &filename);
+    Export::Report exportToFile(const std::string &filename, const Export::Options &options,
+                                const Query &query = Query());
+    // Columns: name, category, price, stock and optionally description, minStock and
+    // active. Streams the file through addProducts; see Csv::import.
     bool importFromCSV(const std::string &filename);
+    Csv::ImportReport importFromCSV(const std::string &filename, const Csv::ImportOptions &options);
 };
\ No newline at end of file
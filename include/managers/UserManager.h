@@ -1,20 +1,34 @@
 #pragma once
 #include "models/User.h"
+#include "utils/Export.h"
+#include "utils/Memory.h"
+#include "utils/Scan.h"
 #include <vector>
 #include <memory>
+#include <shared_mutex>
 
+// Thread-safe: reads share dataMutex, writes take it exclusively. Pointers returned
+// by getUser/getUserByUsername/getCurrentUser are not protected by the lock.
 class UserManager
 {
 private:
     std::vector<User> users;
     int nextUserId;
     User *currentUser;
+    mutable std::shared_mutex dataMutex;
 
     void loadUsers();
     void saveUsers();
     int generateNextId();
     void createDefaultAdmin();
 
+    // Helpers below expect dataMutex to be held by the caller
+    User *findUserLocked(int userId);
+    bool isUsernameUniqueLocked(const std::string &username, int excludeUserId) const;
+    bool isEmailUniqueLocked(const std::string &email, int excludeUserId) const;
+    bool validateUserLocked(const User &user) const;
+    int getUserCountByRoleLocked(UserRole role) const;
+
 public:
     UserManager();
     ~UserManager();
@@ -22,13 +36,18 @@ public:
     // Authentication
     bool login(const std::string &username, const std::string &password);
     void logout();
-    bool isLoggedIn() const { return currentUser != nullptr; }
-    User *getCurrentUser() const { return currentUser; }
+    bool isLoggedIn() const;
+    User *getCurrentUser() const;
 
     // CRUD operations
     bool addUser(const User &user);
     User *getUser(int userId);
     User *getUserByUsername(const std::string &username);
+    // Visits the users passing filter (all if empty), at most limit of them, without
+    // copying; see Scan::run. The shared lock is held throughout, so the visitor must not
+    // call back into this manager. Returns the number visited.
+    size_t forEach(const Scan::Visitor<User> &visitor, const Scan::Filter<User> &filter = nullptr,
+                   size_t limit = Scan::NO_LIMIT) const;
     std::vector<User> getAllUsers();
     std::vector<User> getActiveUsers();
     bool updateUser(const User &user);
@@ -64,6 +83,8 @@ public:
 
     // Statistics
     int getTotalUsers();
+    // Memory held by the records and their indexes; see MemoryUsage
+    MemoryUsage getMemoryUsage();
     int getActiveUsersCount();
     int getUserCountByRole(UserRole role);
     std::vector<User> getRecentlyActiveUsers(int days = 30);
@@ -77,6 +98,9 @@ public:
     void printUser(const User &user);
     void printAllUsers();
     void printUsersByRole(UserRole role);
+    // Columns: id, username, fullName, email, role, active, lastLogin; passwords are
+    // never exported. The shared lock is held until the file is written.
     bool exportToCSV(const std::string &filename);
+    Export::Report exportToFile(const std::string &filename, const Export::Options &options);
     bool importFromCSV(const std::string &filename);
 };
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <string>
 #include <vector>
 
+struct MemoryUsage;
+
 class Customer
 {
 private:
@@ -47,5 +49,8 @@ public:
 
     // Serialization
     std::string serialize() const;
+
+    // Adds the heap buffers of this record's strings and vectors
+    void addHeapUsage(MemoryUsage &usage) const;
     static Customer deserialize(const std::string &data);
 };
\ No newline at end of file
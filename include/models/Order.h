@@ -4,6 +4,8 @@
 #include <chrono>
 #include <map>
 
+struct MemoryUsage;
+
 enum class OrderStatus
 {
     PENDING,
@@ -42,6 +44,12 @@ private:
     double finalAmount;
     std::string notes;
 
+    // Skips stamping the current time for orders that are about to be deserialized
+    struct DeserializeTag
+    {
+    };
+    explicit Order(DeserializeTag);
+
 public:
     // Constructors
     Order();
@@ -65,6 +73,7 @@ public:
     void setCustomerId(int id) { customerId = id; }
     void setCustomerName(const std::string &name) { customerName = name; }
     void setStatus(OrderStatus newStatus) { status = newStatus; }
+    void setOrderDate(const std::string &date) { orderDate = date; }
     void setShippingAddress(const std::string &address) { shippingAddress = address; }
     void setDiscountAmount(double discount)
     {
@@ -99,5 +108,8 @@ public:
 
     // Serialization
     std::string serialize() const;
+
+    // Adds the heap buffers of this record's strings and vectors
+    void addHeapUsage(MemoryUsage &usage) const;
     static Order deserialize(const std::string &data);
 };
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 #include <string>
+#include <atomic>
+#include <cstdint>
+
+struct MemoryUsage;
 
 class Product
 {
@@ -9,15 +13,28 @@ private:
     std::string description;
     std::string category;
     double price;
-    int stockQuantity;
+    // On-hand quantity in the high 32 bits, reserved quantity in the low 32 bits.
+    // Kept in one word so reservations and stock changes are a single atomic update.
+    std::atomic<std::uint64_t> stockState;
     int minStockLevel;
     bool isActive;
 
+    static std::uint64_t packStock(int onHand, int reserved);
+    static int onHandOf(std::uint64_t state) { return static_cast<int>(state >> 32); }
+    static int reservedOf(std::uint64_t state) { return static_cast<int>(state & 0xFFFFFFFFu); }
+
+    // Applies change(onHand, reserved) with a compare-and-swap loop. change returns
+    // false to leave the stock untouched.
+    template <typename Change>
+    bool updateStockState(Change change, int *previousOnHand = nullptr);
+
 public:
     // Constructors
     Product();
     Product(int id, const std::string &name, const std::string &description,
             const std::string &category, double price, int stockQuantity, int minStockLevel);
+    Product(const Product &other);
+    Product &operator=(const Product &other);
 
     // Getters
     int getProductId() const { return productId; }
@@ -25,7 +42,9 @@ public:
     const std::string &getDescription() const { return description; }
     const std::string &getCategory() const { return category; }
     double getPrice() const { return price; }
-    int getStockQuantity() const { return stockQuantity; }
+    int getStockQuantity() const { return onHandOf(stockState.load()); }
+    int getReservedQuantity() const { return reservedOf(stockState.load()); }
+    int getAvailableQuantity() const;
     int getMinStockLevel() const { return minStockLevel; }
     bool getIsActive() const { return isActive; }
 
@@ -35,21 +54,41 @@ public:
     void setDescription(const std::string &description) { this->description = description; }
     void setCategory(const std::string &category) { this->category = category; }
     void setPrice(double price) { this->price = price; }
-    void setStockQuantity(int quantity) { stockQuantity = quantity; }
+    // Fails, leaving the stock unchanged, if less would be on hand than is reserved
+    bool setStockQuantity(int quantity, int *previousStock = nullptr);
     void setMinStockLevel(int level) { minStockLevel = level; }
     void setIsActive(bool active) { isActive = active; }
 
-    // Stock management
-    bool reduceStock(int quantity);
-    void addStock(int quantity);
+    // Stock management. Every change is atomic, so several threads may work on the
+    // same product at once without overselling. Available = on-hand - reserved;
+    // reduceStock and reserve only succeed if enough is available. previousStock,
+    // if given, receives the on-hand quantity just before the change.
+    bool reduceStock(int quantity, int *previousStock = nullptr);
+    void addStock(int quantity, int *previousStock = nullptr);
     bool isLowStock() const;
     bool isInStock(int quantity = 1) const;
 
+    // Reservation ledger: reserve holds stock for a confirmed order, commitReservation
+    // removes it from on-hand when the order ships, releaseReservation gives it back
+    // (no more than is reserved) and returns how much it released.
+    bool reserve(int quantity);
+    bool commitReservation(int quantity, int *previousStock = nullptr);
+    int releaseReservation(int quantity);
+    void setReservedQuantity(int quantity);
+
+    // Applies both deltas in one atomic step. Fails if reserved would go negative, if
+    // a decrease would take on-hand below zero, or if the change lowers availability
+    // below zero.
+    bool adjustStock(int onHandDelta, int reservedDelta, int *previousStock = nullptr);
+
     // Utility methods
     std::string toString() const;
     bool isValid() const;
 
     // Serialization
     std::string serialize() const;
+
+    // Adds the heap buffers of this record's strings and vectors
+    void addHeapUsage(MemoryUsage &usage) const;
     static Product deserialize(const std::string &data);
 };
\ No newline at end of file
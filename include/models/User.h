@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 
+struct MemoryUsage;
+
 enum class UserRole
 {
     ADMIN,
@@ -66,5 +68,8 @@ public:
 
     // Serialization
     std::string serialize() const;
+
+    // Adds the heap buffers of this record's strings and vectors
+    void addHeapUsage(MemoryUsage &usage) const;
     static User deserialize(const std::string &data);
 };
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+#include "managers/CustomerManager.h"
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "managers/UserManager.h"
+#include "utils/Batch.h"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Runs scripted commands without prompts, for `OrderManagement --batch FILE`. One
+// command per line, its arguments comma-separated as in a CSV record (quote a field
+// that holds a comma):
+//
+//     customer.add,Jane Doe,jane@example.com,+1-555-0100,1 Main St,Cairo,Egypt
+//     product.add,USB Cable,Accessories,9.99,500
+//     order.create,$customer
+//     order.add_item,$order,$product,2
+//     order.status,$order,Confirmed
+//
+// $customer, $product and $order stand for the id last created by the runner. Blank
+// lines and lines starting with # are skipped. A failed command is reported and
+// skipped; the rest still run. The whole run is one Transaction that defers saves,
+// so each data file is written once, at the end, instead of once per command.
+// customer.get, product.get and order.get print a record as it is stored.
+// Commands need the same permissions as the menus, for the user logged in to users.
+class BatchRunner
+{
+public:
+    // applied and failures count commands; a failure's row is its line number.
+    // saved is false if writing the data files failed; the applied changes then
+    // stay in memory, as with a failed Transaction commit.
+    struct Report
+    {
+        BatchResult result;
+        size_t commands = 0;
+        bool saved = false;
+    };
+
+    // One command's result in runAll: its output without the final line break, or
+    // the reason it failed
+    struct Outcome
+    {
+        bool ok = false;
+        std::string text;
+    };
+
+private:
+    using Args = std::vector<std::string>;
+    // Runs a command whose arguments have been counted; false with reason set on failure
+    using Handler = bool (BatchRunner::*)(const Args &args, std::ostream &out, std::string &reason);
+
+    struct Command
+    {
+        const char *name;
+        const char *usage;
+        const char *permission; // for UserManager::hasPermission; null for any user
+        size_t minArgs;
+        size_t maxArgs;
+        Handler handler;
+    };
+    static const std::vector<Command> &commands();
+
+    UserManager &users;
+    CustomerManager &customers;
+    ProductManager &products;
+    OrderManager &orders;
+    int lastCustomerId;
+    int lastProductId;
+    int lastOrderId;
+
+    // A number, or $customer, $product or $order
+    bool parseId(const std::string &text, int &id, std::string &reason) const;
+
+    bool addCustomer(const Args &args, std::ostream &out, std::string &reason);
+    bool addProduct(const Args &args, std::ostream &out, std::string &reason);
+    bool setStock(const Args &args, std::ostream &out, std::string &reason);
+    bool addStock(const Args &args, std::ostream &out, std::string &reason);
+    bool reduceStock(const Args &args, std::ostream &out, std::string &reason);
+    bool createOrder(const Args &args, std::ostream &out, std::string &reason);
+    bool addItem(const Args &args, std::ostream &out, std::string &reason);
+    bool removeItem(const Args &args, std::ostream &out, std::string &reason);
+    bool setItemQuantity(const Args &args, std::ostream &out, std::string &reason);
+    bool setStatus(const Args &args, std::ostream &out, std::string &reason);
+    bool getCustomer(const Args &args, std::ostream &out, std::string &reason);
+    bool getProduct(const Args &args, std::ostream &out, std::string &reason);
+    bool getOrder(const Args &args, std::ostream &out, std::string &reason);
+
+public:
+    BatchRunner(UserManager &users, CustomerManager &customers, ProductManager &products, OrderManager &orders);
+
+    // Runs every command in in, writing the ids of created records to out
+    Report run(std::istream &in, std::ostream &out);
+    // Runs commands as run() does, in one Transaction that defers saves, and gives
+    // each its Outcome. False if writing the data files failed; the outcomes still
+    // say which commands were applied, and their changes stay in memory.
+    bool runAll(const std::vector<std::string> &commands, std::vector<Outcome> &outcomes);
+    // Runs one command line, writing its output to out; false with reason set if it
+    // failed. Outside run() and runAll() the managers save once per change.
+    bool execute(const std::string &line, std::ostream &out, std::string &reason);
+    // One "name,ARGS" line per command
+    static std::string usage();
+
+    BatchRunner(const BatchRunner &) = delete;
+    BatchRunner &operator=(const BatchRunner &) = delete;
+};
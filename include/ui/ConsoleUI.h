@@ -14,6 +14,9 @@ private:
     std::unique_ptr<OrderManager> orderManager;
     bool isRunning;
 
+    // Rows per page in the list views
+    static constexpr size_t PAGE_SIZE = 20;
+
     // Menu methods
     void showMainMenu();
     void showLoginMenu();
@@ -78,6 +81,7 @@ private:
     void displaySuccess(const std::string &message);
     void displayError(const std::string &message);
     void displayWarning(const std::string &message);
+    bool showNextPage(bool hasMore); // asks to continue when there is another page
     void waitForInput();
     int getMenuChoice(int minChoice, int maxChoice);
     bool confirmAction(const std::string &action);
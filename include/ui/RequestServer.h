@@ -0,0 +1,128 @@
+#pragma once
+#include "ui/BatchRunner.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Serves batch commands (see BatchRunner) over a Unix domain socket, so callers get
+// answers from the loaded managers instead of starting the application per request.
+//
+// Each request and response is a frame: a 4-byte big-endian length, then that many
+// bytes. A request holds one command line; its response starts with "ok\n" and the
+// command's output, or "error\n" and the reason. A request may also hold a batch of
+// command lines separated by line breaks: they run in order as BatchRunner::runAll,
+// so their changes reach the data files in one journal commit. Its response starts
+// with "ok\n" if every command succeeded, "error\n" otherwise, then has one
+// "ok[ output]" or "error reason" line per command (blank and # lines don't count).
+// If writing the data files failed, a final "error not saved: ..." line follows;
+// the changes stay applied in memory and the next save writes them, as when a
+// single command's save fails.
+//
+// Clients may pipeline, sending many requests before reading; each connection's
+// requests run in order and are answered in order, and $order and friends refer to
+// that connection's own creates.
+//
+// One thread polls the socket and idle connections; when a connection has data it
+// is handed to one of a fixed pool of workers, which runs every complete request
+// it has buffered and writes the responses together. Commands run as the user
+// logged in to users, so the socket is created readable by its owner only.
+// Not available on Windows, where start() fails.
+class RequestServer
+{
+public:
+    static constexpr uint32_t MAX_FRAME = 1 << 20;
+
+private:
+    struct Connection
+    {
+        int fd;
+        std::string input; // received bytes not yet run as requests
+        BatchRunner runner;
+        bool open;
+
+        Connection(int fd, UserManager &users, CustomerManager &customers, ProductManager &products,
+                   OrderManager &orders)
+            : fd(fd), runner(users, customers, products, orders), open(true)
+        {
+        }
+    };
+
+    UserManager &users;
+    CustomerManager &customers;
+    ProductManager &products;
+    OrderManager &orders;
+
+    std::string socketPath;
+    int listenFd;
+    int wakeFds[2]; // self-pipe: workers and stop() wake the poll thread through it
+    std::atomic<bool> stopping;
+    std::thread pollThread;
+    std::vector<std::thread> workers;
+
+    // Owned and closed by the poll thread; idle ones are polled for data
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::vector<int> idle;
+
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<Connection *> ready;    // have data, waiting for a worker
+    std::vector<Connection *> served; // back from a worker, for the poll thread
+
+    void pollLoop();
+    void workerLoop();
+    void acceptConnections();
+    void wake();
+    // Reads what the connection has sent, runs its complete requests and writes the
+    // responses; false once the connection should be closed
+    bool serve(Connection &connection);
+    std::string handle(Connection &connection, const std::string &request);
+    std::string handleBatch(Connection &connection, const std::vector<std::string> &commands);
+    void closeAll();
+
+public:
+    RequestServer(UserManager &users, CustomerManager &customers, ProductManager &products, OrderManager &orders);
+    ~RequestServer();
+
+    // Listens on socketPath (replacing a stale socket file, but not a live server)
+    // and starts workers threads
+    bool start(const std::string &socketPath, size_t workers);
+    // Stops accepting, lets running requests finish and closes every connection
+    void stop();
+    bool isRunning() const { return pollThread.joinable(); }
+
+    RequestServer(const RequestServer &) = delete;
+    RequestServer &operator=(const RequestServer &) = delete;
+};
+
+// Blocking client for RequestServer, for tools and tests
+class RequestClient
+{
+private:
+    int fd;
+    std::string input;
+
+public:
+    RequestClient();
+    ~RequestClient();
+
+    bool connect(const std::string &socketPath);
+    // Sends one request; several may be sent before their responses are read
+    bool send(const std::string &command);
+    // Sends commands as one batch request, answered by one response
+    bool sendBatch(const std::vector<std::string> &commands);
+    // The next response, in request order; ok is false for an error response
+    bool receive(bool &ok, std::string &body);
+    // send then receive
+    bool call(const std::string &command, bool &ok, std::string &body);
+    void close();
+
+    RequestClient(const RequestClient &) = delete;
+    RequestClient &operator=(const RequestClient &) = delete;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Outcome of a batch call on a manager. Rows are validated and applied one by one:
+// a bad row is skipped and reported here, the rest still go in, and the data file
+// is saved once for the whole batch.
+struct BatchResult
+{
+    struct Failure
+    {
+        size_t row; // position in the batch
+        std::string reason;
+    };
+
+    size_t applied = 0;
+    std::vector<Failure> failures;
+
+    bool ok() const { return failures.empty(); }
+    void fail(size_t row, const std::string &reason) { failures.push_back({row, reason}); }
+};
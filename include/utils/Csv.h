@@ -0,0 +1,263 @@
+#pragma once
+#include "utils/Batch.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// RFC 4180 CSV: comma-separated fields, optionally in double quotes; a quoted field
+// may hold commas and line breaks, and "" stands for one quote. Records end with
+// LF or CRLF. The first record names the columns.
+namespace Csv
+{
+    // Splits one record (without its line break) into fields
+    std::vector<std::string> parseRecord(std::string_view record);
+    // Appends field to out, in quotes if it holds a comma, quote or line break
+    void appendField(std::string &out, std::string_view field);
+    // False unless text is a whole number that fits in an int
+    bool parseInt(const std::string &text, int &value);
+
+    // Column positions by name, taken from the header record; names are
+    // matched case-insensitively
+    class Header
+    {
+    private:
+        std::unordered_map<std::string, size_t> columns;
+
+    public:
+        explicit Header(const std::vector<std::string> &names);
+        // Position of column, or -1 if the file has no such column
+        int indexOf(const std::string &column) const;
+        bool has(const std::string &column) const { return indexOf(column) >= 0; }
+    };
+
+    // One data record, with its fields looked up by column name
+    class Row
+    {
+    private:
+        const Header &header;
+        std::vector<std::string> fields;
+
+    public:
+        Row(const Header &header, std::vector<std::string> fields) : header(header), fields(std::move(fields)) {}
+
+        // The trimmed field, or "" if the column is missing or the record is short
+        std::string get(const std::string &column) const;
+        bool isEmpty(const std::string &column) const { return get(column).empty(); }
+        // False if the field is missing or not a whole number
+        bool getInt(const std::string &column, int &value) const;
+        bool getDouble(const std::string &column, double &value) const;
+        // 1/0, true/false or yes/no; a missing or empty field leaves value alone
+        bool getBool(const std::string &column, bool &value) const;
+    };
+
+    // A run of complete records from the input
+    struct Block
+    {
+        std::string text;
+        std::vector<size_t> ends; // end of each record in text, at its line break
+        size_t firstRecord = 1;   // number of the first record in the file; the header is 1
+    };
+
+    // Reads complete records from a stream in large chunks, so a file is never held
+    // in memory whole. A chunk is cut after its last line break outside quotes and
+    // the partial record after it carries over into the next block.
+    class ChunkReader
+    {
+    private:
+        std::istream &in;
+        size_t chunkSize;
+        std::string carry;
+        size_t scanned;   // bytes of carry already checked for line breaks
+        bool inQuotes;    // quote state at the end of the scanned part
+        size_t nextRecord;
+        size_t bytesRead;
+
+    public:
+        ChunkReader(std::istream &in, size_t chunkSize);
+
+        // Next block of records; false once the input is exhausted
+        bool next(Block &block);
+        size_t getBytesRead() const { return bytesRead; }
+    };
+
+    struct ImportOptions
+    {
+        size_t chunkSize = 4 << 20;      // bytes read per block
+        unsigned threads = 0;            // blocks parsed at once; 0 for one per core
+        size_t maxRejectedDetails = 1000; // rejected rows kept with their reason
+    };
+
+    struct ImportReport
+    {
+        bool ok = false; // the file was read and has the required columns
+        std::string error;
+        size_t rows = 0; // data records read
+        size_t imported = 0;
+        size_t rejectedCount = 0;
+        // The first maxRejectedDetails rejected rows; row is the record number in
+        // the file, counting the header as 1
+        std::vector<BatchResult::Failure> rejected;
+        size_t bytes = 0;
+        double seconds = 0.0;
+
+        // e.g. "Imported 998 of 1000 rows (2 rejected) in 0.50 s: 2000 rows/s, 1.2 MB/s"
+        std::string summary() const;
+    };
+
+    // Turns one row into a record; returns false with a reason to reject it.
+    // Called on worker threads, so it must not touch shared state.
+    template <typename T>
+    using RowParser = std::function<bool(const Row &row, T &record, std::string &error)>;
+
+    // Applies one block's records in file order, e.g. a manager's batch insert
+    template <typename T>
+    using BatchApply = std::function<BatchResult(const std::vector<T> &records)>;
+
+    namespace detail
+    {
+        template <typename T>
+        struct ParsedBlock
+        {
+            std::vector<T> records;
+            std::vector<size_t> recordNumbers;
+            std::vector<BatchResult::Failure> rejected;
+        };
+
+        template <typename T>
+        ParsedBlock<T> parseBlock(const Block &block, size_t skip, const Header &header, const RowParser<T> &parse)
+        {
+            ParsedBlock<T> parsed;
+            parsed.records.reserve(block.ends.size());
+            size_t start = 0;
+            for (size_t i = 0; i < block.ends.size(); ++i)
+            {
+                std::string_view text(block.text.data() + start, block.ends[i] - start);
+                start = block.ends[i] + 1;
+                if (i < skip || text.empty() || text == "\r")
+                {
+                    continue;
+                }
+
+                size_t number = block.firstRecord + i;
+                T record;
+                std::string error;
+                if (parse(Row(header, parseRecord(text)), record, error))
+                {
+                    parsed.records.push_back(std::move(record));
+                    parsed.recordNumbers.push_back(number);
+                }
+                else
+                {
+                    parsed.rejected.push_back({number, error});
+                }
+            }
+            return parsed;
+        }
+
+        void reject(ImportReport &report, const BatchResult::Failure &failure, const ImportOptions &options);
+    }
+
+    // Streams filename through parse and apply. Blocks are parsed on up to
+    // options.threads threads while earlier ones are applied, in file order, on the
+    // calling thread; at most that many blocks are in memory at once.
+    template <typename T>
+    ImportReport import(const std::string &filename, const std::vector<std::string> &requiredColumns,
+                        const RowParser<T> &parse, const BatchApply<T> &apply, const ImportOptions &options = {})
+    {
+        ImportReport report;
+        auto started = std::chrono::steady_clock::now();
+
+        std::ifstream in(filename, std::ios::binary);
+        if (!in)
+        {
+            report.error = "cannot open " + filename;
+            return report;
+        }
+
+        ChunkReader reader(in, options.chunkSize);
+        Block block;
+        if (!reader.next(block) || block.ends.empty())
+        {
+            report.error = "no header row";
+            return report;
+        }
+
+        std::string_view headerText(block.text.data(), block.ends[0]);
+        if (headerText.substr(0, 3) == "\xEF\xBB\xBF")
+        {
+            headerText.remove_prefix(3); // UTF-8 byte order mark, as spreadsheet exports write
+        }
+        Header header(parseRecord(headerText));
+        for (const auto &column : requiredColumns)
+        {
+            if (!header.has(column))
+            {
+                report.error = "missing column '" + column + "'";
+                return report;
+            }
+        }
+
+        unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        std::deque<std::future<detail::ParsedBlock<T>>> inFlight;
+        auto applyOldest = [&]()
+        {
+            detail::ParsedBlock<T> parsed = inFlight.front().get();
+            inFlight.pop_front();
+
+            report.rows += parsed.records.size() + parsed.rejected.size();
+            std::vector<BatchResult::Failure> rejected = std::move(parsed.rejected);
+            if (!parsed.records.empty())
+            {
+                BatchResult result = apply(parsed.records);
+                report.imported += result.applied;
+                for (const auto &failure : result.failures)
+                {
+                    rejected.push_back({parsed.recordNumbers[failure.row], failure.reason});
+                }
+            }
+
+            // Parse and apply failures interleave; report them in file order
+            std::sort(rejected.begin(), rejected.end(),
+                      [](const BatchResult::Failure &a, const BatchResult::Failure &b)
+                      { return a.row < b.row; });
+            for (const auto &failure : rejected)
+            {
+                detail::reject(report, failure, options);
+            }
+        };
+
+        size_t skip = 1; // the header
+        do
+        {
+            if (inFlight.size() >= threads)
+            {
+                applyOldest();
+            }
+            inFlight.push_back(std::async(std::launch::async,
+                                          [&header, &parse, skip](Block block)
+                                          { return detail::parseBlock(block, skip, header, parse); },
+                                          std::move(block)));
+            skip = 0;
+            block = Block();
+        } while (reader.next(block));
+
+        while (!inFlight.empty())
+        {
+            applyOldest();
+        }
+
+        report.ok = true;
+        report.bytes = reader.getBytesRead();
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return report;
+    }
+}
@@ -3,26 +3,55 @@
 #include <vector>
 #include <fstream>
 #include <memory>
+#include <mutex>
+#include <map>
+#include <atomic>
+#include <cstdint>
 
 class Database
 {
 private:
     static std::unique_ptr<Database> instance;
+    static std::once_flag instanceFlag;
     std::string dataDirectory;
 
+    // Held while a data file or the journal is written, so a journal commit is
+    // never interleaved with another thread's save
+    std::mutex fileMutex;
+
+    // Save order: the last sequence number handed out, and per file the number of
+    // the copy last written (guarded by fileMutex)
+    std::atomic<std::uint64_t> saveSequence;
+    std::map<std::string, std::uint64_t> writtenSequence;
+
     Database();
     bool fileExists(const std::string &filename) const;
     bool createDirectories() const;
+    bool writeFileLocked(const std::string &filename, const std::vector<std::string> &data);
+    // Writes the copy numbered sequence unless a later copy of the file was written
+    // already; returns true either way if nothing failed
+    bool writeInOrderLocked(const std::string &filename, const std::vector<std::string> &data,
+                            std::uint64_t sequence);
+    std::string journalPath() const { return dataDirectory + "journal.txt"; }
 
 public:
     static Database &getInstance();
 
-    // Configuration
+    // Configuration. Fails if the directory cannot be created or a journal left
+    // there cannot be recovered, so the data files must not be loaded.
     bool initialize(const std::string &dataDir = "data/");
+    // Points at dataDir without creating it or recovering a journal there
+    void setDataDirectory(const std::string &dataDir);
     const std::string &getDataDirectory() const { return dataDirectory; }
 
-    // File operations
-    bool saveToFile(const std::string &filename, const std::vector<std::string> &data);
+    // File operations. Every copy saved gets a sequence number, and a copy is only
+    // written if no later copy of the same file has been, so a slow save or commit
+    // never replaces a file with older contents. saveToFile numbers the copy when it
+    // is called; a caller whose data can change while it serializes passes a number
+    // from nextSaveSequence taken before it started.
+    bool saveToFile(const std::string &filename, const std::vector<std::string> &data,
+                    std::uint64_t sequence = 0);
+    std::uint64_t nextSaveSequence();
     std::vector<std::string> loadFromFile(const std::string &filename);
     bool appendToFile(const std::string &filename, const std::string &data);
     bool deleteFromFile(const std::string &filename, int lineNumber);
@@ -33,7 +62,7 @@ public:
     std::vector<std::string> loadUsers();
     bool saveCustomers(const std::vector<std::string> &customerData);
     std::vector<std::string> loadCustomers();
-    bool saveProducts(const std::vector<std::string> &productData);
+    bool saveProducts(const std::vector<std::string> &productData, std::uint64_t sequence = 0);
     std::vector<std::string> loadProducts();
     bool saveOrders(const std::vector<std::string> &orderData);
     std::vector<std::string> loadOrders();
@@ -42,6 +71,22 @@ public:
     int getNextId(const std::string &entityType);
     bool updateNextId(const std::string &entityType, int nextId);
 
+    // Transactions. While one is open on the calling thread, saveToFile stages the
+    // file instead of writing it. commitTransaction writes every staged file in one
+    // journal record first, so either all of them change or (after a crash and
+    // recoverJournal) none do. It returns true once that record is in place; if a
+    // file then cannot be written, it logs an error and leaves the journal for
+    // recoverJournal. Use the Transaction class rather than calling these.
+    bool beginTransaction();
+    bool commitTransaction();
+    void abortTransaction();
+    bool inTransaction() const;
+
+    // Finishes a commit that was interrupted after its journal record was written.
+    // Called by initialize(); returns false if a journal was found but unreadable
+    // (it is discarded) or could not be applied (it is kept for the next attempt).
+    bool recoverJournal();
+
     // Backup and restore
     bool createBackup(const std::string &backupDir);
     bool restoreFromBackup(const std::string &backupDir);
@@ -0,0 +1,124 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <functional>
+
+// Domain events recorded in the binary audit log. Values are part of the file
+// format: never renumber, only append.
+enum class EventType : std::uint8_t
+{
+    ORDER_CREATED = 1,
+    ORDER_STATUS_CHANGED = 2,
+    STOCK_UPDATED = 3,
+    USER_LOGIN = 4,
+    USER_LOGOUT = 5
+};
+
+// One audit event. The meaning of the integer fields depends on the type:
+//   ORDER_CREATED         entityId = order,   relatedId = customer
+//   ORDER_STATUS_CHANGED  entityId = order,   oldValue/newValue = OrderStatus
+//   STOCK_UPDATED         entityId = product, oldValue/newValue = stock quantity
+//   USER_LOGIN/LOGOUT     text = username
+struct EventRecord
+{
+    EventType type = EventType::ORDER_CREATED;
+    std::int64_t timestamp = 0; // seconds since the epoch
+    std::int32_t entityId = 0;
+    std::int32_t relatedId = 0;
+    std::int32_t oldValue = 0;
+    std::int32_t newValue = 0;
+    std::string text;
+
+    static std::string typeToString(EventType type);
+    static bool stringToType(const std::string &name, EventType &type);
+    std::string toString() const;
+};
+
+// Append-only, length-prefixed binary event log.
+//
+// File layout: the 8-byte header "OMEVLOG1", then records of
+//   u32 payload length | u8 type | i64 timestamp | i32 entityId | i32 relatedId |
+//   i32 oldValue | i32 newValue | u16 text length | text bytes
+// All integers are little-endian. Readers skip payload bytes they don't understand.
+class EventLog
+{
+private:
+    static std::unique_ptr<EventLog> instance;
+    static std::once_flag instanceFlag;
+
+    std::mutex logMutex;
+    std::ofstream logFile;
+    std::string logFilePath;
+    std::string buffer;
+    std::int64_t lastFlushTimestamp;
+
+    EventLog();
+    void flushBuffer();
+
+public:
+    static constexpr std::size_t HEADER_SIZE = 8;
+    static constexpr std::size_t FLUSH_THRESHOLD = 64 * 1024;
+    static const char *const FILE_MAGIC;
+
+    static EventLog &getInstance();
+
+    // Opens (or creates) the event log file. Until then record() is a no-op.
+    bool initialize(const std::string &filename = "logs/events.bin");
+    bool isOpen();
+    const std::string &getFilePath() const { return logFilePath; }
+
+    void record(const EventRecord &event);
+    void recordOrderCreated(int orderId, int customerId);
+    void recordOrderStatusChanged(int orderId, int oldStatus, int newStatus);
+    void recordStockUpdate(int productId, int oldStock, int newStock);
+    void recordUserLogin(const std::string &username);
+    void recordUserLogout(const std::string &username);
+
+    void flush();
+    void close();
+    ~EventLog();
+
+    static void encode(const EventRecord &event, std::string &out);
+
+    // Delete copy constructor and assignment operator
+    EventLog(const EventLog &) = delete;
+    EventLog &operator=(const EventLog &) = delete;
+};
+
+// Criteria for EventLogReader; unset fields match everything
+struct EventFilter
+{
+    bool hasType = false;
+    EventType type = EventType::ORDER_CREATED;
+    std::int32_t entityId = -1;
+    std::int64_t fromTimestamp = 0;
+    std::int64_t toTimestamp = INT64_MAX;
+
+    bool matches(const EventRecord &event) const;
+};
+
+// Streams records from an event log file in large chunks
+class EventLogReader
+{
+private:
+    std::string filename;
+    std::size_t corruptRecords;
+
+public:
+    explicit EventLogReader(const std::string &filename);
+
+    // Calls visitor for each matching record in file order. Returning false from
+    // the visitor stops the scan. Returns false if the file can't be read.
+    bool forEach(const std::function<bool(const EventRecord &)> &visitor,
+                 const EventFilter &filter = EventFilter());
+    std::vector<EventRecord> readAll(const EventFilter &filter = EventFilter());
+
+    // Number of truncated or malformed records seen by the last scan
+    std::size_t getCorruptRecordCount() const { return corruptRecords; }
+
+    static bool decode(const char *payload, std::size_t length, EventRecord &event);
+};
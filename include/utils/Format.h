@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+#include <sstream>
+
+namespace Utils
+{
+    namespace detail
+    {
+        // Copies literal text up to the next "{}" placeholder, handling "{{" and "}}" escapes.
+        // Returns true if a placeholder was found and consumed.
+        inline bool appendUntilPlaceholder(std::ostringstream &out, const std::string &format, size_t &pos)
+        {
+            while (pos < format.size())
+            {
+                char ch = format[pos];
+                if (ch == '{')
+                {
+                    if (pos + 1 < format.size() && format[pos + 1] == '{')
+                    {
+                        out << '{';
+                        pos += 2;
+                        continue;
+                    }
+                    if (pos + 1 < format.size() && format[pos + 1] == '}')
+                    {
+                        pos += 2;
+                        return true;
+                    }
+                }
+                else if (ch == '}' && pos + 1 < format.size() && format[pos + 1] == '}')
+                {
+                    out << '}';
+                    pos += 2;
+                    continue;
+                }
+                out << ch;
+                ++pos;
+            }
+            return false;
+        }
+
+        inline void formatArgs(std::ostringstream &out, const std::string &format, size_t &pos)
+        {
+            while (appendUntilPlaceholder(out, format, pos))
+            {
+                // More placeholders than arguments: keep them visible in the output
+                out << "{}";
+            }
+        }
+
+        template <typename T, typename... Rest>
+        void formatArgs(std::ostringstream &out, const std::string &format, size_t &pos,
+                        const T &value, const Rest &...rest)
+        {
+            if (appendUntilPlaceholder(out, format, pos))
+            {
+                out << value;
+            }
+            formatArgs(out, format, pos, rest...);
+        }
+    }
+
+    // fmt-style formatting: each "{}" in the format string is replaced by the next argument.
+    // Extra arguments are ignored; "{{" and "}}" produce literal braces.
+    template <typename... Args>
+    std::string format(const std::string &pattern, const Args &...args)
+    {
+        std::ostringstream out;
+        size_t pos = 0;
+        detail::formatArgs(out, pattern, pos, args...);
+        return out.str();
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Latency histogram with bounded relative error. Values (e.g. nanoseconds) go into
+// log-linear buckets: each power of two is split into 2^SUB_BITS equal sub-buckets,
+// so a percentile is within 1/2^SUB_BITS (under 1%) of a recorded value, for any
+// value from 0 to 2^64 - 1. record() is O(1) and never allocates. Not thread-safe:
+// keep one per thread and merge them for the report.
+class Histogram
+{
+public:
+    static const int SUB_BITS = 7;
+    static const std::uint64_t SUB_COUNT = std::uint64_t(1) << SUB_BITS;
+    static const size_t BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    static size_t bucketOf(std::uint64_t value);
+    // Highest value that falls in bucket
+    static std::uint64_t bucketTop(size_t bucket);
+
+private:
+    std::vector<std::uint64_t> counts;
+    std::uint64_t total;
+    std::uint64_t minValue;
+    std::uint64_t maxValue;
+    long double sum;
+
+public:
+    Histogram();
+
+    void record(std::uint64_t value);
+    // Records value count times
+    void record(std::uint64_t value, std::uint64_t count);
+    void merge(const Histogram &other);
+    void reset();
+
+    std::uint64_t getCount() const { return total; }
+    std::uint64_t getMin() const { return total ? minValue : 0; }
+    std::uint64_t getMax() const { return maxValue; }
+    double getMean() const { return total ? static_cast<double>(sum / total) : 0.0; }
+    // Smallest bucket bound at or above percent of the values, e.g. percentile(99.9);
+    // never more than getMax(). 0 when empty.
+    std::uint64_t percentile(double percent) const;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+struct LogRotationPolicy
+{
+    std::uint64_t maxFileBytes = 50ull * 1024 * 1024; // 0 disables size-based rotation
+    bool rotateDaily = true;
+    int maxRotatedFiles = 10; // 0 keeps every rotated file
+    bool compress = true;     // gzip rotated files when zlib is available
+};
+
+// Moves full log files aside and compresses/prunes them on a background thread.
+// rotate() only renames the file, so the log writer is never held up by compression.
+class LogRotator
+{
+private:
+    LogRotationPolicy policy; // guarded by workMutex: the worker reads it too
+    std::string activePath;
+
+    mutable std::mutex workMutex;
+    std::condition_variable workCondition;
+    std::deque<std::string> pendingFiles;
+    std::thread workerThread;
+    bool stopRequested;
+    bool workerBusy;
+
+    void workerLoop();
+    void processRotatedFile(const std::string &path);
+    bool compressFile(const std::string &source, const std::string &destination);
+    void enforceRetention(int maxRotatedFiles);
+    std::string nextRotatedPath(const std::string &stamp) const;
+
+public:
+    LogRotator();
+    ~LogRotator();
+
+    void setPolicy(const LogRotationPolicy &newPolicy);
+    LogRotationPolicy getPolicy() const;
+    void setActivePath(const std::string &path) { activePath = path; }
+
+    // True if a write of lineBytes would push the file past the size limit,
+    // or the record belongs to a later day than the file was opened on.
+    bool shouldRotate(std::uint64_t currentBytes, std::uint64_t lineBytes,
+                      const std::string &fileDay, const std::string &recordDay) const;
+
+    // Renames the active log file and queues it for compression. The caller must
+    // have closed the file and reopens it afterwards.
+    bool rotate(const std::string &stamp);
+
+    // Blocks until queued rotated files have been compressed and pruned
+    void waitForIdle();
+    void stop();
+
+    static bool compressionAvailable();
+};
@@ -1,7 +1,19 @@
 #pragma once
+#include "utils/Format.h"
+#include "utils/LogRotator.h"
 #include <string>
 #include <fstream>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
 
 enum class LogLevel
 {
@@ -15,23 +27,81 @@ enum class LogLevel
 class Logger
 {
 private:
+    // A queued log line. Either the message is already built, or the formatter
+    // produces it on the writer thread.
+    struct LogRecord
+    {
+        LogLevel level;
+        std::string timestamp;
+        std::string message;
+        std::function<std::string()> formatter;
+    };
+
     static std::unique_ptr<Logger> instance;
+    static std::once_flag instanceFlag;
     std::ofstream logFile;
-    LogLevel currentLogLevel;
+    std::atomic<LogLevel> currentLogLevel;
     std::string logFilePath;
 
+    // Rotation state, only touched by the writer thread once it is running
+    LogRotator rotator;
+    std::uint64_t currentFileBytes;
+    std::string currentFileDay;
+
+    // Background writer
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::condition_variable drainedCondition;
+    std::deque<LogRecord> pendingRecords;
+    std::thread writerThread;
+    std::atomic<bool> writerRunning;
+    bool stopRequested;
+    bool writerBusy;
+
     Logger();
     std::string getCurrentTimestamp() const;
     std::string logLevelToString(LogLevel level) const;
 
+    // logf arguments as the writer thread keeps them
+    template <typename T>
+    static std::decay_t<T> capture(T &&value)
+    {
+        return std::forward<T>(value);
+    }
+    static std::string capture(const char *value) { return value ? value : "(null)"; }
+    static std::string capture(char *value) { return value ? value : "(null)"; }
+
+    void enqueue(LogRecord record);
+    void writerLoop();
+    void writeRecords(std::deque<LogRecord> &records);
+    void startWriter();
+    void stopWriter();
+    bool openLogFile();
+    void rotateLogFile(const std::string &timestamp);
+
 public:
     static Logger &getInstance();
 
     // Configuration
     bool initialize(const std::string &filename = "logs/application.log",
                     LogLevel level = LogLevel::INFO);
-    void setLogLevel(LogLevel level) { currentLogLevel = level; }
-    LogLevel getLogLevel() const { return currentLogLevel; }
+    void setLogLevel(LogLevel level) { currentLogLevel.store(level, std::memory_order_relaxed); }
+    LogLevel getLogLevel() const { return currentLogLevel.load(std::memory_order_relaxed); }
+
+    // Rotation by size and by day. Rotated files are compressed and pruned in the
+    // background; set the policy before initialize().
+    void setRotationPolicy(const LogRotationPolicy &policy) { rotator.setPolicy(policy); }
+    LogRotationPolicy getRotationPolicy() const { return rotator.getPolicy(); }
+    // Blocks until background compression of rotated files has finished
+    void waitForRotation() { rotator.waitForIdle(); }
+
+    // True if a message at this level would be written. Checked by the LOG_* macros
+    // before the message expression is evaluated.
+    bool isEnabled(LogLevel level) const
+    {
+        return level >= currentLogLevel.load(std::memory_order_relaxed) &&
+               writerRunning.load(std::memory_order_relaxed);
+    }
 
     // Logging methods
     void log(LogLevel level, const std::string &message);
@@ -41,6 +111,34 @@ public:
     void error(const std::string &message);
     void critical(const std::string &message);
 
+    // Deferred formatting: arguments are copied and the "{}" placeholders are
+    // expanded on the writer thread, so nothing is formatted for disabled levels.
+    // The format and C string arguments are copied into std::strings, since the
+    // caller's buffers may be gone by the time the writer gets to the record.
+    template <typename... Args>
+    void logf(LogLevel level, const char *format, Args &&...args)
+    {
+        if (!isEnabled(level))
+        {
+            return;
+        }
+
+        LogRecord record;
+        record.level = level;
+        record.timestamp = getCurrentTimestamp();
+        record.formatter = [pattern = std::string(format ? format : ""),
+                            captured = std::make_tuple(capture(std::forward<Args>(args))...)]()
+        {
+            return std::apply([&pattern](const auto &...values)
+                              { return Utils::format(pattern, values...); },
+                              captured);
+        };
+        enqueue(std::move(record));
+    }
+
+    // Blocks until every queued record has been written to the log file
+    void flush();
+
     // Special logging for operations
     void logUserLogin(const std::string &username);
     void logUserLogout(const std::string &username);
@@ -57,9 +155,37 @@ public:
     Logger &operator=(const Logger &) = delete;
 };
 
-// Convenience macros for logging
-#define LOG_DEBUG(msg) Logger::getInstance().debug(msg)
-#define LOG_INFO(msg) Logger::getInstance().info(msg)
-#define LOG_WARNING(msg) Logger::getInstance().warning(msg)
-#define LOG_ERROR(msg) Logger::getInstance().error(msg)
-#define LOG_CRITICAL(msg) Logger::getInstance().critical(msg)
\ No newline at end of file
+// Convenience macros for logging. The level is checked first, so the message
+// expression is not evaluated when the level is disabled.
+#define LOG_AT_LEVEL(level, msg)                          \
+    do                                                    \
+    {                                                     \
+        Logger &logger_ = Logger::getInstance();          \
+        if (logger_.isEnabled(level))                     \
+        {                                                 \
+            logger_.log(level, msg);                      \
+        }                                                 \
+    } while (0)
+
+#define LOG_DEBUG(msg) LOG_AT_LEVEL(LogLevel::DEBUG, msg)
+#define LOG_INFO(msg) LOG_AT_LEVEL(LogLevel::INFO, msg)
+#define LOG_WARNING(msg) LOG_AT_LEVEL(LogLevel::WARNING, msg)
+#define LOG_ERROR(msg) LOG_AT_LEVEL(LogLevel::ERROR, msg)
+#define LOG_CRITICAL(msg) LOG_AT_LEVEL(LogLevel::CRITICAL, msg)
+
+// Format-string variants, e.g. LOG_DEBUGF("Saved {} records to {}", data.size(), filename)
+#define LOG_AT_LEVELF(level, ...)                         \
+    do                                                    \
+    {                                                     \
+        Logger &logger_ = Logger::getInstance();          \
+        if (logger_.isEnabled(level))                     \
+        {                                                 \
+            logger_.logf(level, __VA_ARGS__);             \
+        }                                                 \
+    } while (0)
+
+#define LOG_DEBUGF(...) LOG_AT_LEVELF(LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFOF(...) LOG_AT_LEVELF(LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARNINGF(...) LOG_AT_LEVELF(LogLevel::WARNING, __VA_ARGS__)
+#define LOG_ERRORF(...) LOG_AT_LEVELF(LogLevel::ERROR, __VA_ARGS__)
+#define LOG_CRITICALF(...) LOG_AT_LEVELF(LogLevel::CRITICAL, __VA_ARGS__)
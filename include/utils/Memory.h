@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Memory held by one manager's data, for capacity planning without a heap profiler.
+// Sizes are what the containers asked the allocator for (capacities, not sizes);
+// allocator headers and fragmentation come on top.
+struct MemoryUsage
+{
+    std::string component;
+    size_t objects = 0;
+    size_t recordBytes = 0; // the records themselves and the container holding them
+    size_t stringBytes = 0; // string buffers too long to be kept inside the string
+    size_t vectorBytes = 0; // arrays of vectors inside the records, e.g. order items
+    size_t indexBytes = 0;  // lookup tables, with their keys and values
+    // String and vector heap bytes per record field, in the order first seen
+    std::vector<std::pair<const char *, size_t>> fields;
+
+    size_t total() const { return recordBytes + stringBytes + vectorBytes + indexBytes; }
+
+    // For the records' addHeapUsage; field must be a string literal
+    void addString(const char *field, const std::string &value);
+    template <typename T>
+    void addVector(const char *field, const std::vector<T> &value)
+    {
+        size_t bytes = value.capacity() * sizeof(T);
+        vectorBytes += bytes;
+        addField(field, bytes);
+    }
+    void addField(const char *field, size_t bytes);
+};
+
+namespace Memory
+{
+    // Heap buffer of value, or 0 when it is short enough for the inline buffer
+    size_t stringHeapBytes(const std::string &value);
+
+    template <typename T>
+    size_t vectorHeapBytes(const std::vector<T> &value)
+    {
+        return value.capacity() * sizeof(T);
+    }
+
+    // Bucket array and nodes of a hash table: a pointer per bucket, and per element
+    // a node holding the next pointer, the element and the cached hash. Heap owned
+    // by the keys and values is not included.
+    template <typename K, typename V, typename H, typename E, typename A>
+    size_t hashTableBytes(const std::unordered_map<K, V, H, E, A> &table)
+    {
+        return table.bucket_count() * sizeof(void *) +
+               table.size() * (sizeof(void *) + sizeof(std::pair<const K, V>) + sizeof(size_t));
+    }
+}
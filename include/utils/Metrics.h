@@ -0,0 +1,146 @@
+#pragma once
+#include "utils/Histogram.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Count of events since start-up. Lock-free.
+class Counter
+{
+private:
+    std::atomic<std::uint64_t> value;
+
+public:
+    Counter() : value(0) {}
+
+    void increment(std::uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t get() const { return value.load(std::memory_order_relaxed); }
+    void reset() { value.store(0, std::memory_order_relaxed); }
+};
+
+// Latency distribution that any number of threads record into without locking.
+// It uses Histogram's buckets with atomic counts; snapshot() copies it into a
+// Histogram for percentiles.
+class LatencyHistogram
+{
+private:
+    std::unique_ptr<std::atomic<std::uint64_t>[]> counts;
+    std::atomic<std::uint64_t> total;
+    std::atomic<std::uint64_t> sum;
+    std::atomic<std::uint64_t> maxValue;
+
+public:
+    LatencyHistogram();
+
+    void record(std::uint64_t nanoseconds);
+    std::uint64_t getCount() const { return total.load(std::memory_order_relaxed); }
+    std::uint64_t getSum() const { return sum.load(std::memory_order_relaxed); }
+    // Values are rounded up to their bucket's bound, at most getMax(). Records made
+    // while this runs may or may not be included.
+    Histogram snapshot() const;
+    void reset();
+};
+
+// Process-wide registry of named counters and latency histograms. Registering takes
+// a lock; updating a metric does not. Metrics are never removed, so references stay
+// valid for the life of the process. Use the METRIC_* macros below at call sites.
+class Metrics
+{
+private:
+    static std::unique_ptr<Metrics> instance;
+    static std::once_flag instanceFlag;
+
+    std::mutex registryMutex;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> latencies;
+
+    // Periodic dump
+    std::mutex dumpMutex;
+    std::condition_variable dumpCondition;
+    std::thread dumpThread;
+    bool stopRequested;
+
+    Metrics();
+    void dumpLoop(std::string filename, std::chrono::milliseconds interval);
+
+public:
+    static Metrics &getInstance();
+
+    Counter &counter(const std::string &name);
+    // Latency of an operation, in nanoseconds
+    LatencyHistogram &latency(const std::string &name);
+
+    // Current values, sorted by name
+    std::vector<std::pair<std::string, std::uint64_t>> counterValues();
+    std::vector<std::pair<std::string, Histogram>> latencySnapshots();
+
+    // Every metric in the Prometheus text exposition format. Counters become
+    // ordermgmt_<name>_total; latencies become quantiles of the
+    // ordermgmt_operation_duration_seconds summary, labelled by operation.
+    std::string prometheusText();
+    // Writes prometheusText() to filename through a temporary file, so a scraper
+    // never reads a partial file
+    bool writePrometheus(const std::string &filename);
+
+    // Rewrites filename every interval on a background thread until stopDump()
+    bool startDump(const std::string &filename, std::chrono::milliseconds interval);
+    void stopDump();
+
+    // Zeroes every metric (registrations and references are kept)
+    void reset();
+
+    ~Metrics();
+
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+};
+
+// Records the time from construction to destruction into a latency histogram
+class ScopedTimer
+{
+private:
+    LatencyHistogram &histogram;
+    std::chrono::steady_clock::time_point started;
+
+public:
+    explicit ScopedTimer(LatencyHistogram &histogram)
+        : histogram(histogram), started(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        histogram.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()));
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+};
+
+// Call-site macros. The metric is looked up once per call site (a function-local
+// static), so the hot path is a clock read and a few relaxed atomic adds.
+#define METRIC_CONCAT_(a, b) a##b
+#define METRIC_CONCAT(a, b) METRIC_CONCAT_(a, b)
+
+// Times the rest of the enclosing scope, e.g. METRIC_TIMER("order_create");
+#define METRIC_TIMER(name)                                                                                     \
+    static LatencyHistogram &METRIC_CONCAT(metricHistogram_, __LINE__) = Metrics::getInstance().latency(name); \
+    ScopedTimer METRIC_CONCAT(metricTimer_, __LINE__)(METRIC_CONCAT(metricHistogram_, __LINE__))
+
+#define METRIC_COUNT(name, n)                                                   \
+    do                                                                          \
+    {                                                                           \
+        static Counter &metricCounter_ = Metrics::getInstance().counter(name);  \
+        metricCounter_.increment(n);                                            \
+    } while (0)
+
+#define METRIC_INCREMENT(name) METRIC_COUNT(name, 1)
@@ -0,0 +1,343 @@
+#pragma once
+#include "utils/Scan.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Literal in a predicate: a number or text
+class QueryValue : public std::variant<double, std::string>
+{
+public:
+    using std::variant<double, std::string>::variant;
+    QueryValue(int number) : std::variant<double, std::string>(static_cast<double>(number)) {}
+    QueryValue(const char *text) : std::variant<double, std::string>(std::string(text)) {}
+};
+
+// A record's field as a query sees it; text points into the record
+using FieldValue = std::variant<double, std::string_view>;
+
+namespace QueryValues
+{
+    // Numbers compare numerically and text case-insensitively; any number sorts
+    // before any text, so the two never compare equal
+    int compare(const FieldValue &a, const FieldValue &b);
+    FieldValue view(const QueryValue &value);
+    std::string toString(const QueryValue &value);
+}
+
+// Filter tree for a Query. Build leaves with the factory functions and combine
+// them with && and ||; a default-constructed Predicate matches everything.
+class Predicate
+{
+public:
+    enum class Kind
+    {
+        ALL,
+        EQ,
+        RANGE,
+        CONTAINS,
+        IN,
+        AND,
+        OR
+    };
+
+private:
+    Kind kind;
+    std::string field;
+    std::vector<QueryValue> values;
+    std::vector<Predicate> children;
+
+    static Predicate combine(Kind kind, const Predicate &left, const Predicate &right);
+
+public:
+    Predicate() : kind(Kind::ALL) {}
+
+    static Predicate eq(const std::string &field, const QueryValue &value);
+    static Predicate range(const std::string &field, const QueryValue &min, const QueryValue &max); // inclusive
+    static Predicate contains(const std::string &field, const std::string &text);
+    static Predicate in(const std::string &field, const std::vector<QueryValue> &values);
+
+    Predicate operator&&(const Predicate &other) const;
+    Predicate operator||(const Predicate &other) const;
+
+    Kind getKind() const { return kind; }
+    const std::string &getField() const { return field; }
+    const std::vector<QueryValue> &getValues() const { return values; }
+    const std::vector<Predicate> &getChildren() const { return children; }
+
+    // Tests one field value against a leaf (EQ, RANGE, CONTAINS or IN)
+    bool matches(const FieldValue &value) const;
+    // The parts of a top-level AND, or this predicate alone; ALL yields nothing
+    std::vector<Predicate> conjuncts() const;
+    std::string toString() const;
+};
+
+// What to fetch from a manager: a filter, an optional sort and a page
+class Query
+{
+private:
+    Predicate filter;
+    std::string sortField;
+    bool ascending;
+    size_t offsetCount;
+    size_t limitCount;
+
+public:
+    Query() : ascending(true), offsetCount(0), limitCount(Scan::NO_LIMIT) {}
+
+    Query &where(const Predicate &predicate); // ANDed with earlier calls
+    Query &orderBy(const std::string &field, bool ascending = true);
+    Query &offset(size_t count);
+    Query &limit(size_t count);
+
+    const Predicate &getFilter() const { return filter; }
+    const std::string &getSortField() const { return sortField; }
+    bool isAscending() const { return ascending; }
+    size_t getOffset() const { return offsetCount; }
+    size_t getLimit() const { return limitCount; }
+};
+
+// How QueryEngine runs a Query: an index lookup or a full scan for candidates,
+// then filters in order, the sort and the page
+struct QueryPlan
+{
+    std::string table;
+    bool valid = true;
+    std::string error;
+    std::string indexField; // empty for a full scan
+    std::vector<QueryValue> indexKeys;
+    std::vector<Predicate> filters;
+    std::string sortField;
+    bool ascending = true;
+    size_t offset = 0;
+    size_t limit = Scan::NO_LIMIT;
+
+    // The explain output
+    std::string toString() const;
+};
+
+// Runs queries over one manager's records. The manager registers its fields and
+// any indexes it keeps; plan() uses an index for an EQ or IN conjunct on an
+// indexed field and scans otherwise. Filters run a column at a time over a
+// vector of candidate positions, cheapest first, rather than record by record.
+template <typename T>
+class QueryEngine
+{
+public:
+    using Getter = std::function<FieldValue(const T &)>;
+    // Appends the positions of the records whose field equals key
+    using IndexLookup = std::function<void(const QueryValue &key, std::vector<size_t> &positions)>;
+
+private:
+    std::string table;
+    std::unordered_map<std::string, Getter> fields;
+    std::unordered_map<std::string, IndexLookup> indexes;
+
+    bool checkFields(const Predicate &predicate, std::string &error) const
+    {
+        if (predicate.getKind() == Predicate::Kind::AND || predicate.getKind() == Predicate::Kind::OR)
+        {
+            return std::all_of(predicate.getChildren().begin(), predicate.getChildren().end(),
+                               [this, &error](const Predicate &child)
+                               { return checkFields(child, error); });
+        }
+        if (predicate.getKind() != Predicate::Kind::ALL && !fields.count(predicate.getField()))
+        {
+            error = "unknown field '" + predicate.getField() + "'";
+            return false;
+        }
+        return true;
+    }
+
+    std::function<bool(const T &)> compile(const Predicate &predicate) const
+    {
+        switch (predicate.getKind())
+        {
+        case Predicate::Kind::ALL:
+            return [](const T &)
+            { return true; };
+        case Predicate::Kind::AND:
+        case Predicate::Kind::OR:
+        {
+            std::vector<std::function<bool(const T &)>> parts;
+            for (const auto &child : predicate.getChildren())
+            {
+                parts.push_back(compile(child));
+            }
+            bool any = predicate.getKind() == Predicate::Kind::OR;
+            return [parts, any](const T &record)
+            {
+                for (const auto &part : parts)
+                {
+                    if (part(record) == any)
+                    {
+                        return any;
+                    }
+                }
+                return !any;
+            };
+        }
+        default:
+        {
+            const Getter &getter = fields.at(predicate.getField());
+            return [&getter, predicate](const T &record)
+            { return predicate.matches(getter(record)); };
+        }
+        }
+    }
+
+    static int cost(const Predicate &predicate)
+    {
+        switch (predicate.getKind())
+        {
+        case Predicate::Kind::EQ:
+        case Predicate::Kind::RANGE:
+        case Predicate::Kind::IN:
+            return 0;
+        case Predicate::Kind::CONTAINS:
+            return 1;
+        default:
+            return 2;
+        }
+    }
+
+public:
+    explicit QueryEngine(const std::string &table) : table(table) {}
+
+    QueryEngine &field(const std::string &name, Getter getter)
+    {
+        fields[name] = std::move(getter);
+        return *this;
+    }
+
+    QueryEngine &index(const std::string &name, IndexLookup lookup)
+    {
+        indexes[name] = std::move(lookup);
+        return *this;
+    }
+
+    QueryPlan plan(const Query &query) const
+    {
+        QueryPlan plan;
+        plan.table = table;
+        plan.sortField = query.getSortField();
+        plan.ascending = query.isAscending();
+        plan.offset = query.getOffset();
+        plan.limit = query.getLimit();
+
+        if (!checkFields(query.getFilter(), plan.error))
+        {
+            plan.valid = false;
+            return plan;
+        }
+        if (!plan.sortField.empty() && !fields.count(plan.sortField))
+        {
+            plan.valid = false;
+            plan.error = "unknown sort field '" + plan.sortField + "'";
+            return plan;
+        }
+
+        plan.filters = query.getFilter().conjuncts();
+
+        // An equality lookup narrows the candidates most, so prefer EQ over IN
+        auto indexed = plan.filters.end();
+        for (auto kind : {Predicate::Kind::EQ, Predicate::Kind::IN})
+        {
+            indexed = std::find_if(plan.filters.begin(), plan.filters.end(),
+                                   [this, kind](const Predicate &p)
+                                   { return p.getKind() == kind && indexes.count(p.getField()); });
+            if (indexed != plan.filters.end())
+            {
+                break;
+            }
+        }
+        if (indexed != plan.filters.end())
+        {
+            plan.indexField = indexed->getField();
+            plan.indexKeys = indexed->getValues();
+            plan.filters.erase(indexed);
+        }
+
+        std::stable_sort(plan.filters.begin(), plan.filters.end(),
+                         [](const Predicate &a, const Predicate &b)
+                         { return cost(a) < cost(b); });
+        return plan;
+    }
+
+    // Positions the plan has to look at, in ascending order. Call it under the
+    // lock that guards the indexes, against the records it will execute on.
+    std::vector<size_t> candidates(const QueryPlan &plan, size_t recordCount) const
+    {
+        std::vector<size_t> positions;
+        if (plan.indexField.empty())
+        {
+            positions.resize(recordCount);
+            std::iota(positions.begin(), positions.end(), 0);
+            return positions;
+        }
+
+        const IndexLookup &lookup = indexes.at(plan.indexField);
+        for (const auto &key : plan.indexKeys)
+        {
+            lookup(key, positions);
+        }
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+        return positions;
+    }
+
+    // Filters, sorts and pages the candidates, returning the positions of the page
+    // in result order. records must be indexable by position (a vector or a Snapshot).
+    template <typename Records>
+    std::vector<size_t> select(const QueryPlan &plan, const Records &records, std::vector<size_t> positions) const
+    {
+        TRACE_SPAN("query.select");
+        for (const auto &filter : plan.filters)
+        {
+            std::function<bool(const T &)> test = compile(filter);
+            positions.erase(std::remove_if(positions.begin(), positions.end(),
+                                           [&test, &records](size_t position)
+                                           { return !test(records[position]); }),
+                            positions.end());
+        }
+
+        if (!plan.sortField.empty())
+        {
+            const Getter &getter = fields.at(plan.sortField);
+            bool ascending = plan.ascending;
+            std::stable_sort(positions.begin(), positions.end(),
+                             [&getter, &records, ascending](size_t a, size_t b)
+                             {
+                                 int order = QueryValues::compare(getter(records[a]), getter(records[b]));
+                                 return ascending ? order < 0 : order > 0;
+                             });
+        }
+
+        size_t begin = std::min(plan.offset, positions.size());
+        size_t count = std::min(plan.limit, positions.size() - begin);
+        positions.erase(positions.begin() + begin + count, positions.end());
+        positions.erase(positions.begin(), positions.begin() + begin);
+        return positions;
+    }
+
+    // select(), then copies out the page
+    template <typename Records>
+    std::vector<T> execute(const QueryPlan &plan, const Records &records, std::vector<size_t> positions) const
+    {
+        std::vector<size_t> page = select(plan, records, std::move(positions));
+        std::vector<T> results;
+        results.reserve(page.size());
+        for (size_t position : page)
+        {
+            results.push_back(records[position]);
+        }
+        return results;
+    }
+};
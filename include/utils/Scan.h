@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// One page of a listing. Pass nextCursor back as the cursor for the page after it.
+template <typename T>
+struct Page
+{
+    std::vector<T> items;
+    int nextCursor = 0;
+    bool hasMore = false;
+};
+
+// Shared pieces of the managers' forEach scans, which hand each record to a
+// visitor by const reference instead of copying it into a vector.
+namespace Scan
+{
+    constexpr size_t NO_LIMIT = std::numeric_limits<size_t>::max();
+    // Page size of the managers' printAll* listings, which page through the records
+    constexpr size_t PRINT_PAGE_SIZE = 100;
+
+    // Returns false to stop the scan
+    template <typename T>
+    using Visitor = std::function<bool(const T &)>;
+
+    // Returns true for records to visit; an empty filter passes every record
+    template <typename T>
+    using Filter = std::function<bool(const T &)>;
+
+    // Visits the records of range that pass filter, at most limit of them.
+    // Returns the number visited.
+    template <typename Range, typename T>
+    size_t run(const Range &range, const Visitor<T> &visitor, const Filter<T> &filter, size_t limit)
+    {
+        size_t visited = 0;
+        for (const T &record : range)
+        {
+            if (visited >= limit)
+            {
+                break;
+            }
+            if (filter && !filter(record))
+            {
+                continue;
+            }
+
+            ++visited;
+            if (!visitor(record))
+            {
+                break;
+            }
+        }
+        return visited;
+    }
+
+    // The pageSize records after the one with id afterId (0 for the first page).
+    // records must be indexable and in ascending id order, so the cursor is found by
+    // binary search and a page costs O(log n + pageSize) however deep it is.
+    template <typename T, typename Records, typename IdOf>
+    Page<T> page(const Records &records, IdOf idOf, int afterId, size_t pageSize)
+    {
+        size_t low = 0;
+        size_t high = records.size();
+        while (low < high)
+        {
+            size_t mid = low + (high - low) / 2;
+            if (std::invoke(idOf, records[mid]) <= afterId)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        Page<T> result;
+        size_t end = low + std::min(pageSize, records.size() - low);
+        result.items.reserve(end - low);
+        for (size_t i = low; i < end; ++i)
+        {
+            result.items.push_back(records[i]);
+        }
+        result.hasMore = end < records.size();
+        result.nextCursor = result.items.empty() ? afterId : std::invoke(idOf, result.items.back());
+        return result;
+    }
+
+    // Visitor that copies every record into out, for the vector-returning wrappers
+    template <typename T>
+    Visitor<T> collectInto(std::vector<T> &out)
+    {
+        return [&out](const T &record)
+        {
+            out.push_back(record);
+            return true;
+        };
+    }
+}
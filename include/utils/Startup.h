@@ -0,0 +1,85 @@
+#pragma once
+#include "utils/Trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Where start-up time goes. Between begin() and finish(), StartupPhase scopes record
+// their duration, and optionally the bytes and records they handled; phases started
+// inside another phase are nested under it in the report. main() logs the report
+// on every start and prints it for --startup-report.
+class StartupProfiler
+{
+public:
+    struct Phase
+    {
+        std::string name;
+        int depth = 0;
+        double start = 0;   // seconds since begin()
+        double seconds = 0; // duration
+        std::uint64_t bytes = 0;
+        std::uint64_t records = 0;
+    };
+
+private:
+    static std::unique_ptr<StartupProfiler> instance;
+    static std::once_flag instanceFlag;
+
+    std::atomic<bool> recording;
+    std::chrono::steady_clock::time_point started;
+    double totalSeconds;
+    std::mutex phasesMutex;
+    std::vector<Phase> phases;
+
+    StartupProfiler();
+
+public:
+    static StartupProfiler &getInstance();
+
+    // Clears earlier phases and starts recording
+    void begin();
+    // Stops recording and fixes the total start-up time
+    void finish();
+    bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+    double elapsed() const;
+
+    void record(const Phase &phase);
+    // Phases in the order they started, so each is followed by the ones nested in it
+    std::vector<Phase> getPhases();
+    double getTotalSeconds() const { return totalSeconds; }
+
+    // Table of phases with milliseconds, megabytes, records and rates
+    std::string report();
+    // One INFO line per phase
+    void logReport();
+
+    StartupProfiler(const StartupProfiler &) = delete;
+    StartupProfiler &operator=(const StartupProfiler &) = delete;
+};
+
+// Times the enclosing scope as a start-up phase. Also a trace span, so it shows on
+// timelines recorded with TRACE_SPAN. Costs one flag check when the profiler is not
+// recording; name must be a string literal.
+class StartupPhase
+{
+private:
+    TraceSpan span;
+    const char *name;
+    double start; // -1 when the profiler was not recording
+    std::uint64_t bytes;
+    std::uint64_t records;
+
+public:
+    explicit StartupPhase(const char *name);
+    ~StartupPhase();
+
+    void setBytes(std::uint64_t count) { bytes = count; }
+    void setRecords(std::uint64_t count) { records = count; }
+
+    StartupPhase(const StartupPhase &) = delete;
+    StartupPhase &operator=(const StartupPhase &) = delete;
+};
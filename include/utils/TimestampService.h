@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+// Caches the "YYYY-MM-DD HH:MM:SS" wall-clock string. The cache is refreshed at
+// most once per second, so logging and order creation don't pay for
+// localtime/put_time on every call.
+class TimestampService
+{
+private:
+    static std::unique_ptr<TimestampService> instance;
+    static std::once_flag instanceFlag;
+
+    mutable std::shared_mutex cacheMutex;
+    std::time_t cachedEpoch;
+    std::string cachedDateTime;
+
+    TimestampService();
+    // The wall clock, read with the cheapest second-resolution source available
+    static std::time_t readClock();
+    void refresh(std::time_t epoch);
+
+public:
+    static TimestampService &getInstance();
+
+    // Current local time formatted as "YYYY-MM-DD HH:MM:SS"
+    std::string now();
+    // Current time in seconds since the epoch; the same cached second now() formats
+    std::time_t epochSeconds();
+
+    // Thread-safe replacement for std::localtime
+    static std::tm toLocalTime(std::time_t epoch);
+    static std::string formatDateTime(std::time_t epoch);
+
+    // Delete copy constructor and assignment operator
+    TimestampService(const TimestampService &) = delete;
+    TimestampService &operator=(const TimestampService &) = delete;
+};
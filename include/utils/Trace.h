@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Timeline tracing. TRACE_SPAN("orders.serialize") records when the enclosing scope
+// started and how long it took into a buffer owned by the calling thread, and
+// Tracer::writeChromeTrace exports every thread's spans as Chrome trace-event JSON
+// (open it in chrome://tracing or ui.perfetto.dev). Spans nest, so a slow save shows
+// as serialize, write and close phases under it.
+//
+// Off by default. While off, a span costs one relaxed atomic load.
+class Tracer
+{
+public:
+    struct Span
+    {
+        const char *name; // a string literal; only the pointer is stored
+        std::int64_t start;    // nanoseconds since the tracer started
+        std::int64_t duration; // nanoseconds
+    };
+
+    // Spans recorded by one thread. Kept alive by the tracer after the thread exits.
+    struct ThreadBuffer
+    {
+        std::mutex mutex; // only contended while exporting
+        std::vector<Span> spans;
+        std::uint64_t dropped = 0;
+        int threadId = 0;
+    };
+
+    // Spans kept per thread; later ones are counted as dropped
+    static const size_t MAX_SPANS_PER_THREAD = 1 << 20;
+
+private:
+    static std::unique_ptr<Tracer> instance;
+    static std::once_flag instanceFlag;
+
+    std::atomic<bool> enabled;
+    std::chrono::steady_clock::time_point epoch;
+
+    std::mutex buffersMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    int nextThreadId;
+
+    Tracer();
+    ThreadBuffer &threadBuffer();
+
+public:
+    static Tracer &getInstance();
+
+    // Clears earlier spans and starts recording
+    void start();
+    // Stops recording; the spans are kept for writeChromeTrace
+    void stop();
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    std::int64_t now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+    void record(const char *name, std::int64_t start, std::int64_t duration);
+
+    // Every recorded span, ordered by thread and then by end time
+    std::vector<std::pair<int, Span>> spans();
+    std::uint64_t droppedSpans();
+
+    // Writes {"traceEvents":[...]} with one complete ("X") event per span, and the
+    // number of dropped spans under "otherData"
+    bool writeChromeTrace(const std::string &filename);
+
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+};
+
+class TraceSpan
+{
+private:
+    const char *name;
+    std::int64_t start; // -1 when tracing was off at construction
+
+public:
+    explicit TraceSpan(const char *name)
+        : name(name), start(Tracer::getInstance().isEnabled() ? Tracer::getInstance().now() : -1)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (start >= 0)
+        {
+            Tracer &tracer = Tracer::getInstance();
+            tracer.record(name, start, tracer.now() - start);
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+// Traces the rest of the enclosing scope; name must be a string literal
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(name)
@@ -0,0 +1,60 @@
+#pragma once
+#include <functional>
+
+// Groups changes to several managers into one all-or-nothing unit of work:
+//
+//     Transaction transaction;
+//     orderManager.createOrder(customerId);
+//     orderManager.addItemToOrder(orderId, productId, 2);
+//     transaction.commit();
+//
+// Data files saved while the transaction is open are written together through the
+// database journal on commit. abort(), or destroying a transaction that wasn't
+// committed, drops those files and the audit records queued with afterCommit, and
+// runs the undo actions the managers registered, newest first. commit() can be
+// called with manager locks held; if writing fails it returns false and, as with a
+// failed save, the changes stay in memory for the next save to write (their audit
+// records still go out). Manager methods that commit their own transaction
+// therefore report whether the change was made, not whether it reached the disk.
+//
+// Transactions belong to the thread that opened them and nest: an inner one joins
+// the outer one and its abort only undoes its own changes (a savepoint). Changes are
+// visible to other threads as soon as they are made; this is atomicity, not isolation.
+// Undo actions take manager locks, so don't abort while holding one.
+//
+// For long runs of small changes, deferSaves() on the outermost transaction stops
+// each change re-serializing a whole data file: managers then only register their
+// save, and commit() runs each registered save once before writing. The saves take
+// manager locks, so such a transaction must be committed with none held.
+class Transaction
+{
+private:
+    bool outermost;
+    bool finished;
+    size_t undoMark;
+    size_t afterCommitMark;
+
+public:
+    Transaction();
+    ~Transaction();
+
+    bool commit();
+    void abort();
+    // Defers the managers' saves to commit(); only on the outermost transaction
+    void deferSaves();
+
+    // True while the calling thread has an open transaction
+    static bool active();
+    // Registers how to reverse an in-memory change; ignored outside a transaction
+    static void onAbort(std::function<void()> undo);
+    // Runs record (an audit line, an event) once the outermost transaction commits
+    // and drops it if the change is aborted; runs it at once outside a transaction
+    static void afterCommit(std::function<void()> record);
+    // For a manager's save: if the open transaction defers saves, registers save
+    // (once per owner) and returns true; otherwise the caller should save now
+    static bool deferSave(const void *owner, std::function<void()> save);
+
+    // Delete copy constructor and assignment operator
+    Transaction(const Transaction &) = delete;
+    Transaction &operator=(const Transaction &) = delete;
+};
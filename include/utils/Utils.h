@@ -49,6 +49,7 @@ namespace Utils
     std::string formatCurrency(double amount, const std::string &symbol = "$");
     std::string formatNumber(double number, int precision = 2);
     std::string formatPercentage(double value);
+    std::string formatBytes(size_t bytes); // e.g. "12.3 MB"
 
     // File utilities
     bool createDirectory(const std::string &path);
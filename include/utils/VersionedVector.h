@@ -0,0 +1,263 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <iterator>
+#include <cstddef>
+
+namespace detail
+{
+    // One version of a VersionedVector's contents. Records are shared between
+    // versions until a writer changes them.
+    template <typename T>
+    struct RecordVersion
+    {
+        std::vector<std::shared_ptr<T>> records;
+        std::vector<bool> owned;              // record is reachable from this version only
+        mutable std::atomic<int> readers{0}; // live Snapshot handles on this version
+        mutable std::atomic<int> writers{0}; // live InPlaceWrite registrations
+
+        // Snapshots waiting for writers to reach 0 block here instead of spinning
+        mutable std::atomic<int> waiting{0};
+        mutable std::mutex writersMutex;
+        mutable std::condition_variable writersDone;
+
+        void waitForWriters() const
+        {
+            if (writers.load(std::memory_order_seq_cst) == 0)
+            {
+                return;
+            }
+            waiting.fetch_add(1, std::memory_order_seq_cst);
+            std::unique_lock<std::mutex> lock(writersMutex);
+            writersDone.wait(lock, [this]
+                             { return writers.load(std::memory_order_seq_cst) == 0; });
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void endWrite() const
+        {
+            // Either this sees the waiter, or the waiter sees writers at 0
+            if (writers.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+                waiting.load(std::memory_order_seq_cst) > 0)
+            {
+                std::lock_guard<std::mutex> lock(writersMutex);
+                writersDone.notify_all();
+            }
+        }
+    };
+
+    template <typename T>
+    class RecordIterator
+    {
+    private:
+        using Base = typename std::vector<std::shared_ptr<T>>::const_iterator;
+        Base it;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        RecordIterator() = default;
+        explicit RecordIterator(Base it) : it(it) {}
+
+        reference operator*() const { return **it; }
+        pointer operator->() const { return it->get(); }
+        RecordIterator &operator++()
+        {
+            ++it;
+            return *this;
+        }
+        RecordIterator operator++(int)
+        {
+            RecordIterator previous = *this;
+            ++it;
+            return previous;
+        }
+        bool operator==(const RecordIterator &other) const { return it == other.it; }
+        bool operator!=(const RecordIterator &other) const { return it != other.it; }
+    };
+}
+
+// Immutable view of a VersionedVector at the moment it was taken. Copying is
+// O(1), and it can be read from any thread without a lock for as long as it is
+// held; writers carry on against newer versions.
+template <typename T>
+class Snapshot
+{
+private:
+    std::shared_ptr<const detail::RecordVersion<T>> version;
+
+public:
+    using const_iterator = detail::RecordIterator<T>;
+
+    Snapshot() = default;
+    explicit Snapshot(std::shared_ptr<const detail::RecordVersion<T>> version) : version(std::move(version)) {}
+
+    size_t size() const { return version ? version->records.size() : 0; }
+    bool empty() const { return size() == 0; }
+    const T &operator[](size_t index) const { return *version->records[index]; }
+
+    const_iterator begin() const { return version ? const_iterator(version->records.begin()) : const_iterator(); }
+    const_iterator end() const { return version ? const_iterator(version->records.end()) : const_iterator(); }
+};
+
+// Registration of an in-place writer with the version it writes; see
+// VersionedVector::beginInPlace. Ends when destroyed.
+template <typename T>
+class InPlaceWrite
+{
+private:
+    std::shared_ptr<const detail::RecordVersion<T>> version;
+
+public:
+    InPlaceWrite() = default;
+    explicit InPlaceWrite(std::shared_ptr<const detail::RecordVersion<T>> version) : version(std::move(version))
+    {
+        this->version->writers.fetch_add(1, std::memory_order_seq_cst);
+    }
+    InPlaceWrite(InPlaceWrite &&other) noexcept = default;
+    InPlaceWrite &operator=(InPlaceWrite &&other) noexcept
+    {
+        end();
+        version = std::move(other.version);
+        return *this;
+    }
+    ~InPlaceWrite() { end(); }
+
+    void end()
+    {
+        if (version)
+        {
+            version->endWrite();
+            version.reset();
+        }
+    }
+
+    InPlaceWrite(const InPlaceWrite &) = delete;
+    InPlaceWrite &operator=(const InPlaceWrite &) = delete;
+};
+
+// Copy-on-write record storage for the managers. Not synchronized itself: the
+// owning manager's lock protects the current version, while snapshots need none.
+//
+// Taking a snapshot is O(1) and only needs the owner's shared lock; at most it
+// waits for an in-place write in progress, which holds its registration for the
+// change alone and never across I/O. The first write after one copies the record
+// list (pointers only), and a record is copied the first time it is written while
+// a snapshot may still see it; otherwise writes happen in place.
+template <typename T>
+class VersionedVector
+{
+private:
+    std::shared_ptr<detail::RecordVersion<T>> current;
+
+    // Starts a new version if a snapshot holds the current one
+    void detach()
+    {
+        if (current->readers.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+
+        auto next = std::make_shared<detail::RecordVersion<T>>();
+        next->records = current->records;
+        next->owned.assign(next->records.size(), false);
+        current = next;
+    }
+
+public:
+    using const_iterator = detail::RecordIterator<T>;
+
+    VersionedVector() : current(std::make_shared<detail::RecordVersion<T>>()) {}
+
+    size_t size() const { return current->records.size(); }
+    bool empty() const { return current->records.empty(); }
+    const T &operator[](size_t index) const { return *current->records[index]; }
+    const_iterator begin() const { return const_iterator(current->records.begin()); }
+    const_iterator end() const { return const_iterator(current->records.end()); }
+
+    // Heap bytes of the current version: its record list, and per record the block
+    // holding the record and its reference counts. Heap owned by the records is not
+    // included, nor are older versions that snapshots still hold.
+    size_t storageBytes() const
+    {
+        return sizeof(detail::RecordVersion<T>) + current->records.capacity() * sizeof(std::shared_ptr<T>) +
+               current->owned.capacity() / 8 + current->records.size() * (sizeof(T) + 2 * sizeof(void *));
+    }
+
+    // Waits for in-place writers of the current version to finish, so the snapshot
+    // never sees a record change
+    Snapshot<T> snapshot() const
+    {
+        current->readers.fetch_add(1, std::memory_order_seq_cst);
+        current->waitForWriters();
+        std::shared_ptr<detail::RecordVersion<T>> keep = current;
+        return Snapshot<T>(std::shared_ptr<const detail::RecordVersion<T>>(
+            keep.get(), [keep](const detail::RecordVersion<T> *version)
+            { version->readers.fetch_sub(1, std::memory_order_release); }));
+    }
+
+    // Writable record, copied first if a snapshot may still see it
+    T &mutableAt(size_t index)
+    {
+        detach();
+        if (!current->owned[index])
+        {
+            current->records[index] = std::make_shared<T>(*current->records[index]);
+            current->owned[index] = true;
+        }
+        return *current->records[index];
+    }
+
+    // For fields that are safe to update concurrently (atomics) under a shared
+    // lock. Register with beginInPlace first and keep the registration until the
+    // writes are done; canWriteInPlace then says whether no snapshot can see record
+    // index, so it may change in place. A snapshot taken meanwhile waits for the
+    // registration to end: either it sees the writer or the writer sees it. End the
+    // registration as soon as the records are changed, before saving or logging.
+    InPlaceWrite<T> beginInPlace() const { return InPlaceWrite<T>(current); }
+    bool canWriteInPlace(size_t index) const
+    {
+        return current->readers.load(std::memory_order_seq_cst) == 0 && current->owned[index];
+    }
+    T &inPlaceAt(size_t index) { return *current->records[index]; }
+
+    void push_back(const T &value)
+    {
+        detach();
+        current->records.push_back(std::make_shared<T>(value));
+        current->owned.push_back(true);
+    }
+
+    void insert(size_t index, const T &value)
+    {
+        detach();
+        current->records.insert(current->records.begin() + static_cast<std::ptrdiff_t>(index), std::make_shared<T>(value));
+        current->owned.insert(current->owned.begin() + static_cast<std::ptrdiff_t>(index), true);
+    }
+
+    void erase(size_t index)
+    {
+        detach();
+        current->records.erase(current->records.begin() + static_cast<std::ptrdiff_t>(index));
+        current->owned.erase(current->owned.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+
+    void clear()
+    {
+        current = std::make_shared<detail::RecordVersion<T>>();
+    }
+
+    void reserve(size_t count)
+    {
+        detach();
+        current->records.reserve(count);
+        current->owned.reserve(count);
+    }
+};
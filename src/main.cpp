@@ -1,43 +1,310 @@
+#include "ui/BatchRunner.h"
 #include "ui/ConsoleUI.h"
+#include "ui/RequestServer.h"
 #include "utils/Logger.h"
 #include "utils/Database.h"
+#include "utils/EventLog.h"
+#include "utils/Metrics.h"
+#include "utils/Startup.h"
+#include "utils/Trace.h"
 #include "utils/Utils.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <exception>
+#include <thread>
 
-int main()
+namespace
 {
+    void printUsage(const char *program)
+    {
+        std::cerr << "Usage: " << program << " [--startup-report]\n"
+                  << "       " << program << " --batch FILE|- --user NAME [--password TEXT]\n"
+                  << "       " << program << " --serve SOCKET [--workers N] --user NAME [--password TEXT]\n\n"
+                  << "  --startup-report  Load the data, print the start-up phase timings and exit\n"
+                  << "  --batch FILE      Run the commands in FILE (- for stdin) without prompts and exit\n"
+                  << "  --serve SOCKET    Answer commands on a Unix domain socket until interrupted\n"
+                  << "  --workers N       Threads running requests (default: one per core)\n"
+                  << "  --user NAME       Account the commands run as\n"
+                  << "  --password TEXT   Its password (default: $ORDERMGMT_PASSWORD)\n\n"
+                  << "Commands, one per line or request, comma-separated:\n"
+                  << BatchRunner::usage();
+    }
+
+    // Writes the timeline started for ORDERMGMT_TRACE, if any
+    void finishTrace(const char *traceFile)
+    {
+        if (traceFile && *traceFile)
+        {
+            Tracer::getInstance().stop();
+            if (!Tracer::getInstance().writeChromeTrace(traceFile))
+            {
+                LOG_WARNING("Failed to write trace to " + std::string(traceFile));
+            }
+        }
+    }
+
+    // --batch: logs in, runs the commands against freshly loaded managers and saves
+    // once. Returns the exit status: 0 if every command succeeded.
+    int runBatch(const std::string &file, const std::string &username, const std::string &password)
+    {
+        std::ifstream fileStream;
+        if (file != "-")
+        {
+            fileStream.open(file);
+            if (!fileStream.is_open())
+            {
+                Utils::printError("Cannot open batch file: " + file);
+                return 1;
+            }
+        }
+        std::istream &in = file == "-" ? std::cin : fileStream;
+
+        UserManager users;
+        CustomerManager customers;
+        ProductManager products;
+        OrderManager orders(&products, &customers);
+        {
+            StartupProfiler &profiler = StartupProfiler::getInstance();
+            profiler.finish();
+            profiler.logReport();
+        }
+
+        if (!users.login(username, password))
+        {
+            Utils::printError("Login failed for batch user: " + username);
+            return 1;
+        }
+
+        BatchRunner runner(users, customers, products, orders);
+        BatchRunner::Report report = runner.run(in, std::cout);
+        users.logout();
+
+        for (const auto &failure : report.result.failures)
+        {
+            std::cerr << "line " << failure.row << ": " << failure.reason << "\n";
+        }
+        std::cerr << "Batch: " << report.result.applied << " of " << report.commands << " commands applied";
+        if (!report.saved)
+        {
+            std::cerr << "; not saved: writing the data files failed";
+        }
+        std::cerr << std::endl;
+        return report.saved && report.result.ok() ? 0 : 1;
+    }
+
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void requestStop(int)
+    {
+        stopRequested = 1;
+    }
+
+    // --serve: logs in and answers requests on socketPath until SIGINT or SIGTERM
+    int runServer(const std::string &socketPath, size_t workers, const std::string &username,
+                  const std::string &password)
+    {
+        UserManager users;
+        CustomerManager customers;
+        ProductManager products;
+        OrderManager orders(&products, &customers);
+        {
+            StartupProfiler &profiler = StartupProfiler::getInstance();
+            profiler.finish();
+            profiler.logReport();
+        }
+
+        if (!users.login(username, password))
+        {
+            Utils::printError("Login failed for server user: " + username);
+            return 1;
+        }
+
+        RequestServer server(users, customers, products, orders);
+        if (!server.start(socketPath, workers))
+        {
+            Utils::printError("Cannot serve on " + socketPath + "; see the log for details.");
+            users.logout();
+            return 1;
+        }
+
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+        std::cerr << "Serving on " << socketPath << " with " << workers << " workers; Ctrl+C to stop" << std::endl;
+        while (!stopRequested)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        server.stop();
+        users.logout();
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // --startup-report loads everything, prints where the time went and exits;
+    // --batch runs a command file and --serve answers requests instead of the menus
+    bool startupReport = false;
+    std::string batchFile;
+    std::string socketPath;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    std::string username;
+    const char *passwordVariable = std::getenv("ORDERMGMT_PASSWORD");
+    std::string password = passwordVariable ? passwordVariable : "";
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--help") == 0)
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (std::strcmp(argv[i], "--startup-report") == 0)
+        {
+            startupReport = true;
+        }
+        else if (std::strcmp(argv[i], "--batch") == 0 && hasValue)
+        {
+            batchFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--serve") == 0 && hasValue)
+        {
+            socketPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--workers") == 0 && hasValue && std::atoi(argv[i + 1]) > 0)
+        {
+            workers = static_cast<size_t>(std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--user") == 0 && hasValue)
+        {
+            username = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--password") == 0 && hasValue)
+        {
+            password = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    bool headless = !batchFile.empty() || !socketPath.empty();
+    if (headless && (username.empty() || startupReport || (!batchFile.empty() && !socketPath.empty())))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
     try
     {
+        StartupProfiler &profiler = StartupProfiler::getInstance();
+        profiler.begin();
+
         // Initialize logger
         Logger &logger = Logger::getInstance();
-        if (!logger.initialize("logs/application.log", LogLevel::INFO))
         {
-            std::cerr << "Warning: Failed to initialize logger." << std::endl;
+            StartupPhase phase("logger");
+            if (!logger.initialize("logs/application.log", LogLevel::INFO))
+            {
+                std::cerr << "Warning: Failed to initialize logger." << std::endl;
+            }
         }
 
         LOG_INFO("Application starting up...");
 
+        // Binary audit log of domain events (orders, stock, logins)
+        {
+            StartupPhase phase("event log");
+            if (!EventLog::getInstance().initialize("logs/events.bin"))
+            {
+                LOG_WARNING("Failed to open event log; audit events will not be recorded");
+            }
+        }
+
+        // Operation counters and latencies, rewritten for Prometheus' textfile collector
+        {
+            StartupPhase phase("metrics");
+            if (!Metrics::getInstance().startDump("logs/metrics.prom", std::chrono::seconds(15)))
+            {
+                LOG_WARNING("Failed to write logs/metrics.prom; metrics will only be shown in System Reports");
+            }
+        }
+
+        // ORDERMGMT_TRACE=trace.json records a timeline of saves, loads and queries,
+        // written on exit for chrome://tracing
+        const char *traceFile = std::getenv("ORDERMGMT_TRACE");
+        if (traceFile && *traceFile)
+        {
+            Tracer::getInstance().start();
+        }
+
         // Initialize database
         Database &database = Database::getInstance();
-        if (!database.initialize("data/"))
         {
-            LOG_ERROR("Failed to initialize database");
-            Utils::printError("Failed to initialize database system.");
-            return 1;
+            StartupPhase phase("database");
+            if (!database.initialize("data/"))
+            {
+                LOG_ERROR("Failed to initialize database");
+                Utils::printError("Failed to initialize database system.");
+                return 1;
+            }
         }
 
-        // Create and initialize console UI
+        if (!batchFile.empty())
+        {
+            int status = runBatch(batchFile, username, password);
+            finishTrace(traceFile);
+            LOG_INFO("Batch finished; shutting down");
+            Metrics::getInstance().stopDump();
+            EventLog::getInstance().close();
+            logger.close();
+            return status;
+        }
+
+        if (!socketPath.empty())
+        {
+            int status = runServer(socketPath, workers, username, password);
+            finishTrace(traceFile);
+            LOG_INFO("Server stopped; shutting down");
+            Metrics::getInstance().stopDump();
+            EventLog::getInstance().close();
+            logger.close();
+            return status;
+        }
+
+        // Create and initialize console UI; this loads every data file
         ConsoleUI ui;
-        if (!ui.initialize())
         {
-            LOG_ERROR("Failed to initialize user interface");
-            Utils::printError("Failed to initialize user interface.");
-            return 1;
+            StartupPhase phase("managers");
+            if (!ui.initialize())
+            {
+                LOG_ERROR("Failed to initialize user interface");
+                Utils::printError("Failed to initialize user interface.");
+                return 1;
+            }
         }
 
+        profiler.finish();
+        profiler.logReport();
         LOG_INFO("All systems initialized successfully");
 
+        if (startupReport)
+        {
+            std::cout << profiler.report();
+            ui.shutdown();
+            Metrics::getInstance().stopDump();
+            EventLog::getInstance().close();
+            logger.close();
+            return 0;
+        }
+
         // Display welcome message
         ui.displayWelcomeMessage();
 
@@ -47,7 +314,11 @@ int main()
         // Cleanup
         ui.shutdown();
 
+        finishTrace(traceFile);
+
         LOG_INFO("Application shutting down normally");
+        Metrics::getInstance().stopDump();
+        EventLog::getInstance().close();
         logger.close();
 
         return 0;
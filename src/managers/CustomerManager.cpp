@@ -1,51 +1,87 @@
 #include "managers/CustomerManager.h"
 #include "utils/Database.h"
 #include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include "utils/Startup.h"
+#include "utils/Trace.h"
+#include "utils/Transaction.h"
 #include "utils/Utils.h"
 #include <algorithm>
 #include <iostream>
 #include <map>
+#include <mutex>
 
-CustomerManager::CustomerManager() : nextCustomerId(1)
+CustomerManager::CustomerManager() : queryEngine("customers"), nextCustomerId(1)
 {
+    setUpQueries();
     loadCustomers();
 }
 
 CustomerManager::~CustomerManager()
 {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     saveCustomers();
 }
 
 void CustomerManager::loadCustomers()
 {
+    StartupPhase phase("customers.load");
     Database &db = Database::getInstance();
     std::vector<std::string> data = db.loadCustomers();
 
     customers.clear();
-    for (const auto &line : data)
     {
-        if (!line.empty())
+        StartupPhase parsePhase("customers.parse");
+        for (const auto &line : data)
         {
-            Customer customer = Customer::deserialize(line);
-            customers.push_back(customer);
-
-            // Update next ID
-            if (customer.getCustomerId() >= nextCustomerId)
+            if (!line.empty())
             {
-                nextCustomerId = customer.getCustomerId() + 1;
+                Customer customer = Customer::deserialize(line);
+                customers.push_back(customer);
+
+                // Update next ID
+                if (customer.getCustomerId() >= nextCustomerId)
+                {
+                    nextCustomerId = customer.getCustomerId() + 1;
+                }
             }
         }
+        parsePhase.setRecords(customers.size());
     }
 
+    // Paging relies on ascending ids, which only a hand-edited file would break
+    auto byId = [](const Customer &a, const Customer &b)
+    { return a.getCustomerId() < b.getCustomerId(); };
+    if (!std::is_sorted(customers.begin(), customers.end(), byId))
+    {
+        std::stable_sort(customers.begin(), customers.end(), byId);
+    }
+
+    rebuildIndexLocked();
     LOG_INFO("Loaded " + std::to_string(customers.size()) + " customers");
 }
 
 void CustomerManager::saveCustomers()
 {
+    // In a transaction that defers saves, the file is written once at its commit
+    if (Transaction::deferSave(this, [this]
+                               {
+                                   std::shared_lock<std::shared_mutex> lock(dataMutex);
+                                   saveCustomers(); }))
+    {
+        return;
+    }
+
+    METRIC_TIMER("customer_save");
+    TRACE_SPAN("customers.save");
     std::vector<std::string> data;
-    for (const auto &customer : customers)
     {
-        data.push_back(customer.serialize());
+        TRACE_SPAN("customers.serialize");
+        data.reserve(customers.size());
+        for (const auto &customer : customers)
+        {
+            data.push_back(customer.serialize());
+        }
     }
 
     Database &db = Database::getInstance();
@@ -64,9 +100,69 @@ int CustomerManager::generateNextId()
     return nextCustomerId++;
 }
 
+void CustomerManager::rebuildIndexLocked()
+{
+    StartupPhase phase("customers.index");
+    emailIndex.clear();
+    phoneIndex.clear();
+    emailIndex.reserve(customers.size());
+    phoneIndex.reserve(customers.size());
+    for (const auto &customer : customers)
+    {
+        indexCustomerLocked(customer);
+    }
+}
+
+void CustomerManager::indexCustomerLocked(const Customer &customer)
+{
+    emailIndex[Utils::toLower(customer.getEmail())] = customer.getCustomerId();
+    phoneIndex[customer.getPhone()] = customer.getCustomerId();
+}
+
+void CustomerManager::unindexCustomerLocked(const Customer &customer)
+{
+    auto email = emailIndex.find(Utils::toLower(customer.getEmail()));
+    if (email != emailIndex.end() && email->second == customer.getCustomerId())
+    {
+        emailIndex.erase(email);
+    }
+    auto phone = phoneIndex.find(customer.getPhone());
+    if (phone != phoneIndex.end() && phone->second == customer.getCustomerId())
+    {
+        phoneIndex.erase(phone);
+    }
+}
+
+void CustomerManager::setUpQueries()
+{
+    queryEngine.field("id", [](const Customer &c)
+                      { return FieldValue(static_cast<double>(c.getCustomerId())); })
+        .field("name", [](const Customer &c)
+               { return FieldValue(std::string_view(c.getName())); })
+        .field("email", [](const Customer &c)
+               { return FieldValue(std::string_view(c.getEmail())); })
+        .field("phone", [](const Customer &c)
+               { return FieldValue(std::string_view(c.getPhone())); })
+        .field("address", [](const Customer &c)
+               { return FieldValue(std::string_view(c.getAddress())); })
+        .field("city", [](const Customer &c)
+               { return FieldValue(std::string_view(c.getCity())); })
+        .field("country", [](const Customer &c)
+               { return FieldValue(std::string_view(c.getCountry())); })
+        .field("active", [](const Customer &c)
+               { return FieldValue(c.getIsActive() ? 1.0 : 0.0); });
+}
+
 bool CustomerManager::addCustomer(const Customer &customer)
 {
-    if (!validateCustomer(customer))
+    int customerId = 0;
+    return addCustomer(customer, customerId);
+}
+
+bool CustomerManager::addCustomer(const Customer &customer, int &customerId)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    if (!validateCustomerLocked(customer))
     {
         LOG_WARNING("Invalid customer data");
         return false;
@@ -76,40 +172,121 @@ bool CustomerManager::addCustomer(const Customer &customer)
     newCustomer.setCustomerId(generateNextId());
 
     customers.push_back(newCustomer);
+    indexCustomerLocked(newCustomer);
     saveCustomers();
 
+    customerId = newCustomer.getCustomerId();
     LOG_INFO("Added new customer: " + newCustomer.getName());
     return true;
 }
 
+BatchResult CustomerManager::addCustomers(const std::vector<Customer> &batch)
+{
+    BatchResult result = insertCustomers(batch);
+    if (result.applied > 0)
+    {
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        saveCustomers();
+    }
+    LOG_INFO("Added " + std::to_string(result.applied) + " of " + std::to_string(batch.size()) + " customers");
+    return result;
+}
+
+BatchResult CustomerManager::insertCustomers(const std::vector<Customer> &batch)
+{
+    BatchResult result;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    customers.reserve(customers.size() + batch.size());
+    for (size_t row = 0; row < batch.size(); ++row)
+    {
+        const Customer &customer = batch[row];
+        if (!customer.isValid())
+        {
+            result.fail(row, "invalid customer data");
+            continue;
+        }
+        // Against the indexes, which also hold the rows added so far
+        if (!isEmailUniqueLocked(customer.getEmail(), -1))
+        {
+            result.fail(row, "email already exists: " + customer.getEmail());
+            continue;
+        }
+        if (!isPhoneUniqueLocked(customer.getPhone(), -1))
+        {
+            result.fail(row, "phone number already exists: " + customer.getPhone());
+            continue;
+        }
+
+        Customer newCustomer = customer;
+        newCustomer.setCustomerId(generateNextId());
+        customers.push_back(newCustomer);
+        indexCustomerLocked(newCustomer);
+        ++result.applied;
+    }
+    return result;
+}
+
 Customer *CustomerManager::getCustomer(int customerId)
 {
-    auto it = std::find_if(customers.begin(), customers.end(),
-                           [customerId](const Customer &c)
-                           {
-                               return c.getCustomerId() == customerId;
-                           });
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return findCustomerLocked(customerId);
+}
+
+bool CustomerManager::getCustomerCopy(int customerId, Customer &customer)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    Customer *found = findCustomerLocked(customerId);
+    if (!found)
+    {
+        return false;
+    }
+    customer = *found;
+    return true;
+}
+
+Customer *CustomerManager::findCustomerLocked(int customerId)
+{
+    // Customers are in ascending id order
+    auto it = std::lower_bound(customers.begin(), customers.end(), customerId,
+                               [](const Customer &c, int id)
+                               {
+                                   return c.getCustomerId() < id;
+                               });
+
+    return (it != customers.end() && it->getCustomerId() == customerId) ? &(*it) : nullptr;
+}
 
-    return (it != customers.end()) ? &(*it) : nullptr;
+size_t CustomerManager::forEach(const Scan::Visitor<Customer> &visitor, const Scan::Filter<Customer> &filter,
+                                size_t limit) const
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return Scan::run(customers, visitor, filter, limit);
 }
 
 std::vector<Customer> CustomerManager::getAllCustomers()
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return customers;
 }
 
+Page<Customer> CustomerManager::getCustomersPage(int afterId, size_t pageSize)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return Scan::page<Customer>(customers, &Customer::getCustomerId, afterId, pageSize);
+}
+
 std::vector<Customer> CustomerManager::getActiveCustomers()
 {
     std::vector<Customer> activeCustomers;
-    std::copy_if(customers.begin(), customers.end(),
-                 std::back_inserter(activeCustomers),
-                 [](const Customer &c)
-                 { return c.getIsActive(); });
+    forEach(Scan::collectInto(activeCustomers),
+            [](const Customer &c)
+            { return c.getIsActive(); });
     return activeCustomers;
 }
 
 bool CustomerManager::updateCustomer(const Customer &customer)
 {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     auto it = std::find_if(customers.begin(), customers.end(),
                            [&customer](const Customer &c)
                            {
@@ -118,12 +295,14 @@ bool CustomerManager::updateCustomer(const Customer &customer)
 
     if (it != customers.end())
     {
-        if (!validateCustomer(customer))
+        if (!validateCustomerLocked(customer))
         {
             return false;
         }
 
+        unindexCustomerLocked(*it);
         *it = customer;
+        indexCustomerLocked(customer);
         saveCustomers();
         LOG_INFO("Updated customer: " + customer.getName());
         return true;
@@ -134,6 +313,7 @@ bool CustomerManager::updateCustomer(const Customer &customer)
 
 bool CustomerManager::deleteCustomer(int customerId)
 {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     auto it = std::find_if(customers.begin(), customers.end(),
                            [customerId](const Customer &c)
                            {
@@ -143,6 +323,7 @@ bool CustomerManager::deleteCustomer(int customerId)
     if (it != customers.end())
     {
         std::string customerName = it->getName();
+        unindexCustomerLocked(*it);
         customers.erase(it);
         saveCustomers();
         LOG_INFO("Deleted customer: " + customerName);
@@ -154,7 +335,8 @@ bool CustomerManager::deleteCustomer(int customerId)
 
 bool CustomerManager::deactivateCustomer(int customerId)
 {
-    Customer *customer = getCustomer(customerId);
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Customer *customer = findCustomerLocked(customerId);
     if (customer)
     {
         customer->setIsActive(false);
@@ -167,7 +349,8 @@ bool CustomerManager::deactivateCustomer(int customerId)
 
 bool CustomerManager::activateCustomer(int customerId)
 {
-    Customer *customer = getCustomer(customerId);
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Customer *customer = findCustomerLocked(customerId);
     if (customer)
     {
         customer->setIsActive(true);
@@ -183,12 +366,11 @@ std::vector<Customer> CustomerManager::searchByName(const std::string &name)
     std::vector<Customer> results;
     std::string searchName = Utils::toLower(name);
 
-    std::copy_if(customers.begin(), customers.end(),
-                 std::back_inserter(results),
-                 [&searchName](const Customer &c)
-                 {
-                     return Utils::toLower(c.getName()).find(searchName) != std::string::npos;
-                 });
+    forEach(Scan::collectInto(results),
+            [&searchName](const Customer &c)
+            {
+                return Utils::toLower(c.getName()).find(searchName) != std::string::npos;
+            });
 
     return results;
 }
@@ -198,12 +380,11 @@ std::vector<Customer> CustomerManager::searchByEmail(const std::string &email)
     std::vector<Customer> results;
     std::string searchEmail = Utils::toLower(email);
 
-    std::copy_if(customers.begin(), customers.end(),
-                 std::back_inserter(results),
-                 [&searchEmail](const Customer &c)
-                 {
-                     return Utils::toLower(c.getEmail()).find(searchEmail) != std::string::npos;
-                 });
+    forEach(Scan::collectInto(results),
+            [&searchEmail](const Customer &c)
+            {
+                return Utils::toLower(c.getEmail()).find(searchEmail) != std::string::npos;
+            });
 
     return results;
 }
@@ -212,79 +393,87 @@ std::vector<Customer> CustomerManager::searchByPhone(const std::string &phone)
 {
     std::vector<Customer> results;
 
-    std::copy_if(customers.begin(), customers.end(),
-                 std::back_inserter(results),
-                 [&phone](const Customer &c)
-                 {
-                     return c.getPhone().find(phone) != std::string::npos;
-                 });
+    forEach(Scan::collectInto(results),
+            [&phone](const Customer &c)
+            {
+                return c.getPhone().find(phone) != std::string::npos;
+            });
 
     return results;
 }
 
 std::vector<Customer> CustomerManager::getCustomersByCity(const std::string &city)
 {
-    std::vector<Customer> results;
-    std::string searchCity = Utils::toLower(city);
-
-    std::copy_if(customers.begin(), customers.end(),
-                 std::back_inserter(results),
-                 [&searchCity](const Customer &c)
-                 {
-                     return Utils::toLower(c.getCity()) == searchCity;
-                 });
-
-    return results;
+    return query(Query().where(Predicate::eq("city", city)));
 }
 
 std::vector<Customer> CustomerManager::getCustomersByCountry(const std::string &country)
 {
-    std::vector<Customer> results;
-    std::string searchCountry = Utils::toLower(country);
+    return query(Query().where(Predicate::eq("country", country)));
+}
 
-    std::copy_if(customers.begin(), customers.end(),
-                 std::back_inserter(results),
-                 [&searchCountry](const Customer &c)
-                 {
-                     return Utils::toLower(c.getCountry()) == searchCountry;
-                 });
+std::vector<Customer> CustomerManager::query(const Query &query)
+{
+    QueryPlan plan = queryEngine.plan(query);
+    if (!plan.valid)
+    {
+        LOG_WARNING("Invalid customer query: " + plan.error);
+        return std::vector<Customer>();
+    }
 
-    return results;
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return queryEngine.execute(plan, customers, queryEngine.candidates(plan, customers.size()));
+}
+
+std::string CustomerManager::explain(const Query &query) const
+{
+    return queryEngine.plan(query).toString();
 }
 
 bool CustomerManager::isEmailUnique(const std::string &email, int excludeCustomerId)
 {
-    return std::none_of(customers.begin(), customers.end(),
-                        [&email, excludeCustomerId](const Customer &c)
-                        {
-                            return c.getCustomerId() != excludeCustomerId &&
-                                   Utils::toLower(c.getEmail()) == Utils::toLower(email);
-                        });
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return isEmailUniqueLocked(email, excludeCustomerId);
+}
+
+bool CustomerManager::isEmailUniqueLocked(const std::string &email, int excludeCustomerId) const
+{
+    auto it = emailIndex.find(Utils::toLower(email));
+    return it == emailIndex.end() || it->second == excludeCustomerId;
 }
 
 bool CustomerManager::isPhoneUnique(const std::string &phone, int excludeCustomerId)
 {
-    return std::none_of(customers.begin(), customers.end(),
-                        [&phone, excludeCustomerId](const Customer &c)
-                        {
-                            return c.getCustomerId() != excludeCustomerId && c.getPhone() == phone;
-                        });
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return isPhoneUniqueLocked(phone, excludeCustomerId);
+}
+
+bool CustomerManager::isPhoneUniqueLocked(const std::string &phone, int excludeCustomerId) const
+{
+    auto it = phoneIndex.find(phone);
+    return it == phoneIndex.end() || it->second == excludeCustomerId;
 }
 
 bool CustomerManager::validateCustomer(const Customer &customer)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return validateCustomerLocked(customer);
+}
+
+bool CustomerManager::validateCustomerLocked(const Customer &customer) const
 {
     if (!customer.isValid())
     {
         return false;
     }
 
-    if (!isEmailUnique(customer.getEmail(), customer.getCustomerId()))
+    if (!isEmailUniqueLocked(customer.getEmail(), customer.getCustomerId()))
     {
         LOG_WARNING("Email already exists: " + customer.getEmail());
         return false;
     }
 
-    if (!isPhoneUnique(customer.getPhone(), customer.getCustomerId()))
+    if (!isPhoneUniqueLocked(customer.getPhone(), customer.getCustomerId()))
     {
         LOG_WARNING("Phone number already exists: " + customer.getPhone());
         return false;
@@ -295,10 +484,41 @@ bool CustomerManager::validateCustomer(const Customer &customer)
 
 int CustomerManager::getTotalCustomers()
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return static_cast<int>(customers.size());
 }
 
+MemoryUsage CustomerManager::getMemoryUsage()
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    MemoryUsage usage;
+    usage.component = "customers";
+    usage.objects = customers.size();
+    usage.recordBytes = Memory::vectorHeapBytes(customers);
+    for (const auto &customer : customers)
+    {
+        customer.addHeapUsage(usage);
+    }
+
+    usage.indexBytes = Memory::hashTableBytes(emailIndex) + Memory::hashTableBytes(phoneIndex);
+    for (const auto &entry : emailIndex)
+    {
+        usage.indexBytes += Memory::stringHeapBytes(entry.first);
+    }
+    for (const auto &entry : phoneIndex)
+    {
+        usage.indexBytes += Memory::stringHeapBytes(entry.first);
+    }
+    return usage;
+}
+
 int CustomerManager::getActiveCustomersCount()
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return getActiveCustomersCountLocked();
+}
+
+int CustomerManager::getActiveCustomersCountLocked() const
 {
     return static_cast<int>(std::count_if(customers.begin(), customers.end(),
                                           [](const Customer &c)
@@ -307,11 +527,13 @@ int CustomerManager::getActiveCustomersCount()
 
 int CustomerManager::getInactiveCustomersCount()
 {
-    return getTotalCustomers() - getActiveCustomersCount();
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return static_cast<int>(customers.size()) - getActiveCustomersCountLocked();
 }
 
 std::vector<std::string> CustomerManager::getTopCities(int limit)
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     std::map<std::string, int> cityCount;
 
     for (const auto &customer : customers)
@@ -338,6 +560,7 @@ std::vector<std::string> CustomerManager::getTopCities(int limit)
 
 std::vector<std::string> CustomerManager::getTopCountries(int limit)
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     std::map<std::string, int> countryCount;
 
     for (const auto &customer : customers)
@@ -369,24 +592,111 @@ void CustomerManager::printCustomer(const Customer &customer)
 
 void CustomerManager::printAllCustomers()
 {
+    // A page at a time, so only one page is copied or locked at once
     Utils::printHeader("All Customers");
-    for (const auto &customer : customers)
+    Page<Customer> page;
+    page.hasMore = true;
+    while (page.hasMore)
     {
-        printCustomer(customer);
-        Utils::printSeparator('-', 50);
+        page = getCustomersPage(page.nextCursor, Scan::PRINT_PAGE_SIZE);
+        for (const auto &customer : page.items)
+        {
+            printCustomer(customer);
+            Utils::printSeparator('-', 50);
+        }
     }
 }
 
 bool CustomerManager::exportToCSV(const std::string &filename)
 {
-    // Implementation for CSV export
-    LOG_INFO("Exporting customers to CSV: " + filename);
-    return true;
+    return exportToFile(filename, Export::Options()).ok;
+}
+
+Export::Report CustomerManager::exportToFile(const std::string &filename, const Export::Options &options,
+                                             const Query &query)
+{
+    Export::Report report;
+    QueryPlan plan = queryEngine.plan(query);
+    if (!plan.valid)
+    {
+        report.error = plan.error;
+        LOG_ERROR("Cannot export customers to " + filename + ": " + report.error);
+        return report;
+    }
+
+    static const std::vector<std::string> columns = {"id", "name", "email", "phone",
+                                                     "address", "city", "country", "active"};
+    Export::Encode<Customer> encode = [](const Customer &c, Export::Encoder &out)
+    {
+        out.integer(c.getCustomerId());
+        out.text(c.getName());
+        out.text(c.getEmail());
+        out.text(c.getPhone());
+        out.text(c.getAddress());
+        out.text(c.getCity());
+        out.text(c.getCountry());
+        out.boolean(c.getIsActive());
+    };
+    {
+        std::shared_lock<std::shared_mutex> lock(dataMutex);
+        report = Export::write(filename, columns, customers,
+                               queryEngine.select(plan, customers, queryEngine.candidates(plan, customers.size())),
+                               encode, options);
+    }
+    if (report.ok)
+    {
+        LOG_INFO(report.summary() + " to " + filename);
+    }
+    else
+    {
+        LOG_ERROR("Cannot export customers to " + filename + ": " + report.error);
+    }
+    return report;
 }
 
 bool CustomerManager::importFromCSV(const std::string &filename)
 {
-    // Implementation for CSV import
-    LOG_INFO("Importing customers from CSV: " + filename);
-    return true;
-}
\ No newline at end of file
+    return importFromCSV(filename, Csv::ImportOptions()).ok;
+}
+
+Csv::ImportReport CustomerManager::importFromCSV(const std::string &filename, const Csv::ImportOptions &options)
+{
+    Csv::RowParser<Customer> parse = [](const Csv::Row &row, Customer &customer, std::string &error)
+    {
+        customer = Customer(0, row.get("name"), row.get("email"), row.get("phone"),
+                            row.get("address"), row.get("city"), row.get("country"));
+        bool active = true;
+        if (!row.getBool("active", active))
+        {
+            error = "active must be 1 or 0";
+            return false;
+        }
+        customer.setIsActive(active);
+        if (!customer.isValid())
+        {
+            error = "invalid customer data";
+            return false;
+        }
+        return true;
+    };
+
+    // Blocks are inserted as they are parsed and the file is saved once at the end
+    Csv::ImportReport report = Csv::import<Customer>(filename, {"name", "email", "phone", "address", "city", "country"},
+                                                     parse, [this](const std::vector<Customer> &batch)
+                                                     { return insertCustomers(batch); },
+                                                     options);
+    if (report.imported > 0)
+    {
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        saveCustomers();
+    }
+    if (report.ok)
+    {
+        LOG_INFO(report.summary() + " from " + filename);
+    }
+    else
+    {
+        LOG_ERROR("Cannot import customers from " + filename + ": " + report.error);
+    }
+    return report;
+}
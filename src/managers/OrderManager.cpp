@@ -2,51 +2,102 @@
 #include "managers/ProductManager.h"
 #include "managers/CustomerManager.h"
 #include "utils/Database.h"
+#include "utils/EventLog.h"
 #include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include "utils/Startup.h"
+#include "utils/Trace.h"
+#include "utils/Transaction.h"
 #include "utils/Utils.h"
 #include <algorithm>
 #include <iostream>
+#include <mutex>
+#include <unordered_set>
 
 OrderManager::OrderManager(ProductManager *prodMgr, CustomerManager *custMgr)
-    : nextOrderId(1), productManager(prodMgr), customerManager(custMgr)
+    : queryEngine("orders"), nextOrderId(1), productManager(prodMgr), customerManager(custMgr)
 {
+    setUpQueries();
     loadOrders();
+    if (productManager && productManager->reservationsNeedRebuild())
+    {
+        StartupPhase phase("orders.reconcile");
+        reconcileReservations();
+    }
 }
 
 OrderManager::~OrderManager()
 {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     saveOrders();
 }
 
 void OrderManager::loadOrders()
 {
+    METRIC_TIMER("order_load");
+    StartupPhase phase("orders.load");
     Database &db = Database::getInstance();
     std::vector<std::string> data = db.loadOrders();
 
-    orders.clear();
-    for (const auto &line : data)
+    std::vector<Order> loaded;
     {
-        if (!line.empty())
+        StartupPhase parsePhase("orders.parse");
+        for (const auto &line : data)
         {
-            Order order = Order::deserialize(line);
-            orders.push_back(order);
-
-            if (order.getOrderId() >= nextOrderId)
+            if (!line.empty())
             {
-                nextOrderId = order.getOrderId() + 1;
+                Order order = Order::deserialize(line);
+                loaded.push_back(order);
+
+                if (order.getOrderId() >= nextOrderId)
+                {
+                    nextOrderId = order.getOrderId() + 1;
+                }
             }
         }
+        parsePhase.setRecords(loaded.size());
+    }
+
+    // Paging relies on ascending ids, which only a hand-edited file would break
+    auto byId = [](const Order &a, const Order &b)
+    { return a.getOrderId() < b.getOrderId(); };
+    if (!std::is_sorted(loaded.begin(), loaded.end(), byId))
+    {
+        std::stable_sort(loaded.begin(), loaded.end(), byId);
+    }
+
+    orders.clear();
+    orders.reserve(loaded.size());
+    for (const auto &order : loaded)
+    {
+        orders.push_back(order);
     }
 
+    rebuildIndexLocked();
     LOG_INFO("Loaded " + std::to_string(orders.size()) + " orders");
 }
 
 void OrderManager::saveOrders()
 {
+    // In a transaction that defers saves, the file is written once at its commit
+    if (Transaction::deferSave(this, [this]
+                               {
+                                   std::shared_lock<std::shared_mutex> lock(dataMutex);
+                                   saveOrders(); }))
+    {
+        return;
+    }
+
+    METRIC_TIMER("order_save");
+    TRACE_SPAN("orders.save");
     std::vector<std::string> data;
-    for (const auto &order : orders)
     {
-        data.push_back(order.serialize());
+        TRACE_SPAN("orders.serialize");
+        data.reserve(orders.size());
+        for (const auto &order : orders)
+        {
+            data.push_back(order.serialize());
+        }
     }
 
     Database &db = Database::getInstance();
@@ -65,58 +116,439 @@ int OrderManager::generateNextId()
     return nextOrderId++;
 }
 
+void OrderManager::rebuildIndexLocked()
+{
+    StartupPhase phase("orders.index");
+    orderIndex.clear();
+    orderIndex.reserve(orders.size());
+    customerIndex.clear();
+    for (size_t i = 0; i < orders.size(); ++i)
+    {
+        orderIndex[orders[i].getOrderId()] = i;
+        customerIndex[orders[i].getCustomerId()].push_back(i);
+    }
+}
+
+namespace
+{
+    // Status names for queries, which need text that outlives the call
+    const std::string &statusName(OrderStatus status)
+    {
+        static const std::vector<std::string> names = []
+        {
+            std::vector<std::string> all;
+            for (int s = static_cast<int>(OrderStatus::PENDING); s <= static_cast<int>(OrderStatus::CANCELLED); ++s)
+            {
+                all.push_back(Order::statusToString(static_cast<OrderStatus>(s)));
+            }
+            return all;
+        }();
+        return names[static_cast<size_t>(status)];
+    }
+
+    // Index lookup for an integer key in an id -> positions map
+    template <typename Index>
+    const typename Index::mapped_type *findByNumber(const Index &index, const QueryValue &key)
+    {
+        const double *number = std::get_if<double>(&key);
+        if (!number || *number != static_cast<int>(*number))
+        {
+            return nullptr;
+        }
+        auto it = index.find(static_cast<int>(*number));
+        return it != index.end() ? &it->second : nullptr;
+    }
+}
+
+void OrderManager::setUpQueries()
+{
+    queryEngine.field("id", [](const Order &o)
+                      { return FieldValue(static_cast<double>(o.getOrderId())); })
+        .field("customer", [](const Order &o)
+               { return FieldValue(static_cast<double>(o.getCustomerId())); })
+        .field("customerName", [](const Order &o)
+               { return FieldValue(std::string_view(o.getCustomerName())); })
+        .field("status", [](const Order &o)
+               { return FieldValue(std::string_view(statusName(o.getStatus()))); })
+        .field("date", [](const Order &o)
+               { return FieldValue(std::string_view(o.getOrderDate())); })
+        .field("address", [](const Order &o)
+               { return FieldValue(std::string_view(o.getShippingAddress())); })
+        .field("notes", [](const Order &o)
+               { return FieldValue(std::string_view(o.getNotes())); })
+        .field("items", [](const Order &o)
+               { return FieldValue(static_cast<double>(o.getItems().size())); })
+        .field("total", [](const Order &o)
+               { return FieldValue(o.getTotalAmount()); })
+        .field("discount", [](const Order &o)
+               { return FieldValue(o.getDiscountAmount()); })
+        .field("final", [](const Order &o)
+               { return FieldValue(o.getFinalAmount()); });
+
+    // Lookups run under dataMutex, from query()
+    queryEngine.index("id", [this](const QueryValue &key, std::vector<size_t> &positions)
+                      {
+                          if (const size_t *position = findByNumber(orderIndex, key))
+                          {
+                              positions.push_back(*position);
+                          } })
+        .index("customer", [this](const QueryValue &key, std::vector<size_t> &positions)
+               {
+                   if (const std::vector<size_t> *found = findByNumber(customerIndex, key))
+                   {
+                       positions.insert(positions.end(), found->begin(), found->end());
+                   } });
+}
+
+void OrderManager::undoOrderOnAbort(int orderId, const Order *before)
+{
+    if (!Transaction::active())
+    {
+        return;
+    }
+
+    bool existed = before != nullptr;
+    Order snapshot = existed ? *before : Order();
+    Transaction::onAbort([this, orderId, existed, snapshot]
+                         {
+                             std::unique_lock<std::shared_mutex> lock(dataMutex);
+                             int index = indexOfOrderLocked(orderId);
+                             if (existed && index >= 0)
+                             {
+                                 orders.mutableAt(index) = snapshot;
+                             }
+                             else if (existed)
+                             {
+                                 // Back in id order, which paging relies on
+                                 size_t position = 0;
+                                 while (position < orders.size() && orders[position].getOrderId() < orderId)
+                                 {
+                                     ++position;
+                                 }
+                                 orders.insert(position, snapshot);
+                             }
+                             else if (index >= 0)
+                             {
+                                 orders.erase(index);
+                             }
+                             rebuildIndexLocked();
+                             saveOrders(); });
+}
+
 bool OrderManager::createOrder(int customerId)
 {
+    int orderId = 0;
+    return createOrder(customerId, orderId);
+}
+
+bool OrderManager::createOrder(int customerId, int &orderId)
+{
+    METRIC_TIMER("order_create");
     if (!customerManager)
     {
         LOG_ERROR("CustomerManager not set");
         return false;
     }
 
-    Customer *customer = customerManager->getCustomer(customerId);
-    if (!customer)
+    Customer customer;
+    if (!customerManager->getCustomerCopy(customerId, customer))
     {
         LOG_WARNING("Customer not found: " + std::to_string(customerId));
         return false;
     }
 
-    Order order(generateNextId(), customerId, customer->getName());
-    order.setShippingAddress(customer->getAddress() + ", " + customer->getCity() + ", " + customer->getCountry());
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Order order(generateNextId(), customerId, customer.getName());
+    order.setShippingAddress(customer.getAddress() + ", " + customer.getCity() + ", " + customer.getCountry());
 
     orders.push_back(order);
+    orderIndex[order.getOrderId()] = orders.size() - 1;
+    customerIndex[customerId].push_back(orders.size() - 1);
+    undoOrderOnAbort(order.getOrderId(), nullptr);
     saveOrders();
 
-    LOG_INFO("Created order " + std::to_string(order.getOrderId()) + " for customer " + std::to_string(customerId));
+    int createdId = order.getOrderId();
+    Transaction::afterCommit([createdId, customerId]
+                             {
+                                 Logger::getInstance().logOrderCreated(createdId, customerId);
+                                 EventLog::getInstance().recordOrderCreated(createdId, customerId); });
+    METRIC_INCREMENT("orders_created");
+    orderId = order.getOrderId();
     return true;
 }
 
+BatchResult OrderManager::addOrders(const std::vector<Order> &batch)
+{
+    BatchResult result = insertOrders(batch);
+    if (result.applied > 0)
+    {
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        saveOrders();
+    }
+    LOG_INFO("Added " + std::to_string(result.applied) + " of " + std::to_string(batch.size()) + " orders");
+    return result;
+}
+
+BatchResult OrderManager::insertOrders(const std::vector<Order> &batch)
+{
+    BatchResult result;
+    if (!customerManager || !productManager)
+    {
+        LOG_ERROR("CustomerManager or ProductManager not set");
+        for (size_t row = 0; row < batch.size(); ++row)
+        {
+            result.fail(row, "managers not set");
+        }
+        return result;
+    }
+
+    // Looked up before taking dataMutex, as createOrder and addItemToOrder do
+    std::vector<Order> ready;
+    ready.reserve(batch.size());
+    for (size_t row = 0; row < batch.size(); ++row)
+    {
+        const Order &source = batch[row];
+        Customer customer;
+        if (!customerManager->getCustomerCopy(source.getCustomerId(), customer))
+        {
+            result.fail(row, "customer not found: " + std::to_string(source.getCustomerId()));
+            continue;
+        }
+        if (source.getItems().empty())
+        {
+            result.fail(row, "order has no items");
+            continue;
+        }
+
+        Order order(0, customer.getCustomerId(), customer.getName());
+        order.setShippingAddress(!source.getShippingAddress().empty()
+                                     ? source.getShippingAddress()
+                                     : customer.getAddress() + ", " + customer.getCity() + ", " + customer.getCountry());
+        order.setNotes(source.getNotes());
+
+        std::string error;
+        for (const auto &item : source.getItems())
+        {
+            Product product;
+            if (item.quantity <= 0)
+            {
+                error = "quantity must be positive";
+            }
+            else if (!productManager->getProductCopy(item.productId, product))
+            {
+                error = "product not found: " + std::to_string(item.productId);
+            }
+            else if (!product.isInStock(itemQuantityLocked(order, item.productId) + item.quantity))
+            {
+                // Pending orders only need the stock to be available; it is reserved on confirm
+                error = "insufficient stock for product " + std::to_string(item.productId);
+            }
+            else
+            {
+                order.addItem(OrderItem(item.productId, product.getName(), item.quantity, product.getPrice()));
+                continue;
+            }
+            break;
+        }
+        if (!error.empty())
+        {
+            result.fail(row, error);
+            continue;
+        }
+        ready.push_back(std::move(order));
+    }
+
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    orders.reserve(orders.size() + ready.size());
+    for (auto &order : ready)
+    {
+        order.setOrderId(generateNextId());
+        orders.push_back(order);
+        orderIndex[order.getOrderId()] = orders.size() - 1;
+        customerIndex[order.getCustomerId()].push_back(orders.size() - 1);
+        undoOrderOnAbort(order.getOrderId(), nullptr);
+        Transaction::afterCommit([orderId = order.getOrderId(), customerId = order.getCustomerId()]
+                                 { EventLog::getInstance().recordOrderCreated(orderId, customerId); });
+    }
+    result.applied = ready.size();
+    return result;
+}
+
 Order *OrderManager::getOrder(int orderId)
 {
-    auto it = std::find_if(orders.begin(), orders.end(),
-                           [orderId](const Order &o)
-                           {
-                               return o.getOrderId() == orderId;
-                           });
+    // A lookup: the record may be shared with snapshots, so callers only read it
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return const_cast<Order *>(findOrderLocked(orderId));
+}
 
-    return (it != orders.end()) ? &(*it) : nullptr;
+bool OrderManager::getOrderCopy(int orderId, Order &order)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    const Order *found = findOrderLocked(orderId);
+    if (!found)
+    {
+        return false;
+    }
+    order = *found;
+    return true;
+}
+
+int OrderManager::itemQuantityLocked(const Order &order, int productId) const
+{
+    for (const auto &item : order.getItems())
+    {
+        if (item.productId == productId)
+        {
+            return item.quantity;
+        }
+    }
+    return 0;
+}
+
+bool OrderManager::holdsReservationLocked(const Order &order) const
+{
+    // Stock is reserved on confirm and leaves the ledger when the order ships
+    OrderStatus status = order.getStatus();
+    return status == OrderStatus::CONFIRMED || status == OrderStatus::PROCESSING;
+}
+
+std::vector<std::pair<int, int>> OrderManager::stockItemsOf(const Order &order)
+{
+    std::vector<std::pair<int, int>> items;
+    items.reserve(order.getItems().size());
+    for (const auto &item : order.getItems())
+    {
+        items.emplace_back(item.productId, item.quantity);
+    }
+    return items;
+}
+
+bool OrderManager::stockMoveForTransitionLocked(const Order &order, OrderStatus newStatus, StockMove &move) const
+{
+    bool held = holdsReservationLocked(order);
+    if (newStatus == OrderStatus::CONFIRMED && !held)
+    {
+        move = StockMove::RESERVE;
+        return true;
+    }
+    if (newStatus == OrderStatus::SHIPPED && held)
+    {
+        move = StockMove::COMMIT;
+        return true;
+    }
+    if (newStatus == OrderStatus::CANCELLED && held)
+    {
+        move = StockMove::RELEASE;
+        return true;
+    }
+    return false;
+}
+
+bool OrderManager::applyStockForTransitionLocked(const Order &order, OrderStatus newStatus)
+{
+    StockMove move;
+    if (!productManager || !stockMoveForTransitionLocked(order, newStatus, move))
+    {
+        return true;
+    }
+
+    switch (move)
+    {
+    case StockMove::RESERVE:
+        if (!productManager->reserveStock(stockItemsOf(order)))
+        {
+            LOG_WARNING("Cannot confirm order " + std::to_string(order.getOrderId()) + ": insufficient stock");
+            return false;
+        }
+        return true;
+    case StockMove::COMMIT:
+        return productManager->commitReservedStock(stockItemsOf(order));
+    case StockMove::RELEASE:
+        productManager->releaseReservedStock(stockItemsOf(order));
+        return true;
+    }
+    return true;
+}
+
+void OrderManager::reconcileReservations()
+{
+    if (!productManager)
+    {
+        return;
+    }
+
+    // Only needed once, for a products file written before the ledger existed:
+    // since then orders and reservations are committed together
+    std::map<int, int> reserved;
+    for (const auto &order : orders)
+    {
+        if (holdsReservationLocked(order))
+        {
+            for (const auto &item : order.getItems())
+            {
+                reserved[item.productId] += item.quantity;
+            }
+        }
+    }
+    productManager->reconcileReservations(reserved);
+}
+
+int OrderManager::indexOfOrderLocked(int orderId) const
+{
+    auto it = orderIndex.find(orderId);
+    return (it != orderIndex.end()) ? static_cast<int>(it->second) : -1;
+}
+
+const Order *OrderManager::findOrderLocked(int orderId) const
+{
+    int index = indexOfOrderLocked(orderId);
+    return index >= 0 ? &orders[index] : nullptr;
+}
+
+Order *OrderManager::mutableOrderLocked(int orderId)
+{
+    int index = indexOfOrderLocked(orderId);
+    return index >= 0 ? &orders.mutableAt(index) : nullptr;
+}
+
+OrderSnapshot OrderManager::getSnapshot() const
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return orders.snapshot();
+}
+
+size_t OrderManager::forEach(const Scan::Visitor<Order> &visitor, const Scan::Filter<Order> &filter,
+                             size_t limit) const
+{
+    OrderSnapshot view = getSnapshot();
+    return Scan::run(view, visitor, filter, limit);
 }
 
 std::vector<Order> OrderManager::getAllOrders()
 {
-    return orders;
+    OrderSnapshot view = getSnapshot();
+    return std::vector<Order>(view.begin(), view.end());
 }
 
-bool OrderManager::updateOrder(const Order &order)
+Page<Order> OrderManager::getOrdersPage(int afterId, size_t pageSize)
 {
-    auto it = std::find_if(orders.begin(), orders.end(),
-                           [&order](const Order &o)
-                           {
-                               return o.getOrderId() == order.getOrderId();
-                           });
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return Scan::page<Order>(orders, &Order::getOrderId, afterId, pageSize);
+}
 
-    if (it != orders.end())
+bool OrderManager::updateOrder(const Order &order)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    int index = indexOfOrderLocked(order.getOrderId());
+    if (index >= 0)
     {
-        *it = order;
+        Order before = orders[index];
+        orders.mutableAt(index) = order;
+        if (before.getCustomerId() != order.getCustomerId())
+        {
+            rebuildIndexLocked();
+        }
+        undoOrderOnAbort(order.getOrderId(), &before);
         saveOrders();
         LOG_INFO("Updated order: " + std::to_string(order.getOrderId()));
         return true;
@@ -127,16 +559,22 @@ bool OrderManager::updateOrder(const Order &order)
 
 bool OrderManager::deleteOrder(int orderId)
 {
-    auto it = std::find_if(orders.begin(), orders.end(),
-                           [orderId](const Order &o)
-                           {
-                               return o.getOrderId() == orderId;
-                           });
-
-    if (it != orders.end())
+    // Declared before the lock: an abort's undo actions run after it is released
+    Transaction transaction;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    int index = indexOfOrderLocked(orderId);
+    if (index >= 0)
     {
-        orders.erase(it);
+        const Order &order = orders[index];
+        if (productManager && holdsReservationLocked(order))
+        {
+            productManager->releaseReservedStock(stockItemsOf(order));
+        }
+        undoOrderOnAbort(orderId, &order);
+        orders.erase(index);
+        rebuildIndexLocked();
         saveOrders();
+        transaction.commit();
         LOG_INFO("Deleted order: " + std::to_string(orderId));
         return true;
     }
@@ -146,41 +584,181 @@ bool OrderManager::deleteOrder(int orderId)
 
 bool OrderManager::addItemToOrder(int orderId, int productId, int quantity)
 {
+    METRIC_TIMER("order_add_item");
     if (!productManager)
     {
         LOG_ERROR("ProductManager not set");
         return false;
     }
 
-    Order *order = getOrder(orderId);
-    Product *product = productManager->getProduct(productId);
+    Product product;
+    if (quantity <= 0 || !productManager->getProductCopy(productId, product))
+    {
+        return false;
+    }
 
-    if (!order || !product)
+    Transaction transaction;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Order *order = mutableOrderLocked(orderId);
+    if (!order)
     {
         return false;
     }
 
-    if (!product->isInStock(quantity))
+    if (holdsReservationLocked(*order))
     {
+        if (!productManager->reserveStock({{productId, quantity}}))
+        {
+            return false;
+        }
+    }
+    else if (!product.isInStock(itemQuantityLocked(*order, productId) + quantity))
+    {
+        // Pending orders only need the stock to be available; it is reserved on confirm
         LOG_WARNING("Insufficient stock for product " + std::to_string(productId));
         return false;
     }
 
-    OrderItem item(productId, product->getName(), quantity, product->getPrice());
+    Order before = *order;
+    OrderItem item(productId, product.getName(), quantity, product.getPrice());
     order->addItem(item);
 
+    undoOrderOnAbort(orderId, &before);
     saveOrders();
+    transaction.commit();
     LOG_INFO("Added item to order " + std::to_string(orderId) +
-             ": " + product->getName() + " x" + std::to_string(quantity));
+             ": " + product.getName() + " x" + std::to_string(quantity));
     return true;
 }
 
+BatchResult OrderManager::addItemsToOrder(int orderId, const std::vector<std::pair<int, int>> &items)
+{
+    BatchResult result;
+    auto failAll = [&result, &items](const std::string &reason)
+    {
+        for (size_t row = 0; row < items.size(); ++row)
+        {
+            result.fail(row, reason);
+        }
+        return result;
+    };
+    if (!productManager)
+    {
+        LOG_ERROR("ProductManager not set");
+        return failAll("product manager not set");
+    }
+
+    // Looked up before taking dataMutex, as addItemToOrder does
+    std::vector<Product> found(items.size());
+    std::vector<bool> valid(items.size(), false);
+    for (size_t row = 0; row < items.size(); ++row)
+    {
+        if (items[row].second <= 0)
+        {
+            result.fail(row, "quantity must be positive");
+        }
+        else if (!productManager->getProductCopy(items[row].first, found[row]))
+        {
+            result.fail(row, "product not found: " + std::to_string(items[row].first));
+        }
+        else
+        {
+            valid[row] = true;
+        }
+    }
+
+    Transaction transaction;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Order *order = mutableOrderLocked(orderId);
+    if (!order)
+    {
+        result.failures.clear();
+        return failAll("order not found: " + std::to_string(orderId));
+    }
+
+    if (holdsReservationLocked(*order))
+    {
+        std::vector<size_t> stockRows;
+        std::vector<std::vector<std::pair<int, int>>> stockGroups;
+        for (size_t row = 0; row < items.size(); ++row)
+        {
+            if (valid[row])
+            {
+                stockRows.push_back(row);
+                stockGroups.push_back({items[row]});
+            }
+        }
+        for (const auto &failure : productManager->moveStockEach(StockMove::RESERVE, stockGroups).failures)
+        {
+            valid[stockRows[failure.row]] = false;
+            result.fail(stockRows[failure.row], failure.reason);
+        }
+    }
+    else
+    {
+        // Pending orders only need the stock to be available, counting earlier rows
+        std::unordered_map<int, int> wanted;
+        for (size_t row = 0; row < items.size(); ++row)
+        {
+            if (!valid[row])
+            {
+                continue;
+            }
+            auto it = wanted.try_emplace(items[row].first, itemQuantityLocked(*order, items[row].first)).first;
+            if (!found[row].isInStock(it->second + items[row].second))
+            {
+                valid[row] = false;
+                result.fail(row, "insufficient stock for product " + std::to_string(items[row].first));
+                continue;
+            }
+            it->second += items[row].second;
+        }
+    }
+
+    Order before = *order;
+    for (size_t row = 0; row < items.size(); ++row)
+    {
+        if (valid[row])
+        {
+            order->addItem(OrderItem(items[row].first, found[row].getName(), items[row].second, found[row].getPrice()));
+            ++result.applied;
+        }
+    }
+    std::sort(result.failures.begin(), result.failures.end(),
+              [](const BatchResult::Failure &a, const BatchResult::Failure &b)
+              { return a.row < b.row; });
+
+    if (result.applied > 0)
+    {
+        undoOrderOnAbort(orderId, &before);
+        saveOrders();
+        transaction.commit();
+        LOG_INFO("Added " + std::to_string(result.applied) + " items to order " + std::to_string(orderId));
+    }
+    return result;
+}
+
 bool OrderManager::removeItemFromOrder(int orderId, int productId)
 {
-    Order *order = getOrder(orderId);
-    if (order && order->removeItem(productId))
+    Transaction transaction;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Order *order = mutableOrderLocked(orderId);
+    if (!order)
+    {
+        return false;
+    }
+
+    Order before = *order;
+    int quantity = itemQuantityLocked(*order, productId);
+    if (order->removeItem(productId))
     {
+        if (productManager && holdsReservationLocked(*order))
+        {
+            productManager->releaseReservedStock({{productId, quantity}});
+        }
+        undoOrderOnAbort(orderId, &before);
         saveOrders();
+        transaction.commit();
         LOG_INFO("Removed item from order " + std::to_string(orderId) +
                  ": product " + std::to_string(productId));
         return true;
@@ -190,10 +768,32 @@ bool OrderManager::removeItemFromOrder(int orderId, int productId)
 
 bool OrderManager::updateOrderItemQuantity(int orderId, int productId, int newQuantity)
 {
-    Order *order = getOrder(orderId);
-    if (order && order->updateItemQuantity(productId, newQuantity))
+    Transaction transaction;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Order *order = mutableOrderLocked(orderId);
+    if (!order)
     {
+        return false;
+    }
+
+    int oldQuantity = itemQuantityLocked(*order, productId);
+    int delta = std::max(newQuantity, 0) - oldQuantity;
+    bool adjustReservation = productManager && oldQuantity > 0 && holdsReservationLocked(*order);
+    if (adjustReservation && delta > 0 && !productManager->reserveStock({{productId, delta}}))
+    {
+        return false;
+    }
+
+    Order before = *order;
+    if (order->updateItemQuantity(productId, newQuantity))
+    {
+        if (adjustReservation && delta < 0)
+        {
+            productManager->releaseReservedStock({{productId, -delta}});
+        }
+        undoOrderOnAbort(orderId, &before);
         saveOrders();
+        transaction.commit();
         LOG_INFO("Updated item quantity in order " + std::to_string(orderId) +
                  ": product " + std::to_string(productId) + " to " + std::to_string(newQuantity));
         return true;
@@ -203,21 +803,127 @@ bool OrderManager::updateOrderItemQuantity(int orderId, int productId, int newQu
 
 bool OrderManager::updateOrderStatus(int orderId, OrderStatus newStatus)
 {
-    Order *order = getOrder(orderId);
-    if (order)
+    METRIC_TIMER("order_update_status");
+    // Status changes move reserved stock, so orders.txt and products.txt commit together
+    Transaction transaction;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    if (!updateOrderStatusLocked(orderId, newStatus))
+    {
+        return false;
+    }
+    transaction.commit();
+    return true;
+}
+
+bool OrderManager::updateOrderStatusLocked(int orderId, OrderStatus newStatus)
+{
+    const Order *current = findOrderLocked(orderId);
+    if (current && current->canChangeStatusTo(newStatus))
     {
-        std::string oldStatus = order->getStatusString();
-        if (order->updateStatus(newStatus))
+        Order *order = mutableOrderLocked(orderId);
+        if (!applyStockForTransitionLocked(*order, newStatus))
+        {
+            return false;
+        }
+
+        if (setStatusLocked(*order, newStatus))
         {
             saveOrders();
-            LOG_INFO("Updated order " + std::to_string(orderId) +
-                     " status from " + oldStatus + " to " + order->getStatusString());
             return true;
         }
     }
     return false;
 }
 
+bool OrderManager::setStatusLocked(Order &order, OrderStatus newStatus)
+{
+    Order before = order;
+    if (!order.updateStatus(newStatus))
+    {
+        return false;
+    }
+
+    undoOrderOnAbort(order.getOrderId(), &before);
+    Transaction::afterCommit([orderId = order.getOrderId(), oldStatus = before.getStatus(), newStatus,
+                              oldName = before.getStatusString(), newName = order.getStatusString()]
+                             {
+                                 Logger::getInstance().logOrderStatusChanged(orderId, oldName, newName);
+                                 EventLog::getInstance().recordOrderStatusChanged(orderId, static_cast<int>(oldStatus),
+                                                                                  static_cast<int>(newStatus)); });
+    return true;
+}
+
+BatchResult OrderManager::updateOrderStatuses(const std::vector<int> &orderIds, OrderStatus newStatus)
+{
+    BatchResult result;
+    Transaction transaction;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+
+    // Validate every row first, so the stock for all of them moves in one call
+    std::vector<size_t> rows;
+    std::vector<size_t> stockRows;
+    std::vector<std::vector<std::pair<int, int>>> stockGroups;
+    std::unordered_set<int> seen;
+    StockMove move = StockMove::RESERVE;
+    for (size_t row = 0; row < orderIds.size(); ++row)
+    {
+        const Order *order = findOrderLocked(orderIds[row]);
+        if (!order)
+        {
+            result.fail(row, "order not found: " + std::to_string(orderIds[row]));
+            continue;
+        }
+        if (!seen.insert(orderIds[row]).second)
+        {
+            result.fail(row, "order listed twice: " + std::to_string(orderIds[row]));
+            continue;
+        }
+        if (!order->canChangeStatusTo(newStatus))
+        {
+            result.fail(row, "cannot change status from " + order->getStatusString() + " to " +
+                                 Order::statusToString(newStatus));
+            continue;
+        }
+
+        // A given target status needs the same movement from every order that needs one
+        if (productManager && stockMoveForTransitionLocked(*order, newStatus, move))
+        {
+            stockRows.push_back(rows.size());
+            stockGroups.push_back(stockItemsOf(*order));
+        }
+        rows.push_back(row);
+    }
+
+    std::vector<bool> stockFailed(rows.size(), false);
+    if (!stockGroups.empty())
+    {
+        for (const auto &failure : productManager->moveStockEach(move, stockGroups).failures)
+        {
+            size_t index = stockRows[failure.row];
+            stockFailed[index] = true;
+            result.fail(rows[index], failure.reason);
+        }
+    }
+
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        if (!stockFailed[i] && setStatusLocked(*mutableOrderLocked(orderIds[rows[i]]), newStatus))
+        {
+            ++result.applied;
+        }
+    }
+    std::sort(result.failures.begin(), result.failures.end(),
+              [](const BatchResult::Failure &a, const BatchResult::Failure &b)
+              { return a.row < b.row; });
+
+    if (result.applied > 0)
+    {
+        saveOrders();
+        transaction.commit();
+    }
+    return result;
+}
+
 bool OrderManager::confirmOrder(int orderId)
 {
     return updateOrderStatus(orderId, OrderStatus::CONFIRMED);
@@ -245,25 +951,56 @@ bool OrderManager::cancelOrder(int orderId)
 
 std::vector<Order> OrderManager::getOrdersByCustomer(int customerId)
 {
-    std::vector<Order> results;
-    std::copy_if(orders.begin(), orders.end(),
-                 std::back_inserter(results),
-                 [customerId](const Order &o)
-                 {
-                     return o.getCustomerId() == customerId;
-                 });
-    return results;
+    return query(Query().where(Predicate::eq("customer", customerId)));
+}
+
+std::vector<Order> OrderManager::getOrdersByDateRange(const std::string &startDate, const std::string &endDate)
+{
+    // Order dates are "YYYY-MM-DD HH:MM:SS"; a bare end date covers the whole day
+    std::string end = endDate.size() == 10 ? endDate + " 23:59:59" : endDate;
+    return query(Query().where(Predicate::range("date", startDate, end)));
+}
+
+std::vector<Order> OrderManager::searchOrders(const std::string &searchTerm)
+{
+    return query(Query().where(Predicate::contains("customerName", searchTerm) ||
+                               Predicate::contains("address", searchTerm) ||
+                               Predicate::contains("notes", searchTerm)));
+}
+
+std::vector<Order> OrderManager::query(const Query &query)
+{
+    QueryPlan plan = queryEngine.plan(query);
+    if (!plan.valid)
+    {
+        LOG_WARNING("Invalid order query: " + plan.error);
+        return std::vector<Order>();
+    }
+
+    // Index positions are only valid against the version they were read with
+    OrderSnapshot view;
+    std::vector<size_t> candidates;
+    {
+        std::shared_lock<std::shared_mutex> lock(dataMutex);
+        view = orders.snapshot();
+        candidates = queryEngine.candidates(plan, view.size());
+    }
+    return queryEngine.execute(plan, view, std::move(candidates));
+}
+
+std::string OrderManager::explain(const Query &query) const
+{
+    return queryEngine.plan(query).toString();
 }
 
 std::vector<Order> OrderManager::getOrdersByStatus(OrderStatus status)
 {
     std::vector<Order> results;
-    std::copy_if(orders.begin(), orders.end(),
-                 std::back_inserter(results),
-                 [status](const Order &o)
-                 {
-                     return o.getStatus() == status;
-                 });
+    forEach(Scan::collectInto(results),
+            [status](const Order &o)
+            {
+                return o.getStatus() == status;
+            });
     return results;
 }
 
@@ -274,12 +1011,19 @@ bool OrderManager::validateOrder(const Order &order)
 
 bool OrderManager::canFulfillOrder(int orderId)
 {
-    Order *order = getOrder(orderId);
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    const Order *order = findOrderLocked(orderId);
     if (!order || !productManager)
     {
         return false;
     }
 
+    if (holdsReservationLocked(*order))
+    {
+        // Stock for every item is already reserved
+        return true;
+    }
+
     for (const auto &item : order->getItems())
     {
         if (!productManager->isProductAvailable(item.productId, item.quantity))
@@ -298,12 +1042,34 @@ bool OrderManager::checkProductAvailability(int productId, int quantity)
 
 int OrderManager::getTotalOrders()
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return static_cast<int>(orders.size());
 }
 
+MemoryUsage OrderManager::getMemoryUsage()
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    MemoryUsage usage;
+    usage.component = "orders";
+    usage.objects = orders.size();
+    usage.recordBytes = orders.storageBytes();
+    for (const auto &order : orders)
+    {
+        order.addHeapUsage(usage);
+    }
+
+    usage.indexBytes = Memory::hashTableBytes(orderIndex) + Memory::hashTableBytes(customerIndex);
+    for (const auto &entry : customerIndex)
+    {
+        usage.indexBytes += Memory::vectorHeapBytes(entry.second);
+    }
+    return usage;
+}
+
 int OrderManager::getOrdersByStatusCount(OrderStatus status)
 {
-    return static_cast<int>(std::count_if(orders.begin(), orders.end(),
+    OrderSnapshot view = getSnapshot();
+    return static_cast<int>(std::count_if(view.begin(), view.end(),
                                           [status](const Order &o)
                                           { return o.getStatus() == status; }));
 }
@@ -324,17 +1090,25 @@ void OrderManager::printOrderSummary(const Order &order)
 
 void OrderManager::printAllOrders()
 {
+    // A page at a time, so only one page is copied or locked at once
     Utils::printHeader("All Orders");
-    for (const auto &order : orders)
+    Page<Order> page;
+    page.hasMore = true;
+    while (page.hasMore)
     {
-        printOrderSummary(order);
+        page = getOrdersPage(page.nextCursor, Scan::PRINT_PAGE_SIZE);
+        for (const auto &order : page.items)
+        {
+            printOrderSummary(order);
+        }
     }
 }
 
 void OrderManager::printOrdersByStatus(OrderStatus status)
 {
+    OrderSnapshot view = getSnapshot();
     Utils::printHeader("Orders with status: " + Order::statusToString(status));
-    for (const auto &order : orders)
+    for (const auto &order : view)
     {
         if (order.getStatus() == status)
         {
@@ -344,8 +1118,6 @@ void OrderManager::printOrdersByStatus(OrderStatus status)
 }
 
 // Placeholder implementations
-std::vector<Order> OrderManager::getOrdersByDateRange(const std::string &startDate, const std::string &endDate) { return std::vector<Order>(); }
-std::vector<Order> OrderManager::searchOrders(const std::string &searchTerm) { return std::vector<Order>(); }
 bool OrderManager::applyDiscount(int orderId, double discountPercent) { return false; }
 bool OrderManager::applyFixedDiscount(int orderId, double discountAmount) { return false; }
 double OrderManager::calculateOrderTotal(int orderId) { return 0.0; }
@@ -361,5 +1133,124 @@ void OrderManager::generateCustomerOrderReport(int customerId) {}
 void OrderManager::generateProductSalesReport() {}
 void OrderManager::generateDailySalesReport(const std::string &date) {}
 void OrderManager::generateMonthlySalesReport(const std::string &month, const std::string &year) {}
-bool OrderManager::exportToCSV(const std::string &filename) { return false; }
-bool OrderManager::importFromCSV(const std::string &filename) { return false; }
\ No newline at end of file
+bool OrderManager::exportToCSV(const std::string &filename)
+{
+    return exportToFile(filename, Export::Options()).ok;
+}
+
+Export::Report OrderManager::exportToFile(const std::string &filename, const Export::Options &options,
+                                          const Query &query)
+{
+    Export::Report report;
+    QueryPlan plan = queryEngine.plan(query);
+    if (!plan.valid)
+    {
+        report.error = plan.error;
+        LOG_ERROR("Cannot export orders to " + filename + ": " + report.error);
+        return report;
+    }
+
+    OrderSnapshot view;
+    std::vector<size_t> candidates;
+    {
+        std::shared_lock<std::shared_mutex> lock(dataMutex);
+        view = orders.snapshot();
+        candidates = queryEngine.candidates(plan, view.size());
+    }
+
+    static const std::vector<std::string> columns = {"id", "customer", "customerName", "status", "date", "address",
+                                                     "notes", "items", "total", "discount", "final"};
+    Export::Encode<Order> encode = [](const Order &o, Export::Encoder &out)
+    {
+        // The same form importFromCSV reads back
+        std::string items;
+        for (const auto &item : o.getItems())
+        {
+            if (!items.empty())
+            {
+                items += ';';
+            }
+            items += std::to_string(item.productId) + ':' + std::to_string(item.quantity);
+        }
+
+        out.integer(o.getOrderId());
+        out.integer(o.getCustomerId());
+        out.text(o.getCustomerName());
+        out.text(statusName(o.getStatus()));
+        out.text(o.getOrderDate());
+        out.text(o.getShippingAddress());
+        out.text(o.getNotes());
+        out.text(items);
+        out.decimal(o.getTotalAmount());
+        out.decimal(o.getDiscountAmount());
+        out.decimal(o.getFinalAmount());
+    };
+    report = Export::write(filename, columns, view, queryEngine.select(plan, view, std::move(candidates)), encode,
+                           options);
+    if (report.ok)
+    {
+        LOG_INFO(report.summary() + " to " + filename);
+    }
+    else
+    {
+        LOG_ERROR("Cannot export orders to " + filename + ": " + report.error);
+    }
+    return report;
+}
+
+bool OrderManager::importFromCSV(const std::string &filename)
+{
+    return importFromCSV(filename, Csv::ImportOptions()).ok;
+}
+
+Csv::ImportReport OrderManager::importFromCSV(const std::string &filename, const Csv::ImportOptions &options)
+{
+    Csv::RowParser<Order> parse = [](const Csv::Row &row, Order &order, std::string &error)
+    {
+        int customerId = 0;
+        if (!row.getInt("customer", customerId))
+        {
+            error = "customer must be a number";
+            return false;
+        }
+
+        // Names and prices are filled in from the catalog by addOrders
+        order = Order(0, customerId, "");
+        order.setShippingAddress(row.get("address"));
+        order.setNotes(row.get("notes"));
+        for (const auto &entry : Utils::split(row.get("items"), ';'))
+        {
+            std::vector<std::string> parts = Utils::split(entry, ':');
+            int productId = 0;
+            int quantity = 0;
+            if (parts.size() != 2 || !Csv::parseInt(Utils::trim(parts[0]), productId) ||
+                !Csv::parseInt(Utils::trim(parts[1]), quantity))
+            {
+                error = "items must look like productId:quantity;productId:quantity";
+                return false;
+            }
+            order.addItem(OrderItem(productId, "", quantity, 0.0));
+        }
+        return true;
+    };
+
+    // Blocks are inserted as they are parsed and the file is saved once at the end
+    Csv::ImportReport report = Csv::import<Order>(filename, {"customer", "items"}, parse,
+                                                  [this](const std::vector<Order> &batch)
+                                                  { return insertOrders(batch); },
+                                                  options);
+    if (report.imported > 0)
+    {
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        saveOrders();
+    }
+    if (report.ok)
+    {
+        LOG_INFO(report.summary() + " from " + filename);
+    }
+    else
+    {
+        LOG_ERROR("Cannot import orders from " + filename + ": " + report.error);
+    }
+    return report;
+}
\ No newline at end of file
@@ -1,70 +1,251 @@
 #include "managers/ProductManager.h"
 #include "utils/Database.h"
+#include "utils/EventLog.h"
 #include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include "utils/Startup.h"
+#include "utils/Trace.h"
+#include "utils/Transaction.h"
 #include "utils/Utils.h"
 #include <algorithm>
 #include <iostream>
+#include <mutex>
 
-ProductManager::ProductManager() : nextProductId(1)
+ProductManager::ProductManager() : queryEngine("products"), nextProductId(1), legacyReservations(false),
+                                   savePending(false)
 {
+    setUpQueries();
     loadProducts();
 }
 
 ProductManager::~ProductManager()
 {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     saveProducts();
 }
 
 void ProductManager::loadProducts()
 {
+    StartupPhase phase("products.load");
     Database &db = Database::getInstance();
     std::vector<std::string> data = db.loadProducts();
 
-    products.clear();
-    for (const auto &line : data)
+    std::vector<Product> loaded;
+    legacyReservations = false;
     {
-        if (!line.empty())
+        StartupPhase parsePhase("products.parse");
+        for (const auto &line : data)
         {
-            Product product = Product::deserialize(line);
-            products.push_back(product);
-
-            if (product.getProductId() >= nextProductId)
+            if (!line.empty())
             {
-                nextProductId = product.getProductId() + 1;
+                // Files from before the reservation ledger have no reserved-quantity field
+                legacyReservations = legacyReservations || std::count(line.begin(), line.end(), '|') < 8;
+
+                Product product = Product::deserialize(line);
+                loaded.push_back(product);
+
+                if (product.getProductId() >= nextProductId)
+                {
+                    nextProductId = product.getProductId() + 1;
+                }
             }
         }
+        parsePhase.setRecords(loaded.size());
+    }
+
+    // Paging relies on ascending ids, which only a hand-edited file would break
+    auto byId = [](const Product &a, const Product &b)
+    { return a.getProductId() < b.getProductId(); };
+    if (!std::is_sorted(loaded.begin(), loaded.end(), byId))
+    {
+        std::stable_sort(loaded.begin(), loaded.end(), byId);
+    }
+
+    products.clear();
+    products.reserve(loaded.size());
+    for (const auto &product : loaded)
+    {
+        products.push_back(product);
     }
 
+    rebuildIndexLocked();
     LOG_INFO("Loaded " + std::to_string(products.size()) + " products");
 }
 
 void ProductManager::saveProducts()
 {
-    std::vector<std::string> data;
-    for (const auto &product : products)
+    // In a transaction that defers saves, the file is written once at its commit
+    if (Transaction::deferSave(this, [this]
+                               {
+                                   std::shared_lock<std::shared_mutex> lock(dataMutex);
+                                   saveProducts(); }))
     {
-        data.push_back(product.serialize());
+        return;
     }
 
+    METRIC_TIMER("product_save");
+    TRACE_SPAN("products.save");
     Database &db = Database::getInstance();
-    if (db.saveProducts(data))
+    if (db.inTransaction())
     {
-        LOG_INFO("Saved " + std::to_string(products.size()) + " products");
+        // Staged for this thread's commit, so it can't be handed to another saver.
+        // Stock can change under the shared lock while serializing, so the copy is
+        // numbered before it is taken.
+        std::uint64_t sequence = db.nextSaveSequence();
+        std::vector<std::string> data = serializeLocked();
+        db.saveProducts(data, sequence);
+        return;
     }
-    else
+
+    // Callers hold dataMutex (shared for stock updates, exclusive otherwise). If
+    // another thread is mid-save, leave the write to it: it rechecks savePending
+    // before giving up saveMutex and before returning.
+    savePending = true;
+    while (savePending)
+    {
+        std::unique_lock<std::mutex> saveLock(saveMutex, std::try_to_lock);
+        if (!saveLock.owns_lock())
+        {
+            return;
+        }
+
+        while (savePending.exchange(false))
+        {
+            std::uint64_t sequence = db.nextSaveSequence();
+            std::vector<std::string> data = serializeLocked();
+            if (db.saveProducts(data, sequence))
+            {
+                LOG_INFO("Saved " + std::to_string(products.size()) + " products");
+            }
+            else
+            {
+                LOG_ERROR("Failed to save products");
+            }
+        }
+    }
+}
+
+std::vector<std::string> ProductManager::serializeLocked() const
+{
+    TRACE_SPAN("products.serialize");
+    std::vector<std::string> data;
+    data.reserve(products.size());
+    for (const auto &product : products)
     {
-        LOG_ERROR("Failed to save products");
+        data.push_back(product.serialize());
+    }
+    return data;
+}
+
+void ProductManager::rebuildIndexLocked()
+{
+    StartupPhase phase("products.index");
+    productIndex.clear();
+    productIndex.reserve(products.size());
+    categoryIndex.clear();
+    nameIndex.clear();
+    nameIndex.reserve(products.size());
+    for (size_t i = 0; i < products.size(); ++i)
+    {
+        productIndex[products[i].getProductId()] = i;
+        categoryIndex[Utils::toLower(products[i].getCategory())].push_back(i);
+        nameIndex[Utils::toLower(products[i].getName())] = products[i].getProductId();
     }
 }
 
+void ProductManager::setUpQueries()
+{
+    queryEngine.field("id", [](const Product &p)
+                      { return FieldValue(static_cast<double>(p.getProductId())); })
+        .field("name", [](const Product &p)
+               { return FieldValue(std::string_view(p.getName())); })
+        .field("description", [](const Product &p)
+               { return FieldValue(std::string_view(p.getDescription())); })
+        .field("category", [](const Product &p)
+               { return FieldValue(std::string_view(p.getCategory())); })
+        .field("price", [](const Product &p)
+               { return FieldValue(p.getPrice()); })
+        .field("stock", [](const Product &p)
+               { return FieldValue(static_cast<double>(p.getStockQuantity())); })
+        .field("reserved", [](const Product &p)
+               { return FieldValue(static_cast<double>(p.getReservedQuantity())); })
+        .field("available", [](const Product &p)
+               { return FieldValue(static_cast<double>(p.getAvailableQuantity())); })
+        .field("minStock", [](const Product &p)
+               { return FieldValue(static_cast<double>(p.getMinStockLevel())); })
+        .field("active", [](const Product &p)
+               { return FieldValue(p.getIsActive() ? 1.0 : 0.0); });
+
+    // Lookups run under dataMutex, from query()
+    queryEngine.index("id", [this](const QueryValue &key, std::vector<size_t> &positions)
+                      {
+                          const double *id = std::get_if<double>(&key);
+                          auto it = id ? productIndex.find(static_cast<int>(*id)) : productIndex.end();
+                          if (it != productIndex.end() && it->first == *id)
+                          {
+                              positions.push_back(it->second);
+                          } })
+        .index("category", [this](const QueryValue &key, std::vector<size_t> &positions)
+               {
+                   const std::string *category = std::get_if<std::string>(&key);
+                   auto it = category ? categoryIndex.find(Utils::toLower(*category)) : categoryIndex.end();
+                   if (it != categoryIndex.end())
+                   {
+                       positions.insert(positions.end(), it->second.begin(), it->second.end());
+                   } });
+}
+
 int ProductManager::generateNextId()
 {
     return nextProductId++;
 }
 
+void ProductManager::undoStockOnAbort(const std::vector<std::pair<int, int>> &items,
+                                      int onHandSign, int reservedSign)
+{
+    if (!Transaction::active())
+    {
+        return;
+    }
+
+    Transaction::onAbort([this, items, onHandSign, reservedSign]
+                         {
+                             StockLock lock = lockForStockUpdate(items);
+                             for (const auto &item : items)
+                             {
+                                 Product *product = stockProductLocked(item.first);
+                                 if (!product || !product->adjustStock(-onHandSign * item.second,
+                                                                       -reservedSign * item.second))
+                                 {
+                                     LOG_WARNING("Cannot roll back stock change for product " +
+                                                 std::to_string(item.first));
+                                 }
+                             }
+                             lock.write.end();
+                             saveProducts(); });
+}
+
+void ProductManager::recordStockUpdate(int productId, int oldStock, int newStock, bool audit)
+{
+    Transaction::afterCommit([productId, oldStock, newStock, audit]
+                             {
+                                 if (audit)
+                                 {
+                                     Logger::getInstance().logProductStockUpdate(productId, oldStock, newStock);
+                                 }
+                                 EventLog::getInstance().recordStockUpdate(productId, oldStock, newStock); });
+}
+
 bool ProductManager::addProduct(const Product &product)
 {
-    if (!validateProduct(product))
+    int productId = 0;
+    return addProduct(product, productId);
+}
+
+bool ProductManager::addProduct(const Product &product, int &productId)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    if (!validateProductLocked(product))
     {
         return false;
     }
@@ -73,54 +254,185 @@ bool ProductManager::addProduct(const Product &product)
     newProduct.setProductId(generateNextId());
 
     products.push_back(newProduct);
+    productIndex[newProduct.getProductId()] = products.size() - 1;
+    categoryIndex[Utils::toLower(newProduct.getCategory())].push_back(products.size() - 1);
+    nameIndex[Utils::toLower(newProduct.getName())] = newProduct.getProductId();
     saveProducts();
 
+    productId = newProduct.getProductId();
     LOG_INFO("Added new product: " + newProduct.getName());
     return true;
 }
 
+BatchResult ProductManager::addProducts(const std::vector<Product> &batch)
+{
+    BatchResult result = insertProducts(batch);
+    if (result.applied > 0)
+    {
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        saveProducts();
+    }
+    LOG_INFO("Added " + std::to_string(result.applied) + " of " + std::to_string(batch.size()) + " products");
+    return result;
+}
+
+BatchResult ProductManager::insertProducts(const std::vector<Product> &batch)
+{
+    BatchResult result;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    products.reserve(products.size() + batch.size());
+    for (size_t row = 0; row < batch.size(); ++row)
+    {
+        if (!batch[row].isValid())
+        {
+            result.fail(row, "invalid product data");
+            continue;
+        }
+        // Against the name index, which also holds the rows added so far
+        if (!isProductNameUniqueLocked(batch[row].getName(), -1))
+        {
+            result.fail(row, "product name already exists: " + batch[row].getName());
+            continue;
+        }
+
+        Product newProduct = batch[row];
+        newProduct.setProductId(generateNextId());
+        products.push_back(newProduct);
+        productIndex[newProduct.getProductId()] = products.size() - 1;
+        categoryIndex[Utils::toLower(newProduct.getCategory())].push_back(products.size() - 1);
+        nameIndex[Utils::toLower(newProduct.getName())] = newProduct.getProductId();
+        ++result.applied;
+    }
+    return result;
+}
+
 Product *ProductManager::getProduct(int productId)
 {
-    auto it = std::find_if(products.begin(), products.end(),
-                           [productId](const Product &p)
-                           {
-                               return p.getProductId() == productId;
-                           });
+    // A lookup: the record may be shared with snapshots, so callers only read it
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return const_cast<Product *>(findProductLocked(productId));
+}
+
+bool ProductManager::getProductCopy(int productId, Product &product)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    const Product *found = findProductLocked(productId);
+    if (!found)
+    {
+        return false;
+    }
+    product = *found;
+    return true;
+}
 
-    return (it != products.end()) ? &(*it) : nullptr;
+int ProductManager::indexOfProductLocked(int productId) const
+{
+    auto it = productIndex.find(productId);
+    return (it != productIndex.end()) ? static_cast<int>(it->second) : -1;
+}
+
+const Product *ProductManager::findProductLocked(int productId) const
+{
+    int index = indexOfProductLocked(productId);
+    return index >= 0 ? &products[index] : nullptr;
+}
+
+Product *ProductManager::mutableProductLocked(int productId)
+{
+    int index = indexOfProductLocked(productId);
+    return index >= 0 ? &products.mutableAt(index) : nullptr;
+}
+
+Product *ProductManager::stockProductLocked(int productId)
+{
+    int index = indexOfProductLocked(productId);
+    return index >= 0 ? &products.inPlaceAt(index) : nullptr;
+}
+
+ProductManager::StockLock ProductManager::lockForStockUpdate(const std::vector<std::pair<int, int>> &items)
+{
+    while (true)
+    {
+        StockLock lock;
+        lock.lock = std::shared_lock<std::shared_mutex>(dataMutex);
+        lock.write = products.beginInPlace();
+        bool inPlace = std::all_of(items.begin(), items.end(),
+                                   [this](const std::pair<int, int> &item)
+                                   {
+                                       int index = indexOfProductLocked(item.first);
+                                       return index < 0 || products.canWriteInPlace(index);
+                                   });
+        if (inPlace)
+        {
+            return lock;
+        }
+
+        // A snapshot still sees some of these products: copy them, which needs the
+        // exclusive lock, then retry in case another snapshot was taken meanwhile
+        lock.write.end();
+        lock.lock.unlock();
+        std::unique_lock<std::shared_mutex> writeLock(dataMutex);
+        for (const auto &item : items)
+        {
+            mutableProductLocked(item.first);
+        }
+    }
+}
+
+ProductSnapshot ProductManager::getSnapshot() const
+{
+    // Stock updates write in place under the shared lock too; snapshot() waits for
+    // the ones in progress
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return products.snapshot();
+}
+
+size_t ProductManager::forEach(const Scan::Visitor<Product> &visitor, const Scan::Filter<Product> &filter,
+                               size_t limit) const
+{
+    ProductSnapshot view = getSnapshot();
+    return Scan::run(view, visitor, filter, limit);
 }
 
 std::vector<Product> ProductManager::getAllProducts()
 {
-    return products;
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return std::vector<Product>(products.begin(), products.end());
+}
+
+Page<Product> ProductManager::getProductsPage(int afterId, size_t pageSize)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return Scan::page<Product>(products, &Product::getProductId, afterId, pageSize);
 }
 
 std::vector<Product> ProductManager::getActiveProducts()
 {
     std::vector<Product> activeProducts;
-    std::copy_if(products.begin(), products.end(),
-                 std::back_inserter(activeProducts),
-                 [](const Product &p)
-                 { return p.getIsActive(); });
+    forEach(Scan::collectInto(activeProducts),
+            [](const Product &p)
+            { return p.getIsActive(); });
     return activeProducts;
 }
 
 bool ProductManager::updateProduct(const Product &product)
 {
-    auto it = std::find_if(products.begin(), products.end(),
-                           [&product](const Product &p)
-                           {
-                               return p.getProductId() == product.getProductId();
-                           });
-
-    if (it != products.end())
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    int index = indexOfProductLocked(product.getProductId());
+    if (index >= 0)
     {
-        if (!validateProduct(product))
+        if (!validateProductLocked(product))
         {
             return false;
         }
 
-        *it = product;
+        bool categoryChanged = Utils::toLower(products[index].getCategory()) != Utils::toLower(product.getCategory());
+        bool nameChanged = Utils::toLower(products[index].getName()) != Utils::toLower(product.getName());
+        products.mutableAt(index) = product;
+        if (categoryChanged || nameChanged)
+        {
+            rebuildIndexLocked();
+        }
         saveProducts();
         LOG_INFO("Updated product: " + product.getName());
         return true;
@@ -131,16 +443,13 @@ bool ProductManager::updateProduct(const Product &product)
 
 bool ProductManager::deleteProduct(int productId)
 {
-    auto it = std::find_if(products.begin(), products.end(),
-                           [productId](const Product &p)
-                           {
-                               return p.getProductId() == productId;
-                           });
-
-    if (it != products.end())
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    int index = indexOfProductLocked(productId);
+    if (index >= 0)
     {
-        std::string productName = it->getName();
-        products.erase(it);
+        std::string productName = products[index].getName();
+        products.erase(index);
+        rebuildIndexLocked();
         saveProducts();
         LOG_INFO("Deleted product: " + productName);
         return true;
@@ -150,13 +459,19 @@ bool ProductManager::deleteProduct(int productId)
 }
 
 bool ProductManager::validateProduct(const Product &product)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return validateProductLocked(product);
+}
+
+bool ProductManager::validateProductLocked(const Product &product) const
 {
     if (!product.isValid())
     {
         return false;
     }
 
-    if (!isProductNameUnique(product.getName(), product.getProductId()))
+    if (!isProductNameUniqueLocked(product.getName(), product.getProductId()))
     {
         LOG_WARNING("Product name already exists: " + product.getName());
         return false;
@@ -167,20 +482,54 @@ bool ProductManager::validateProduct(const Product &product)
 
 bool ProductManager::isProductNameUnique(const std::string &name, int excludeProductId)
 {
-    return std::none_of(products.begin(), products.end(),
-                        [&name, excludeProductId](const Product &p)
-                        {
-                            return p.getProductId() != excludeProductId &&
-                                   Utils::toLower(p.getName()) == Utils::toLower(name);
-                        });
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return isProductNameUniqueLocked(name, excludeProductId);
+}
+
+bool ProductManager::isProductNameUniqueLocked(const std::string &name, int excludeProductId) const
+{
+    auto it = nameIndex.find(Utils::toLower(name));
+    return it == nameIndex.end() || it->second == excludeProductId;
 }
 
 int ProductManager::getTotalProducts()
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return static_cast<int>(products.size());
 }
 
+MemoryUsage ProductManager::getMemoryUsage()
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    MemoryUsage usage;
+    usage.component = "products";
+    usage.objects = products.size();
+    usage.recordBytes = products.storageBytes();
+    for (const auto &product : products)
+    {
+        product.addHeapUsage(usage);
+    }
+
+    usage.indexBytes = Memory::hashTableBytes(productIndex) + Memory::hashTableBytes(categoryIndex) +
+                       Memory::hashTableBytes(nameIndex);
+    for (const auto &entry : categoryIndex)
+    {
+        usage.indexBytes += Memory::stringHeapBytes(entry.first) + Memory::vectorHeapBytes(entry.second);
+    }
+    for (const auto &entry : nameIndex)
+    {
+        usage.indexBytes += Memory::stringHeapBytes(entry.first);
+    }
+    return usage;
+}
+
 int ProductManager::getActiveProductsCount()
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return getActiveProductsCountLocked();
+}
+
+int ProductManager::getActiveProductsCountLocked() const
 {
     return static_cast<int>(std::count_if(products.begin(), products.end(),
                                           [](const Product &p)
@@ -189,7 +538,8 @@ int ProductManager::getActiveProductsCount()
 
 int ProductManager::getInactiveProductsCount()
 {
-    return getTotalProducts() - getActiveProductsCount();
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return static_cast<int>(products.size()) - getActiveProductsCountLocked();
 }
 
 void ProductManager::printProduct(const Product &product)
@@ -199,18 +549,26 @@ void ProductManager::printProduct(const Product &product)
 
 void ProductManager::printAllProducts()
 {
+    // A page at a time, so only one page is copied or locked at once
     Utils::printHeader("All Products");
-    for (const auto &product : products)
+    Page<Product> page;
+    page.hasMore = true;
+    while (page.hasMore)
     {
-        printProduct(product);
-        Utils::printSeparator('-', 50);
+        page = getProductsPage(page.nextCursor, Scan::PRINT_PAGE_SIZE);
+        for (const auto &product : page.items)
+        {
+            printProduct(product);
+            Utils::printSeparator('-', 50);
+        }
     }
 }
 
 // Basic implementations for other methods
 bool ProductManager::deactivateProduct(int productId)
 {
-    Product *product = getProduct(productId);
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Product *product = mutableProductLocked(productId);
     if (product)
     {
         product->setIsActive(false);
@@ -222,7 +580,8 @@ bool ProductManager::deactivateProduct(int productId)
 
 bool ProductManager::activateProduct(int productId)
 {
-    Product *product = getProduct(productId);
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Product *product = mutableProductLocked(productId);
     if (product)
     {
         product->setIsActive(true);
@@ -234,26 +593,86 @@ bool ProductManager::activateProduct(int productId)
 
 bool ProductManager::updateStock(int productId, int newQuantity)
 {
-    Product *product = getProduct(productId);
-    if (product)
+    METRIC_TIMER("product_update_stock");
+    // Exclusive so no concurrent reduceStock lands between reading and replacing the level
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    Product *product = mutableProductLocked(productId);
+    if (product && newQuantity >= 0)
     {
-        int oldStock = product->getStockQuantity();
-        product->setStockQuantity(newQuantity);
+        int oldStock = 0;
+        if (!product->setStockQuantity(newQuantity, &oldStock))
+        {
+            LOG_WARNING("Stock level " + std::to_string(newQuantity) + " for product " + std::to_string(productId) +
+                        " is below its reserved quantity");
+            return false;
+        }
+        undoStockOnAbort({{productId, newQuantity - oldStock}}, 1, 0);
         saveProducts();
-        LOG_INFO("Stock updated for product " + std::to_string(productId) +
-                 ": " + std::to_string(oldStock) + " -> " + std::to_string(newQuantity));
+        recordStockUpdate(productId, oldStock, newQuantity, true);
         return true;
     }
     return false;
 }
 
+BatchResult ProductManager::updateStocks(const std::vector<std::pair<int, int>> &levels)
+{
+    BatchResult result;
+    std::vector<std::pair<int, int>> changes; // product id, new - old
+    std::vector<int> oldLevels;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    for (size_t row = 0; row < levels.size(); ++row)
+    {
+        int productId = levels[row].first;
+        int newQuantity = levels[row].second;
+        if (newQuantity < 0)
+        {
+            result.fail(row, "negative stock level");
+            continue;
+        }
+        Product *product = mutableProductLocked(productId);
+        if (!product)
+        {
+            result.fail(row, "product not found: " + std::to_string(productId));
+            continue;
+        }
+
+        int oldStock = 0;
+        if (!product->setStockQuantity(newQuantity, &oldStock))
+        {
+            result.fail(row, "stock level below reserved quantity " + std::to_string(product->getReservedQuantity()));
+            continue;
+        }
+        oldLevels.push_back(oldStock);
+        changes.emplace_back(productId, newQuantity - oldStock);
+        ++result.applied;
+    }
+
+    if (changes.empty())
+    {
+        return result;
+    }
+    undoStockOnAbort(changes, 1, 0);
+    saveProducts();
+    for (size_t i = 0; i < changes.size(); ++i)
+    {
+        recordStockUpdate(changes[i].first, oldLevels[i], oldLevels[i] + changes[i].second, true);
+    }
+    return result;
+}
+
 bool ProductManager::addStock(int productId, int quantity)
 {
-    Product *product = getProduct(productId);
+    StockLock lock = lockForStockUpdate({{productId, quantity}});
+    Product *product = stockProductLocked(productId);
     if (product)
     {
-        product->addStock(quantity);
+        int oldStock = product->getStockQuantity();
+        product->addStock(quantity, &oldStock);
+        // Snapshots wait for the in-place change only, not for the save
+        lock.write.end();
+        undoStockOnAbort({{productId, std::max(quantity, 0)}}, 1, 0);
         saveProducts();
+        recordStockUpdate(productId, oldStock, oldStock + std::max(quantity, 0));
         return true;
     }
     return false;
@@ -261,10 +680,21 @@ bool ProductManager::addStock(int productId, int quantity)
 
 bool ProductManager::reduceStock(int productId, int quantity)
 {
-    Product *product = getProduct(productId);
-    if (product && product->reduceStock(quantity))
+    // Only the shared lock: the product's stock counter does the check-and-decrement
+    StockLock lock = lockForStockUpdate({{productId, quantity}});
+    Product *product = stockProductLocked(productId);
+    if (!product)
+    {
+        return false;
+    }
+
+    int oldStock = 0;
+    if (product->reduceStock(quantity, &oldStock))
     {
+        lock.write.end();
+        undoStockOnAbort({{productId, quantity}}, -1, 0);
         saveProducts();
+        recordStockUpdate(productId, oldStock, oldStock - quantity);
         return true;
     }
     return false;
@@ -273,85 +703,301 @@ bool ProductManager::reduceStock(int productId, int quantity)
 std::vector<Product> ProductManager::getLowStockProducts()
 {
     std::vector<Product> lowStock;
-    std::copy_if(products.begin(), products.end(),
-                 std::back_inserter(lowStock),
-                 [](const Product &p)
-                 { return p.isLowStock() && p.getIsActive(); });
+    forEach(Scan::collectInto(lowStock),
+            [](const Product &p)
+            { return p.isLowStock() && p.getIsActive(); });
     return lowStock;
 }
 
 std::vector<Product> ProductManager::getOutOfStockProducts()
 {
     std::vector<Product> outOfStock;
-    std::copy_if(products.begin(), products.end(),
-                 std::back_inserter(outOfStock),
-                 [](const Product &p)
-                 { return p.getStockQuantity() == 0 && p.getIsActive(); });
+    forEach(Scan::collectInto(outOfStock),
+            [](const Product &p)
+            { return p.getStockQuantity() == 0 && p.getIsActive(); });
     return outOfStock;
 }
 
 bool ProductManager::isProductAvailable(int productId, int quantity)
 {
-    Product *product = getProduct(productId);
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    const Product *product = findProductLocked(productId);
     return product && product->isInStock(quantity);
 }
 
+int ProductManager::getAvailableQuantity(int productId)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    const Product *product = findProductLocked(productId);
+    return product ? product->getAvailableQuantity() : 0;
+}
+
+bool ProductManager::reserveItemsLocked(const std::vector<std::pair<int, int>> &items)
+{
+    size_t reserved = 0;
+    for (; reserved < items.size(); ++reserved)
+    {
+        Product *product = stockProductLocked(items[reserved].first);
+        if (!product || !product->reserve(items[reserved].second))
+        {
+            break;
+        }
+    }
+
+    if (reserved < items.size())
+    {
+        for (size_t i = 0; i < reserved; ++i)
+        {
+            stockProductLocked(items[i].first)->releaseReservation(items[i].second);
+        }
+        LOG_WARNING("Insufficient stock to reserve product " + std::to_string(items[reserved].first));
+        return false;
+    }
+    return true;
+}
+
+bool ProductManager::commitItemsLocked(const std::vector<std::pair<int, int>> &items, std::vector<int> &previousStock)
+{
+    previousStock.assign(items.size(), 0);
+    size_t committed = 0;
+    for (; committed < items.size(); ++committed)
+    {
+        Product *product = stockProductLocked(items[committed].first);
+        if (!product || !product->commitReservation(items[committed].second, &previousStock[committed]))
+        {
+            break;
+        }
+    }
+
+    if (committed < items.size())
+    {
+        for (size_t i = 0; i < committed; ++i)
+        {
+            stockProductLocked(items[i].first)->adjustStock(items[i].second, items[i].second);
+        }
+        LOG_ERROR("No reservation to commit for product " + std::to_string(items[committed].first));
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::pair<int, int>> ProductManager::releaseItemsLocked(const std::vector<std::pair<int, int>> &items)
+{
+    std::vector<std::pair<int, int>> released;
+    for (const auto &item : items)
+    {
+        Product *product = stockProductLocked(item.first);
+        int quantity = product ? product->releaseReservation(item.second) : 0;
+        if (quantity > 0)
+        {
+            released.emplace_back(item.first, quantity);
+        }
+    }
+    return released;
+}
+
+bool ProductManager::reserveStock(const std::vector<std::pair<int, int>> &items)
+{
+    StockLock lock = lockForStockUpdate(items);
+    if (!reserveItemsLocked(items))
+    {
+        return false;
+    }
+
+    lock.write.end();
+    undoStockOnAbort(items, 0, 1);
+    saveProducts();
+    return true;
+}
+
+bool ProductManager::commitReservedStock(const std::vector<std::pair<int, int>> &items)
+{
+    StockLock lock = lockForStockUpdate(items);
+    std::vector<int> previousStock;
+    if (!commitItemsLocked(items, previousStock))
+    {
+        return false;
+    }
+
+    lock.write.end();
+    undoStockOnAbort(items, -1, -1);
+    saveProducts();
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        recordStockUpdate(items[i].first, previousStock[i], previousStock[i] - items[i].second);
+    }
+    return true;
+}
+
+void ProductManager::releaseReservedStock(const std::vector<std::pair<int, int>> &items)
+{
+    StockLock lock = lockForStockUpdate(items);
+    // Undo gives back only what was actually released
+    std::vector<std::pair<int, int>> released = releaseItemsLocked(items);
+    lock.write.end();
+    if (released.empty())
+    {
+        return;
+    }
+    undoStockOnAbort(released, 0, -1);
+    saveProducts();
+}
+
+BatchResult ProductManager::moveStockEach(StockMove move, const std::vector<std::vector<std::pair<int, int>>> &groups)
+{
+    std::vector<std::pair<int, int>> allItems;
+    for (const auto &group : groups)
+    {
+        allItems.insert(allItems.end(), group.begin(), group.end());
+    }
+
+    BatchResult result;
+    std::vector<std::pair<int, int>> moved;
+    std::vector<std::pair<std::pair<int, int>, int>> committed; // (product id, quantity), previous stock
+    StockLock lock = lockForStockUpdate(allItems);
+    for (size_t row = 0; row < groups.size(); ++row)
+    {
+        const auto &items = groups[row];
+        std::vector<int> previousStock;
+        std::vector<std::pair<int, int>> released;
+        switch (move)
+        {
+        case StockMove::RESERVE:
+            if (!reserveItemsLocked(items))
+            {
+                result.fail(row, "insufficient stock");
+                continue;
+            }
+            break;
+        case StockMove::COMMIT:
+            if (!commitItemsLocked(items, previousStock))
+            {
+                result.fail(row, "no reservation to commit");
+                continue;
+            }
+            for (size_t i = 0; i < items.size(); ++i)
+            {
+                committed.emplace_back(items[i], previousStock[i]);
+            }
+            break;
+        case StockMove::RELEASE:
+            released = releaseItemsLocked(items);
+            break;
+        }
+        // A release is undone by what it actually released
+        const auto &done = move == StockMove::RELEASE ? released : items;
+        moved.insert(moved.end(), done.begin(), done.end());
+        ++result.applied;
+    }
+
+    lock.write.end();
+    if (!moved.empty())
+    {
+        undoStockOnAbort(moved, move == StockMove::COMMIT ? -1 : 0, move == StockMove::RESERVE ? 1 : -1);
+        saveProducts();
+    }
+    for (const auto &entry : committed)
+    {
+        recordStockUpdate(entry.first.first, entry.second, entry.second - entry.first.second);
+    }
+    return result;
+}
+
+bool ProductManager::reservationsNeedRebuild()
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return legacyReservations;
+}
+
+int ProductManager::reconcileReservations(const std::map<int, int> &reserved)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+
+    int corrected = 0;
+    for (size_t i = 0; i < products.size(); ++i)
+    {
+        auto it = reserved.find(products[i].getProductId());
+        int expected = (it != reserved.end()) ? it->second : 0;
+        if (products[i].getReservedQuantity() != expected)
+        {
+            products.mutableAt(i).setReservedQuantity(expected);
+            ++corrected;
+        }
+    }
+
+    if (corrected > 0)
+    {
+        LOG_WARNING("Corrected stock reservations for " + std::to_string(corrected) + " products");
+    }
+    if (corrected > 0 || legacyReservations)
+    {
+        saveProducts();
+    }
+    legacyReservations = false;
+    return corrected;
+}
+
 std::vector<Product> ProductManager::searchByName(const std::string &name)
 {
+    METRIC_TIMER("product_search");
     std::vector<Product> results;
     std::string searchName = Utils::toLower(name);
 
-    std::copy_if(products.begin(), products.end(),
-                 std::back_inserter(results),
-                 [&searchName](const Product &p)
-                 {
-                     return Utils::toLower(p.getName()).find(searchName) != std::string::npos;
-                 });
+    forEach(Scan::collectInto(results),
+            [&searchName](const Product &p)
+            {
+                return Utils::toLower(p.getName()).find(searchName) != std::string::npos;
+            });
 
     return results;
 }
 
 std::vector<Product> ProductManager::getProductsByCategory(const std::string &category)
 {
-    std::vector<Product> results;
-    std::string searchCategory = Utils::toLower(category);
-
-    std::copy_if(products.begin(), products.end(),
-                 std::back_inserter(results),
-                 [&searchCategory](const Product &p)
-                 {
-                     return Utils::toLower(p.getCategory()) == searchCategory;
-                 });
-
-    return results;
+    return query(Query().where(Predicate::eq("category", category)));
 }
 
 std::vector<Product> ProductManager::getProductsByPriceRange(double minPrice, double maxPrice)
+{
+    return query(Query().where(Predicate::range("price", minPrice, maxPrice)));
+}
+
+std::vector<Product> ProductManager::getProductsInStock()
 {
     std::vector<Product> results;
 
-    std::copy_if(products.begin(), products.end(),
-                 std::back_inserter(results),
-                 [minPrice, maxPrice](const Product &p)
-                 {
-                     return p.getPrice() >= minPrice && p.getPrice() <= maxPrice;
+    forEach(Scan::collectInto(results),
+            [](const Product &p)
+            {
+                return p.getStockQuantity() > 0 && p.getIsActive();
                  });
 
     return results;
 }
 
-std::vector<Product> ProductManager::getProductsInStock()
+std::vector<Product> ProductManager::query(const Query &query)
 {
-    std::vector<Product> results;
+    QueryPlan plan = queryEngine.plan(query);
+    if (!plan.valid)
+    {
+        LOG_WARNING("Invalid product query: " + plan.error);
+        return std::vector<Product>();
+    }
 
-    std::copy_if(products.begin(), products.end(),
-                 std::back_inserter(results),
-                 [](const Product &p)
-                 {
-                     return p.getStockQuantity() > 0 && p.getIsActive();
-                 });
+    // Index positions are only valid against the version they were read with
+    ProductSnapshot view;
+    std::vector<size_t> candidates;
+    {
+        std::shared_lock<std::shared_mutex> lock(dataMutex);
+        view = products.snapshot();
+        candidates = queryEngine.candidates(plan, view.size());
+    }
+    return queryEngine.execute(plan, view, std::move(candidates));
+}
 
-    return results;
+std::string ProductManager::explain(const Query &query) const
+{
+    return queryEngine.plan(query).toString();
 }
 
 // Placeholder implementations
@@ -367,5 +1013,110 @@ void ProductManager::generateInventoryReport() {}
 void ProductManager::generateLowStockReport() {}
 void ProductManager::generateCategoryReport() {}
 void ProductManager::printProductsTable() {}
-bool ProductManager::exportToCSV(const std::string &filename) { return false; }
-bool ProductManager::importFromCSV(const std::string &filename) { return false; }
\ No newline at end of file
+bool ProductManager::exportToCSV(const std::string &filename)
+{
+    return exportToFile(filename, Export::Options()).ok;
+}
+
+Export::Report ProductManager::exportToFile(const std::string &filename, const Export::Options &options,
+                                            const Query &query)
+{
+    Export::Report report;
+    QueryPlan plan = queryEngine.plan(query);
+    if (!plan.valid)
+    {
+        report.error = plan.error;
+        LOG_ERROR("Cannot export products to " + filename + ": " + report.error);
+        return report;
+    }
+
+    ProductSnapshot view;
+    std::vector<size_t> candidates;
+    {
+        std::shared_lock<std::shared_mutex> lock(dataMutex);
+        view = products.snapshot();
+        candidates = queryEngine.candidates(plan, view.size());
+    }
+
+    static const std::vector<std::string> columns = {"id", "name", "description", "category", "price",
+                                                     "stock", "reserved", "minStock", "active"};
+    Export::Encode<Product> encode = [](const Product &p, Export::Encoder &out)
+    {
+        out.integer(p.getProductId());
+        out.text(p.getName());
+        out.text(p.getDescription());
+        out.text(p.getCategory());
+        out.decimal(p.getPrice());
+        out.integer(p.getStockQuantity());
+        out.integer(p.getReservedQuantity());
+        out.integer(p.getMinStockLevel());
+        out.boolean(p.getIsActive());
+    };
+    report = Export::write(filename, columns, view, queryEngine.select(plan, view, std::move(candidates)), encode,
+                           options);
+    if (report.ok)
+    {
+        LOG_INFO(report.summary() + " to " + filename);
+    }
+    else
+    {
+        LOG_ERROR("Cannot export products to " + filename + ": " + report.error);
+    }
+    return report;
+}
+
+bool ProductManager::importFromCSV(const std::string &filename)
+{
+    return importFromCSV(filename, Csv::ImportOptions()).ok;
+}
+
+Csv::ImportReport ProductManager::importFromCSV(const std::string &filename, const Csv::ImportOptions &options)
+{
+    Csv::RowParser<Product> parse = [](const Csv::Row &row, Product &product, std::string &error)
+    {
+        double price = 0.0;
+        int stock = 0;
+        int minStock = 0;
+        bool active = true;
+        if (!row.getDouble("price", price) || !row.getInt("stock", stock))
+        {
+            error = "price and stock must be numbers";
+            return false;
+        }
+        if ((!row.isEmpty("minStock") && !row.getInt("minStock", minStock)) ||
+            !row.getBool("active", active))
+        {
+            error = "minStock must be a number and active 1 or 0";
+            return false;
+        }
+
+        product = Product(0, row.get("name"), row.get("description"), row.get("category"), price, stock, minStock);
+        product.setIsActive(active);
+        if (!product.isValid())
+        {
+            error = "invalid product data";
+            return false;
+        }
+        return true;
+    };
+
+    // Blocks are inserted as they are parsed and the file is saved once at the end
+    Csv::ImportReport report = Csv::import<Product>(filename, {"name", "category", "price", "stock"}, parse,
+                                                    [this](const std::vector<Product> &batch)
+                                                    { return insertProducts(batch); },
+                                                    options);
+    if (report.imported > 0)
+    {
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        saveProducts();
+    }
+    if (report.ok)
+    {
+        LOG_INFO(report.summary() + " from " + filename);
+    }
+    else
+    {
+        LOG_ERROR("Cannot import products from " + filename + ": " + report.error);
+    }
+    return report;
+}
\ No newline at end of file
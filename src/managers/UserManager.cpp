@@ -1,11 +1,18 @@
 #include "managers/UserManager.h"
 #include "utils/Database.h"
+#include "utils/EventLog.h"
 #include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include "utils/Startup.h"
+#include "utils/Trace.h"
+#include "utils/Transaction.h"
 #include "utils/Utils.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <mutex>
+#include <numeric>
 
 UserManager::UserManager() : nextUserId(1), currentUser(nullptr)
 {
@@ -18,11 +25,13 @@ UserManager::UserManager() : nextUserId(1), currentUser(nullptr)
 
 UserManager::~UserManager()
 {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     saveUsers();
 }
 
 void UserManager::loadUsers()
 {
+    StartupPhase phase("users.load");
     Database &db = Database::getInstance();
     std::vector<std::string> data = db.loadUsers();
 
@@ -47,6 +56,17 @@ void UserManager::loadUsers()
 
 void UserManager::saveUsers()
 {
+    // In a transaction that defers saves, the file is written once at its commit
+    if (Transaction::deferSave(this, [this]
+                               {
+                                   std::shared_lock<std::shared_mutex> lock(dataMutex);
+                                   saveUsers(); }))
+    {
+        return;
+    }
+
+    METRIC_TIMER("user_save");
+    TRACE_SPAN("users.save");
     std::vector<std::string> data;
     for (const auto &user : users)
     {
@@ -83,6 +103,8 @@ void UserManager::createDefaultAdmin()
 
 bool UserManager::login(const std::string &username, const std::string &password)
 {
+    METRIC_TIMER("user_login");
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     auto it = std::find_if(users.begin(), users.end(),
                            [&username](const User &u)
                            {
@@ -94,26 +116,44 @@ bool UserManager::login(const std::string &username, const std::string &password
         currentUser = &(*it);
         currentUser->updateLastLogin();
         saveUsers(); // Save updated last login time
-        LOG_INFO("User logged in: " + username);
+        Logger::getInstance().logUserLogin(username);
+        EventLog::getInstance().recordUserLogin(currentUser->getUsername());
+        METRIC_INCREMENT("logins");
         return true;
     }
 
+    METRIC_INCREMENT("login_failures");
     LOG_WARNING("Failed login attempt for: " + username);
     return false;
 }
 
 void UserManager::logout()
 {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     if (currentUser)
     {
-        LOG_INFO("User logged out: " + currentUser->getUsername());
+        Logger::getInstance().logUserLogout(currentUser->getUsername());
+        EventLog::getInstance().recordUserLogout(currentUser->getUsername());
         currentUser = nullptr;
     }
 }
 
+bool UserManager::isLoggedIn() const
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return currentUser != nullptr;
+}
+
+User *UserManager::getCurrentUser() const
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return currentUser;
+}
+
 bool UserManager::addUser(const User &user)
 {
-    if (!validateUser(user))
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    if (!validateUserLocked(user))
     {
         LOG_WARNING("Invalid user data");
         return false;
@@ -131,6 +171,12 @@ bool UserManager::addUser(const User &user)
 }
 
 User *UserManager::getUser(int userId)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return findUserLocked(userId);
+}
+
+User *UserManager::findUserLocked(int userId)
 {
     auto it = std::find_if(users.begin(), users.end(),
                            [userId](const User &u)
@@ -143,6 +189,7 @@ User *UserManager::getUser(int userId)
 
 User *UserManager::getUserByUsername(const std::string &username)
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     auto it = std::find_if(users.begin(), users.end(),
                            [&username](const User &u)
                            {
@@ -152,23 +199,31 @@ User *UserManager::getUserByUsername(const std::string &username)
     return (it != users.end()) ? &(*it) : nullptr;
 }
 
+size_t UserManager::forEach(const Scan::Visitor<User> &visitor, const Scan::Filter<User> &filter,
+                            size_t limit) const
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return Scan::run(users, visitor, filter, limit);
+}
+
 std::vector<User> UserManager::getAllUsers()
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return users;
 }
 
 std::vector<User> UserManager::getActiveUsers()
 {
     std::vector<User> activeUsers;
-    std::copy_if(users.begin(), users.end(),
-                 std::back_inserter(activeUsers),
-                 [](const User &u)
-                 { return u.getIsActive(); });
+    forEach(Scan::collectInto(activeUsers),
+            [](const User &u)
+            { return u.getIsActive(); });
     return activeUsers;
 }
 
 bool UserManager::updateUser(const User &user)
 {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     auto it = std::find_if(users.begin(), users.end(),
                            [&user](const User &u)
                            {
@@ -177,7 +232,7 @@ bool UserManager::updateUser(const User &user)
 
     if (it != users.end())
     {
-        if (!validateUser(user))
+        if (!validateUserLocked(user))
         {
             return false;
         }
@@ -204,6 +259,7 @@ bool UserManager::updateUser(const User &user)
 
 bool UserManager::deleteUser(int userId)
 {
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
     auto it = std::find_if(users.begin(), users.end(),
                            [userId](const User &u)
                            {
@@ -219,7 +275,7 @@ bool UserManager::deleteUser(int userId)
             return false;
         }
 
-        if (it->getRole() == UserRole::ADMIN && getUserCountByRole(UserRole::ADMIN) <= 1)
+        if (it->getRole() == UserRole::ADMIN && getUserCountByRoleLocked(UserRole::ADMIN) <= 1)
         {
             LOG_WARNING("Cannot delete last admin user");
             return false;
@@ -237,7 +293,8 @@ bool UserManager::deleteUser(int userId)
 
 bool UserManager::deactivateUser(int userId)
 {
-    User *user = getUser(userId);
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    User *user = findUserLocked(userId);
     if (user)
     {
         // Don't allow deactivation of current user or last admin
@@ -246,7 +303,7 @@ bool UserManager::deactivateUser(int userId)
             return false;
         }
 
-        if (user->getRole() == UserRole::ADMIN && getUserCountByRole(UserRole::ADMIN) <= 1)
+        if (user->getRole() == UserRole::ADMIN && getUserCountByRoleLocked(UserRole::ADMIN) <= 1)
         {
             return false;
         }
@@ -261,7 +318,8 @@ bool UserManager::deactivateUser(int userId)
 
 bool UserManager::activateUser(int userId)
 {
-    User *user = getUser(userId);
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    User *user = findUserLocked(userId);
     if (user)
     {
         user->setIsActive(true);
@@ -274,7 +332,8 @@ bool UserManager::activateUser(int userId)
 
 bool UserManager::changePassword(int userId, const std::string &oldPassword, const std::string &newPassword)
 {
-    User *user = getUser(userId);
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    User *user = findUserLocked(userId);
     if (user && user->verifyPassword(oldPassword))
     {
         if (validatePassword(newPassword))
@@ -290,7 +349,8 @@ bool UserManager::changePassword(int userId, const std::string &oldPassword, con
 
 bool UserManager::resetPassword(int userId, const std::string &newPassword)
 {
-    User *user = getUser(userId);
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    User *user = findUserLocked(userId);
     if (user && validatePassword(newPassword))
     {
         user->setPassword(Utils::hashPassword(newPassword));
@@ -308,13 +368,14 @@ bool UserManager::validatePassword(const std::string &password)
 
 bool UserManager::changeUserRole(int userId, UserRole newRole)
 {
-    User *user = getUser(userId);
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    User *user = findUserLocked(userId);
     if (user)
     {
         // Don't allow changing role of last admin
         if (user->getRole() == UserRole::ADMIN &&
             newRole != UserRole::ADMIN &&
-            getUserCountByRole(UserRole::ADMIN) <= 1)
+            getUserCountByRoleLocked(UserRole::ADMIN) <= 1)
         {
             return false;
         }
@@ -330,10 +391,9 @@ bool UserManager::changeUserRole(int userId, UserRole newRole)
 std::vector<User> UserManager::getUsersByRole(UserRole role)
 {
     std::vector<User> result;
-    std::copy_if(users.begin(), users.end(),
-                 std::back_inserter(result),
-                 [role](const User &u)
-                 { return u.getRole() == role; });
+    forEach(Scan::collectInto(result),
+            [role](const User &u)
+            { return u.getRole() == role; });
     return result;
 }
 
@@ -342,12 +402,11 @@ std::vector<User> UserManager::searchByUsername(const std::string &username)
     std::vector<User> results;
     std::string searchUsername = Utils::toLower(username);
 
-    std::copy_if(users.begin(), users.end(),
-                 std::back_inserter(results),
-                 [&searchUsername](const User &u)
-                 {
-                     return Utils::toLower(u.getUsername()).find(searchUsername) != std::string::npos;
-                 });
+    forEach(Scan::collectInto(results),
+            [&searchUsername](const User &u)
+            {
+                return Utils::toLower(u.getUsername()).find(searchUsername) != std::string::npos;
+            });
 
     return results;
 }
@@ -357,12 +416,11 @@ std::vector<User> UserManager::searchByFullName(const std::string &fullName)
     std::vector<User> results;
     std::string searchName = Utils::toLower(fullName);
 
-    std::copy_if(users.begin(), users.end(),
-                 std::back_inserter(results),
-                 [&searchName](const User &u)
-                 {
-                     return Utils::toLower(u.getFullName()).find(searchName) != std::string::npos;
-                 });
+    forEach(Scan::collectInto(results),
+            [&searchName](const User &u)
+            {
+                return Utils::toLower(u.getFullName()).find(searchName) != std::string::npos;
+            });
 
     return results;
 }
@@ -372,17 +430,22 @@ std::vector<User> UserManager::searchByEmail(const std::string &email)
     std::vector<User> results;
     std::string searchEmail = Utils::toLower(email);
 
-    std::copy_if(users.begin(), users.end(),
-                 std::back_inserter(results),
-                 [&searchEmail](const User &u)
-                 {
-                     return Utils::toLower(u.getEmail()).find(searchEmail) != std::string::npos;
-                 });
+    forEach(Scan::collectInto(results),
+            [&searchEmail](const User &u)
+            {
+                return Utils::toLower(u.getEmail()).find(searchEmail) != std::string::npos;
+            });
 
     return results;
 }
 
 bool UserManager::isUsernameUnique(const std::string &username, int excludeUserId)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return isUsernameUniqueLocked(username, excludeUserId);
+}
+
+bool UserManager::isUsernameUniqueLocked(const std::string &username, int excludeUserId) const
 {
     return std::none_of(users.begin(), users.end(),
                         [&username, excludeUserId](const User &u)
@@ -393,6 +456,12 @@ bool UserManager::isUsernameUnique(const std::string &username, int excludeUserI
 }
 
 bool UserManager::isEmailUnique(const std::string &email, int excludeUserId)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return isEmailUniqueLocked(email, excludeUserId);
+}
+
+bool UserManager::isEmailUniqueLocked(const std::string &email, int excludeUserId) const
 {
     return std::none_of(users.begin(), users.end(),
                         [&email, excludeUserId](const User &u)
@@ -403,19 +472,25 @@ bool UserManager::isEmailUnique(const std::string &email, int excludeUserId)
 }
 
 bool UserManager::validateUser(const User &user)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return validateUserLocked(user);
+}
+
+bool UserManager::validateUserLocked(const User &user) const
 {
     if (!user.isValid())
     {
         return false;
     }
 
-    if (!isUsernameUnique(user.getUsername(), user.getUserId()))
+    if (!isUsernameUniqueLocked(user.getUsername(), user.getUserId()))
     {
         LOG_WARNING("Username already exists: " + user.getUsername());
         return false;
     }
 
-    if (!isEmailUnique(user.getEmail(), user.getUserId()))
+    if (!isEmailUniqueLocked(user.getEmail(), user.getUserId()))
     {
         LOG_WARNING("Email already exists: " + user.getEmail());
         return false;
@@ -426,6 +501,7 @@ bool UserManager::validateUser(const User &user)
 
 bool UserManager::hasPermission(const std::string &operation) const
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     if (!currentUser)
         return false;
 
@@ -447,37 +523,63 @@ bool UserManager::hasPermission(const std::string &operation) const
 
 bool UserManager::canManageUsers() const
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return currentUser && currentUser->canManageUsers();
 }
 
 bool UserManager::canManageProducts() const
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return currentUser && currentUser->canManageProducts();
 }
 
 bool UserManager::canManageOrders() const
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return currentUser && currentUser->canManageOrders();
 }
 
 bool UserManager::canViewReports() const
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return currentUser && currentUser->canViewReports();
 }
 
 int UserManager::getTotalUsers()
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return static_cast<int>(users.size());
 }
 
+MemoryUsage UserManager::getMemoryUsage()
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    MemoryUsage usage;
+    usage.component = "users";
+    usage.objects = users.size();
+    usage.recordBytes = Memory::vectorHeapBytes(users);
+    for (const auto &user : users)
+    {
+        user.addHeapUsage(usage);
+    }
+    return usage;
+}
+
 int UserManager::getActiveUsersCount()
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     return static_cast<int>(std::count_if(users.begin(), users.end(),
                                           [](const User &u)
                                           { return u.getIsActive(); }));
 }
 
 int UserManager::getUserCountByRole(UserRole role)
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return getUserCountByRoleLocked(role);
+}
+
+int UserManager::getUserCountByRoleLocked(UserRole role) const
 {
     return static_cast<int>(std::count_if(users.begin(), users.end(),
                                           [role](const User &u)
@@ -524,6 +626,7 @@ void UserManager::printUser(const User &user)
 
 void UserManager::printAllUsers()
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     Utils::printHeader("All Users");
     for (const auto &user : users)
     {
@@ -534,6 +637,7 @@ void UserManager::printAllUsers()
 
 void UserManager::printUsersByRole(UserRole role)
 {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
     Utils::printHeader("Users with role: " + User::roleToString(role));
     for (const auto &user : users)
     {
@@ -547,8 +651,40 @@ void UserManager::printUsersByRole(UserRole role)
 
 bool UserManager::exportToCSV(const std::string &filename)
 {
-    LOG_INFO("Exporting users to CSV: " + filename);
-    return true;
+    return exportToFile(filename, Export::Options()).ok;
+}
+
+Export::Report UserManager::exportToFile(const std::string &filename, const Export::Options &options)
+{
+    static const std::vector<std::string> columns = {"id", "username", "fullName", "email",
+                                                     "role", "active", "lastLogin"};
+    Export::Encode<User> encode = [](const User &u, Export::Encoder &out)
+    {
+        out.integer(u.getUserId());
+        out.text(u.getUsername());
+        out.text(u.getFullName());
+        out.text(u.getEmail());
+        out.text(u.getRoleString());
+        out.boolean(u.getIsActive());
+        out.text(u.getLastLoginDate());
+    };
+
+    Export::Report report;
+    {
+        std::shared_lock<std::shared_mutex> lock(dataMutex);
+        std::vector<size_t> positions(users.size());
+        std::iota(positions.begin(), positions.end(), 0);
+        report = Export::write(filename, columns, users, positions, encode, options);
+    }
+    if (report.ok)
+    {
+        LOG_INFO(report.summary() + " to " + filename);
+    }
+    else
+    {
+        LOG_ERROR("Cannot export users to " + filename + ": " + report.error);
+    }
+    return report;
 }
 
 bool UserManager::importFromCSV(const std::string &filename)
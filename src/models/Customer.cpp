@@ -1,4 +1,5 @@
 #include "models/Customer.h"
+#include "utils/Memory.h"
 #include "utils/Utils.h"
 #include <sstream>
 
@@ -71,4 +72,14 @@ Customer Customer::deserialize(const std::string &data)
     }
 
     return customer;
-}
\ No newline at end of file
+}
+
+void Customer::addHeapUsage(MemoryUsage &usage) const
+{
+    usage.addString("name", name);
+    usage.addString("email", email);
+    usage.addString("phone", phone);
+    usage.addString("address", address);
+    usage.addString("city", city);
+    usage.addString("country", country);
+}
@@ -1,5 +1,7 @@
 #include "models/Order.h"
+#include "utils/Memory.h"
 #include "utils/Utils.h"
+#include "utils/TimestampService.h"
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
@@ -8,14 +10,21 @@ Order::Order()
     : orderId(0), customerId(0), status(OrderStatus::PENDING),
       totalAmount(0.0), discountAmount(0.0), finalAmount(0.0)
 {
-    orderDate = Utils::getCurrentDateTime();
+    orderDate = TimestampService::getInstance().now();
+}
+
+Order::Order(DeserializeTag)
+    : orderId(0), customerId(0), status(OrderStatus::PENDING),
+      totalAmount(0.0), discountAmount(0.0), finalAmount(0.0)
+{
+    // Order date comes from the serialized record
 }
 
 Order::Order(int id, int customerId, const std::string &customerName)
     : orderId(id), customerId(customerId), customerName(customerName),
       status(OrderStatus::PENDING), totalAmount(0.0), discountAmount(0.0), finalAmount(0.0)
 {
-    orderDate = Utils::getCurrentDateTime();
+    orderDate = TimestampService::getInstance().now();
 }
 
 void Order::addItem(const OrderItem &item)
@@ -283,7 +292,7 @@ std::string Order::serialize() const
 Order Order::deserialize(const std::string &data)
 {
     std::vector<std::string> parts = Utils::split(data, '|');
-    Order order;
+    Order order{DeserializeTag()};
 
     if (parts.size() >= 11)
     {
@@ -318,6 +327,24 @@ Order Order::deserialize(const std::string &data)
             }
         }
     }
+    else
+    {
+        // Too short to carry a date: stamp it as the default constructor would
+        order.orderDate = TimestampService::getInstance().now();
+    }
 
     return order;
-}
\ No newline at end of file
+}
+
+void Order::addHeapUsage(MemoryUsage &usage) const
+{
+    usage.addString("customerName", customerName);
+    usage.addString("orderDate", orderDate);
+    usage.addString("shippingAddress", shippingAddress);
+    usage.addString("notes", notes);
+    usage.addVector("items", items);
+    for (const auto &item : items)
+    {
+        usage.addString("item productName", item.productName);
+    }
+}
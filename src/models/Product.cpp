@@ -1,46 +1,164 @@
 #include "models/Product.h"
+#include "utils/Memory.h"
 #include "utils/Utils.h"
 #include <sstream>
 #include <algorithm>
 
 Product::Product()
-    : productId(0), price(0.0), stockQuantity(0), minStockLevel(0), isActive(true)
+    : productId(0), price(0.0), stockState(0), minStockLevel(0), isActive(true)
 {
 }
 
 Product::Product(int id, const std::string &name, const std::string &description,
                  const std::string &category, double price, int stockQuantity, int minStockLevel)
     : productId(id), name(name), description(description), category(category),
-      price(price), stockQuantity(stockQuantity), minStockLevel(minStockLevel), isActive(true)
+      price(price), stockState(packStock(stockQuantity, 0)), minStockLevel(minStockLevel), isActive(true)
 {
 }
 
-bool Product::reduceStock(int quantity)
+Product::Product(const Product &other)
+    : productId(other.productId), name(other.name), description(other.description),
+      category(other.category), price(other.price), stockState(other.stockState.load()),
+      minStockLevel(other.minStockLevel), isActive(other.isActive)
 {
-    if (quantity <= 0 || quantity > stockQuantity)
+}
+
+Product &Product::operator=(const Product &other)
+{
+    if (this != &other)
+    {
+        productId = other.productId;
+        name = other.name;
+        description = other.description;
+        category = other.category;
+        price = other.price;
+        stockState.store(other.stockState.load());
+        minStockLevel = other.minStockLevel;
+        isActive = other.isActive;
+    }
+    return *this;
+}
+
+std::uint64_t Product::packStock(int onHand, int reserved)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(onHand)) << 32) |
+           static_cast<std::uint32_t>(reserved);
+}
+
+template <typename Change>
+bool Product::updateStockState(Change change, int *previousOnHand)
+{
+    std::uint64_t current = stockState.load();
+    int onHand = 0;
+    int reserved = 0;
+    do
     {
-        return false;
+        onHand = onHandOf(current);
+        reserved = reservedOf(current);
+        if (!change(onHand, reserved))
+        {
+            return false;
+        }
+    } while (!stockState.compare_exchange_weak(current, packStock(onHand, reserved)));
+
+    if (previousOnHand)
+    {
+        *previousOnHand = onHandOf(current);
     }
-    stockQuantity -= quantity;
     return true;
 }
 
-void Product::addStock(int quantity)
+int Product::getAvailableQuantity() const
+{
+    std::uint64_t state = stockState.load();
+    return onHandOf(state) - reservedOf(state);
+}
+
+bool Product::setStockQuantity(int quantity, int *previousStock)
+{
+    // With nothing reserved a negative level is left for isValid to reject
+    return updateStockState([quantity](int &onHand, int &reserved)
+                            {
+                                if (reserved > 0 && quantity < reserved)
+                                {
+                                    return false;
+                                }
+                                onHand = quantity;
+                                return true; },
+                            previousStock);
+}
+
+void Product::setReservedQuantity(int quantity)
+{
+    updateStockState([quantity](int &, int &reserved)
+                     {
+                         reserved = quantity;
+                         return true; });
+}
+
+bool Product::adjustStock(int onHandDelta, int reservedDelta, int *previousStock)
 {
+    return updateStockState([onHandDelta, reservedDelta](int &onHand, int &reserved)
+                            {
+                                int newOnHand = onHand + onHandDelta;
+                                int newReserved = reserved + reservedDelta;
+                                bool lowersAvailable = onHandDelta - reservedDelta < 0;
+                                if (newReserved < 0 || (onHandDelta < 0 && newOnHand < 0) ||
+                                    (lowersAvailable && newOnHand - newReserved < 0))
+                                {
+                                    return false;
+                                }
+                                onHand = newOnHand;
+                                reserved = newReserved;
+                                return true; },
+                            previousStock);
+}
+
+bool Product::reduceStock(int quantity, int *previousStock)
+{
+    return quantity > 0 && adjustStock(-quantity, 0, previousStock);
+}
+
+void Product::addStock(int quantity, int *previousStock)
+{
+    if (quantity > 0)
+    {
+        adjustStock(quantity, 0, previousStock);
+    }
+}
+
+bool Product::reserve(int quantity)
+{
+    return quantity > 0 && adjustStock(0, quantity);
+}
+
+bool Product::commitReservation(int quantity, int *previousStock)
+{
+    return quantity > 0 && adjustStock(-quantity, -quantity, previousStock);
+}
+
+int Product::releaseReservation(int quantity)
+{
+    int released = 0;
     if (quantity > 0)
     {
-        stockQuantity += quantity;
+        updateStockState([quantity, &released](int &, int &reserved)
+                         {
+                             released = std::min(quantity, reserved);
+                             reserved -= released;
+                             return true; });
     }
+    return released;
 }
 
 bool Product::isLowStock() const
 {
-    return stockQuantity <= minStockLevel;
+    return getAvailableQuantity() <= minStockLevel;
 }
 
 bool Product::isInStock(int quantity) const
 {
-    return stockQuantity >= quantity;
+    return getAvailableQuantity() >= quantity;
 }
 
 std::string Product::toString() const
@@ -51,7 +169,8 @@ std::string Product::toString() const
        << "Description: " << description << "\n"
        << "Category: " << category << "\n"
        << "Price: " << Utils::formatCurrency(price) << "\n"
-       << "Stock Quantity: " << stockQuantity << "\n"
+       << "Stock Quantity: " << getStockQuantity() << "\n"
+       << "Reserved: " << getReservedQuantity() << "\n"
        << "Min Stock Level: " << minStockLevel << "\n"
        << "Status: " << (isActive ? "Active" : "Inactive") << "\n"
        << "Stock Status: " << (isLowStock() ? "LOW STOCK" : "In Stock");
@@ -63,7 +182,7 @@ bool Product::isValid() const
     return !name.empty() &&
            !category.empty() &&
            price >= 0.0 &&
-           stockQuantity >= 0 &&
+           getStockQuantity() >= 0 &&
            minStockLevel >= 0;
 }
 
@@ -75,9 +194,10 @@ std::string Product::serialize() const
        << description << "|"
        << category << "|"
        << price << "|"
-       << stockQuantity << "|"
+       << getStockQuantity() << "|"
        << minStockLevel << "|"
-       << (isActive ? "1" : "0");
+       << (isActive ? "1" : "0") << "|"
+       << getReservedQuantity();
     return ss.str();
 }
 
@@ -93,10 +213,18 @@ Product Product::deserialize(const std::string &data)
         product.description = parts[2];
         product.category = parts[3];
         product.price = std::stod(parts[4]);
-        product.stockQuantity = std::stoi(parts[5]);
+        int reserved = parts.size() >= 9 ? std::stoi(parts[8]) : 0; // older files have no reserved column
+        product.stockState.store(packStock(std::stoi(parts[5]), reserved));
         product.minStockLevel = std::stoi(parts[6]);
         product.isActive = (parts[7] == "1");
     }
 
     return product;
-}
\ No newline at end of file
+}
+
+void Product::addHeapUsage(MemoryUsage &usage) const
+{
+    usage.addString("name", name);
+    usage.addString("description", description);
+    usage.addString("category", category);
+}
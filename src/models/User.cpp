@@ -1,5 +1,7 @@
 #include "models/User.h"
+#include "utils/Memory.h"
 #include "utils/Utils.h"
+#include "utils/TimestampService.h"
 #include <sstream>
 
 User::User()
@@ -21,7 +23,7 @@ bool User::verifyPassword(const std::string &inputPassword) const
 
 void User::updateLastLogin()
 {
-    lastLoginDate = Utils::getCurrentDateTime();
+    lastLoginDate = TimestampService::getInstance().now();
 }
 
 bool User::canManageUsers() const
@@ -132,4 +134,13 @@ User User::deserialize(const std::string &data)
     }
 
     return user;
-}
\ No newline at end of file
+}
+
+void User::addHeapUsage(MemoryUsage &usage) const
+{
+    usage.addString("username", username);
+    usage.addString("password", password);
+    usage.addString("fullName", fullName);
+    usage.addString("email", email);
+    usage.addString("lastLoginDate", lastLoginDate);
+}
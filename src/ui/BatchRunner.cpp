@@ -0,0 +1,354 @@
+#include "ui/BatchRunner.h"
+#include "utils/Csv.h"
+#include "utils/Logger.h"
+#include "utils/Trace.h"
+#include "utils/Transaction.h"
+#include <cstdlib>
+#include <sstream>
+
+namespace
+{
+    bool parseNumber(const std::string &text, double &value)
+    {
+        char *end = nullptr;
+        double parsed = std::strtod(text.c_str(), &end);
+        if (text.empty() || *end != '\0')
+        {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+
+    bool parseQuantity(const std::string &text, int &quantity, std::string &reason)
+    {
+        if (!Csv::parseInt(text, quantity))
+        {
+            reason = "quantity must be a whole number: " + text;
+            return false;
+        }
+        return true;
+    }
+}
+
+BatchRunner::BatchRunner(UserManager &users, CustomerManager &customers, ProductManager &products,
+                         OrderManager &orders)
+    : users(users), customers(customers), products(products), orders(orders), lastCustomerId(0),
+      lastProductId(0), lastOrderId(0)
+{
+}
+
+const std::vector<BatchRunner::Command> &BatchRunner::commands()
+{
+    static const std::vector<Command> table = {
+        {"customer.add", "NAME,EMAIL,PHONE,ADDRESS,CITY,COUNTRY", "manage_customers", 6, 6, &BatchRunner::addCustomer},
+        {"product.add", "NAME,CATEGORY,PRICE,STOCK[,MIN_STOCK[,DESCRIPTION]]", "manage_products", 4, 6,
+         &BatchRunner::addProduct},
+        {"stock.set", "PRODUCT,QUANTITY", "manage_products", 2, 2, &BatchRunner::setStock},
+        {"stock.add", "PRODUCT,QUANTITY", "manage_products", 2, 2, &BatchRunner::addStock},
+        {"stock.reduce", "PRODUCT,QUANTITY", "manage_products", 2, 2, &BatchRunner::reduceStock},
+        {"order.create", "CUSTOMER", "manage_orders", 1, 1, &BatchRunner::createOrder},
+        {"order.add_item", "ORDER,PRODUCT,QUANTITY", "manage_orders", 3, 3, &BatchRunner::addItem},
+        {"order.remove_item", "ORDER,PRODUCT", "manage_orders", 2, 2, &BatchRunner::removeItem},
+        {"order.set_quantity", "ORDER,PRODUCT,QUANTITY", "manage_orders", 3, 3, &BatchRunner::setItemQuantity},
+        {"order.status", "ORDER,STATUS", "manage_orders", 2, 2, &BatchRunner::setStatus},
+        {"customer.get", "CUSTOMER", nullptr, 1, 1, &BatchRunner::getCustomer},
+        {"product.get", "PRODUCT", nullptr, 1, 1, &BatchRunner::getProduct},
+        {"order.get", "ORDER", nullptr, 1, 1, &BatchRunner::getOrder},
+    };
+    return table;
+}
+
+std::string BatchRunner::usage()
+{
+    std::string text;
+    for (const auto &command : commands())
+    {
+        text += std::string(command.name) + "," + command.usage + "\n";
+    }
+    return text;
+}
+
+BatchRunner::Report BatchRunner::run(std::istream &in, std::ostream &out)
+{
+    Report report;
+    Transaction transaction;
+    transaction.deferSaves();
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#')
+        {
+            continue;
+        }
+
+        ++report.commands;
+        std::string reason;
+        if (execute(line.substr(start), out, reason))
+        {
+            ++report.result.applied;
+        }
+        else
+        {
+            report.result.fail(lineNumber, reason);
+        }
+    }
+
+    {
+        TRACE_SPAN("batch.commit");
+        report.saved = transaction.commit();
+    }
+    LOG_INFO("Batch applied " + std::to_string(report.result.applied) + " of " + std::to_string(report.commands) +
+             " commands");
+    return report;
+}
+
+bool BatchRunner::runAll(const std::vector<std::string> &commands, std::vector<Outcome> &outcomes)
+{
+    Transaction transaction;
+    transaction.deferSaves();
+
+    outcomes.clear();
+    outcomes.reserve(commands.size());
+    for (const auto &command : commands)
+    {
+        Outcome outcome;
+        std::ostringstream output;
+        outcome.ok = execute(command, output, outcome.text);
+        if (outcome.ok)
+        {
+            outcome.text = output.str();
+            if (!outcome.text.empty() && outcome.text.back() == '\n')
+            {
+                outcome.text.pop_back();
+            }
+        }
+        outcomes.push_back(std::move(outcome));
+    }
+
+    TRACE_SPAN("batch.commit");
+    return transaction.commit();
+}
+
+bool BatchRunner::execute(const std::string &line, std::ostream &out, std::string &reason)
+{
+    std::vector<std::string> fields = Csv::parseRecord(line);
+    const std::string name = fields.empty() ? "" : fields.front();
+    for (const auto &command : commands())
+    {
+        if (name != command.name)
+        {
+            continue;
+        }
+
+        Args args(fields.begin() + 1, fields.end());
+        if (args.size() < command.minArgs || args.size() > command.maxArgs)
+        {
+            reason = "usage: " + name + "," + command.usage;
+            return false;
+        }
+        if (command.permission ? !users.hasPermission(command.permission) : !users.isLoggedIn())
+        {
+            reason = name + ": access denied";
+            return false;
+        }
+        if (!(this->*command.handler)(args, out, reason))
+        {
+            if (reason.empty())
+            {
+                reason = line + ": rejected";
+            }
+            return false;
+        }
+        return true;
+    }
+
+    reason = "unknown command: " + name;
+    return false;
+}
+
+bool BatchRunner::parseId(const std::string &text, int &id, std::string &reason) const
+{
+    if (!text.empty() && text[0] == '$')
+    {
+        if (text == "$customer")
+            id = lastCustomerId;
+        else if (text == "$product")
+            id = lastProductId;
+        else if (text == "$order")
+            id = lastOrderId;
+        else
+            id = -1;
+
+        if (id < 0)
+        {
+            reason = "unknown reference: " + text;
+        }
+        else if (id == 0)
+        {
+            reason = "no " + text.substr(1) + " created yet";
+        }
+        return id > 0;
+    }
+    if (!Csv::parseInt(text, id))
+    {
+        reason = "id must be a whole number: " + text;
+        return false;
+    }
+    return true;
+}
+
+bool BatchRunner::addCustomer(const Args &args, std::ostream &out, std::string &)
+{
+    int customerId = 0;
+    if (!customers.addCustomer(Customer(0, args[0], args[1], args[2], args[3], args[4], args[5]), customerId))
+    {
+        return false;
+    }
+    lastCustomerId = customerId;
+    out << "customer " << customerId << "\n";
+    return true;
+}
+
+bool BatchRunner::addProduct(const Args &args, std::ostream &out, std::string &reason)
+{
+    double price = 0.0;
+    int stock = 0;
+    int minStock = 0;
+    if (!parseNumber(args[2], price) || !Csv::parseInt(args[3], stock) ||
+        (args.size() > 4 && !Csv::parseInt(args[4], minStock)))
+    {
+        reason = "price, stock and minimum stock must be numbers";
+        return false;
+    }
+
+    int productId = 0;
+    std::string description = args.size() > 5 ? args[5] : "";
+    if (!products.addProduct(Product(0, args[0], description, args[1], price, stock, minStock), productId))
+    {
+        return false;
+    }
+    lastProductId = productId;
+    out << "product " << productId << "\n";
+    return true;
+}
+
+bool BatchRunner::setStock(const Args &args, std::ostream &, std::string &reason)
+{
+    int productId = 0;
+    int quantity = 0;
+    return parseId(args[0], productId, reason) && parseQuantity(args[1], quantity, reason) &&
+           products.updateStock(productId, quantity);
+}
+
+bool BatchRunner::addStock(const Args &args, std::ostream &, std::string &reason)
+{
+    int productId = 0;
+    int quantity = 0;
+    return parseId(args[0], productId, reason) && parseQuantity(args[1], quantity, reason) &&
+           products.addStock(productId, quantity);
+}
+
+bool BatchRunner::reduceStock(const Args &args, std::ostream &, std::string &reason)
+{
+    int productId = 0;
+    int quantity = 0;
+    return parseId(args[0], productId, reason) && parseQuantity(args[1], quantity, reason) &&
+           products.reduceStock(productId, quantity);
+}
+
+bool BatchRunner::createOrder(const Args &args, std::ostream &out, std::string &reason)
+{
+    int customerId = 0;
+    int orderId = 0;
+    if (!parseId(args[0], customerId, reason) || !orders.createOrder(customerId, orderId))
+    {
+        return false;
+    }
+    lastOrderId = orderId;
+    out << "order " << orderId << "\n";
+    return true;
+}
+
+bool BatchRunner::addItem(const Args &args, std::ostream &, std::string &reason)
+{
+    int orderId = 0;
+    int productId = 0;
+    int quantity = 0;
+    return parseId(args[0], orderId, reason) && parseId(args[1], productId, reason) &&
+           parseQuantity(args[2], quantity, reason) && orders.addItemToOrder(orderId, productId, quantity);
+}
+
+bool BatchRunner::removeItem(const Args &args, std::ostream &, std::string &reason)
+{
+    int orderId = 0;
+    int productId = 0;
+    return parseId(args[0], orderId, reason) && parseId(args[1], productId, reason) &&
+           orders.removeItemFromOrder(orderId, productId);
+}
+
+bool BatchRunner::setItemQuantity(const Args &args, std::ostream &, std::string &reason)
+{
+    int orderId = 0;
+    int productId = 0;
+    int quantity = 0;
+    return parseId(args[0], orderId, reason) && parseId(args[1], productId, reason) &&
+           parseQuantity(args[2], quantity, reason) && orders.updateOrderItemQuantity(orderId, productId, quantity);
+}
+
+bool BatchRunner::setStatus(const Args &args, std::ostream &, std::string &reason)
+{
+    int orderId = 0;
+    if (!parseId(args[0], orderId, reason))
+    {
+        return false;
+    }
+    // stringToStatus falls back to Pending, so only accept names it maps back from
+    OrderStatus status = Order::stringToStatus(args[1]);
+    if (Order::statusToString(status) != args[1])
+    {
+        reason = "unknown status: " + args[1] + " (Pending, Confirmed, Processing, Shipped, Delivered, Cancelled)";
+        return false;
+    }
+    return orders.updateOrderStatus(orderId, status);
+}
+
+bool BatchRunner::getCustomer(const Args &args, std::ostream &out, std::string &reason)
+{
+    int customerId = 0;
+    Customer customer;
+    if (!parseId(args[0], customerId, reason) || !customers.getCustomerCopy(customerId, customer))
+    {
+        return false;
+    }
+    out << customer.serialize() << "\n";
+    return true;
+}
+
+bool BatchRunner::getProduct(const Args &args, std::ostream &out, std::string &reason)
+{
+    int productId = 0;
+    Product product;
+    if (!parseId(args[0], productId, reason) || !products.getProductCopy(productId, product))
+    {
+        return false;
+    }
+    out << product.serialize() << "\n";
+    return true;
+}
+
+bool BatchRunner::getOrder(const Args &args, std::ostream &out, std::string &reason)
+{
+    int orderId = 0;
+    Order order;
+    if (!parseId(args[0], orderId, reason) || !orders.getOrderCopy(orderId, order))
+    {
+        return false;
+    }
+    out << order.serialize() << "\n";
+    return true;
+}
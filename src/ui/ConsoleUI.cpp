@@ -1,6 +1,8 @@
 #include "ui/ConsoleUI.h"
 #include "utils/Utils.h"
 #include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
@@ -488,34 +490,215 @@ void ConsoleUI::handleAddCustomer()
 
 void ConsoleUI::handleViewCustomers()
 {
-    clearScreen();
-    displayHeader("ALL CUSTOMERS");
+    int cursor = 0;
+    while (true)
+    {
+        clearScreen();
+        displayHeader("ALL CUSTOMERS");
+
+        Page<Customer> page = customerManager->getCustomersPage(cursor, PAGE_SIZE);
+        if (page.items.empty() && cursor == 0)
+        {
+            displayMessage("No customers found.");
+            return;
+        }
+
+        std::cout << std::left << std::setw(5) << "ID"
+                  << std::setw(20) << "Name"
+                  << std::setw(25) << "Email"
+                  << std::setw(15) << "Phone"
+                  << std::setw(15) << "City"
+                  << std::setw(10) << "Status" << std::endl;
+        Utils::printSeparator('-', 90);
 
-    auto customers = customerManager->getAllCustomers();
+        for (const auto &customer : page.items)
+        {
+            std::cout << std::left << std::setw(5) << customer.getCustomerId()
+                      << std::setw(20) << customer.getName().substr(0, 19)
+                      << std::setw(25) << customer.getEmail().substr(0, 24)
+                      << std::setw(15) << customer.getPhone().substr(0, 14)
+                      << std::setw(15) << customer.getCity().substr(0, 14)
+                      << std::setw(10) << (customer.getIsActive() ? "Active" : "Inactive") << std::endl;
+        }
 
-    if (customers.empty())
+        cursor = page.nextCursor;
+        if (!showNextPage(page.hasMore))
+        {
+            return;
+        }
+    }
+}
+
+void ConsoleUI::handleViewProducts()
+{
+    int cursor = 0;
+    while (true)
     {
-        displayMessage("No customers found.");
-        return;
+        clearScreen();
+        displayHeader("ALL PRODUCTS");
+
+        Page<Product> page = productManager->getProductsPage(cursor, PAGE_SIZE);
+        if (page.items.empty() && cursor == 0)
+        {
+            displayMessage("No products found.");
+            return;
+        }
+
+        std::cout << std::left << std::setw(5) << "ID"
+                  << std::setw(25) << "Name"
+                  << std::setw(15) << "Category"
+                  << std::setw(12) << "Price"
+                  << std::setw(8) << "Stock"
+                  << std::setw(10) << "Available"
+                  << std::setw(10) << "Status" << std::endl;
+        Utils::printSeparator('-', 85);
+
+        for (const auto &product : page.items)
+        {
+            std::cout << std::left << std::setw(5) << product.getProductId()
+                      << std::setw(25) << product.getName().substr(0, 24)
+                      << std::setw(15) << product.getCategory().substr(0, 14)
+                      << std::setw(12) << Utils::formatCurrency(product.getPrice())
+                      << std::setw(8) << product.getStockQuantity()
+                      << std::setw(10) << product.getAvailableQuantity()
+                      << std::setw(10) << (product.getIsActive() ? "Active" : "Inactive") << std::endl;
+        }
+
+        cursor = page.nextCursor;
+        if (!showNextPage(page.hasMore))
+        {
+            return;
+        }
+    }
+}
+
+void ConsoleUI::handleViewOrders()
+{
+    int cursor = 0;
+    while (true)
+    {
+        clearScreen();
+        displayHeader("ALL ORDERS");
+
+        Page<Order> page = orderManager->getOrdersPage(cursor, PAGE_SIZE);
+        if (page.items.empty() && cursor == 0)
+        {
+            displayMessage("No orders found.");
+            return;
+        }
+
+        std::cout << std::left << std::setw(6) << "ID"
+                  << std::setw(20) << "Customer"
+                  << std::setw(21) << "Date"
+                  << std::setw(12) << "Status"
+                  << std::setw(7) << "Items"
+                  << std::setw(12) << "Total" << std::endl;
+        Utils::printSeparator('-', 78);
+
+        for (const auto &order : page.items)
+        {
+            std::cout << std::left << std::setw(6) << order.getOrderId()
+                      << std::setw(20) << order.getCustomerName().substr(0, 19)
+                      << std::setw(21) << order.getOrderDate()
+                      << std::setw(12) << order.getStatusString()
+                      << std::setw(7) << order.getItemCount()
+                      << std::setw(12) << Utils::formatCurrency(order.getFinalAmount()) << std::endl;
+        }
+
+        cursor = page.nextCursor;
+        if (!showNextPage(page.hasMore))
+        {
+            return;
+        }
+    }
+}
+
+void ConsoleUI::handleSystemReports()
+{
+    clearScreen();
+    displayHeader("SYSTEM REPORTS");
+
+    std::cout << "Users: " << userManager->getTotalUsers()
+              << "   Customers: " << customerManager->getTotalCustomers()
+              << "   Products: " << productManager->getTotalProducts()
+              << "   Orders: " << orderManager->getTotalOrders() << "\n\n";
+
+    // Estimated footprint per manager (see MemoryUsage), then its biggest fields
+    std::vector<MemoryUsage> usages = {orderManager->getMemoryUsage(), productManager->getMemoryUsage(),
+                                       customerManager->getMemoryUsage(), userManager->getMemoryUsage()};
+    std::cout << std::left << std::setw(12) << "Memory" << std::right
+              << std::setw(10) << "Objects"
+              << std::setw(12) << "Records"
+              << std::setw(12) << "Strings"
+              << std::setw(12) << "Vectors"
+              << std::setw(12) << "Indexes"
+              << std::setw(12) << "Total" << std::endl;
+    Utils::printSeparator('-', 82);
+    size_t totalBytes = 0;
+    for (auto &usage : usages)
+    {
+        std::cout << std::left << std::setw(12) << usage.component << std::right
+                  << std::setw(10) << usage.objects
+                  << std::setw(12) << Utils::formatBytes(usage.recordBytes)
+                  << std::setw(12) << Utils::formatBytes(usage.stringBytes)
+                  << std::setw(12) << Utils::formatBytes(usage.vectorBytes)
+                  << std::setw(12) << Utils::formatBytes(usage.indexBytes)
+                  << std::setw(12) << Utils::formatBytes(usage.total()) << std::endl;
+        totalBytes += usage.total();
+
+        std::sort(usage.fields.begin(), usage.fields.end(),
+                  [](const auto &a, const auto &b)
+                  { return a.second > b.second; });
+        std::string fields;
+        for (size_t i = 0; i < usage.fields.size() && i < 4 && usage.fields[i].second > 0; ++i)
+        {
+            fields += (i ? ", " : "") + std::string(usage.fields[i].first) + " " + Utils::formatBytes(usage.fields[i].second);
+        }
+        if (!fields.empty())
+        {
+            std::cout << "    " << fields << std::endl;
+        }
     }
+    std::cout << std::left << std::setw(70) << "Total" << std::right << std::setw(12) << Utils::formatBytes(totalBytes)
+              << "\n\n";
 
-    std::cout << std::left << std::setw(5) << "ID"
-              << std::setw(20) << "Name"
-              << std::setw(25) << "Email"
-              << std::setw(15) << "Phone"
-              << std::setw(15) << "City"
-              << std::setw(10) << "Status" << std::endl;
-    Utils::printSeparator('-', 90);
+    Metrics &metrics = Metrics::getInstance();
+    std::cout << std::left << std::setw(28) << "Counter" << std::right << std::setw(14) << "Value" << std::endl;
+    Utils::printSeparator('-', 42);
+    for (const auto &counter : metrics.counterValues())
+    {
+        std::cout << std::left << std::setw(28) << counter.first
+                  << std::right << std::setw(14) << counter.second << std::endl;
+    }
 
-    for (const auto &customer : customers)
+    // Latencies are recorded in nanoseconds and shown in milliseconds
+    std::cout << "\n"
+              << std::left << std::setw(24) << "Operation" << std::right
+              << std::setw(10) << "Count"
+              << std::setw(10) << "Mean ms"
+              << std::setw(10) << "p50 ms"
+              << std::setw(10) << "p99 ms"
+              << std::setw(10) << "p99.9 ms"
+              << std::setw(10) << "Max ms" << std::endl;
+    Utils::printSeparator('-', 84);
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto &entry : metrics.latencySnapshots())
     {
-        std::cout << std::left << std::setw(5) << customer.getCustomerId()
-                  << std::setw(20) << customer.getName().substr(0, 19)
-                  << std::setw(25) << customer.getEmail().substr(0, 24)
-                  << std::setw(15) << customer.getPhone().substr(0, 14)
-                  << std::setw(15) << customer.getCity().substr(0, 14)
-                  << std::setw(10) << (customer.getIsActive() ? "Active" : "Inactive") << std::endl;
+        const Histogram &latency = entry.second;
+        if (latency.getCount() == 0)
+        {
+            continue;
+        }
+        std::cout << std::left << std::setw(24) << entry.first << std::right
+                  << std::setw(10) << latency.getCount()
+                  << std::setw(10) << latency.getMean() / 1e6
+                  << std::setw(10) << latency.percentile(50) / 1e6
+                  << std::setw(10) << latency.percentile(99) / 1e6
+                  << std::setw(10) << latency.percentile(99.9) / 1e6
+                  << std::setw(10) << latency.getMax() / 1e6 << std::endl;
     }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::left << std::setprecision(6);
 }
 
 // Placeholder implementations for other handlers
@@ -524,21 +707,18 @@ void ConsoleUI::handleUpdateCustomer() { displayMessage("Update Customer - Not i
 void ConsoleUI::handleDeleteCustomer() { displayMessage("Delete Customer - Not implemented yet"); }
 void ConsoleUI::handleCustomerReports() { displayMessage("Customer Reports - Not implemented yet"); }
 void ConsoleUI::handleAddProduct() { displayMessage("Add Product - Not implemented yet"); }
-void ConsoleUI::handleViewProducts() { displayMessage("View Products - Not implemented yet"); }
 void ConsoleUI::handleSearchProducts() { displayMessage("Search Products - Not implemented yet"); }
 void ConsoleUI::handleUpdateProduct() { displayMessage("Update Product - Not implemented yet"); }
 void ConsoleUI::handleDeleteProduct() { displayMessage("Delete Product - Not implemented yet"); }
 void ConsoleUI::handleStockManagement() { displayMessage("Stock Management - Not implemented yet"); }
 void ConsoleUI::handleProductReports() { displayMessage("Product Reports - Not implemented yet"); }
 void ConsoleUI::handleCreateOrder() { displayMessage("Create Order - Not implemented yet"); }
-void ConsoleUI::handleViewOrders() { displayMessage("View Orders - Not implemented yet"); }
 void ConsoleUI::handleSearchOrders() { displayMessage("Search Orders - Not implemented yet"); }
 void ConsoleUI::handleUpdateOrder() { displayMessage("Update Order - Not implemented yet"); }
 void ConsoleUI::handleOrderStatus() { displayMessage("Order Status - Not implemented yet"); }
 void ConsoleUI::handleOrderReports() { displayMessage("Order Reports - Not implemented yet"); }
 void ConsoleUI::handleSalesReports() { displayMessage("Sales Reports - Not implemented yet"); }
 void ConsoleUI::handleInventoryReports() { displayMessage("Inventory Reports - Not implemented yet"); }
-void ConsoleUI::handleSystemReports() { displayMessage("System Reports - Not implemented yet"); }
 void ConsoleUI::handleAddUser() { displayMessage("Add User - Not implemented yet"); }
 void ConsoleUI::handleViewUsers() { displayMessage("View Users - Not implemented yet"); }
 void ConsoleUI::handleUpdateUser() { displayMessage("Update User - Not implemented yet"); }
@@ -583,6 +763,16 @@ void ConsoleUI::displayWarning(const std::string &message)
     Utils::printWarning(message);
 }
 
+bool ConsoleUI::showNextPage(bool hasMore)
+{
+    if (!hasMore)
+    {
+        return false;
+    }
+    char choice = Utils::getCharInput("\n[n] Next page  [q] Back: ", "nNqQ");
+    return choice == 'n' || choice == 'N';
+}
+
 void ConsoleUI::waitForInput()
 {
     Utils::pauseForInput();
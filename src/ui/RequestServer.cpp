@@ -0,0 +1,622 @@
+#include "ui/RequestServer.h"
+#include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <sstream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+#ifdef MSG_NOSIGNAL
+    const int SEND_FLAGS = MSG_NOSIGNAL; // a closed peer is an error, not SIGPIPE
+#else
+    const int SEND_FLAGS = 0;
+#endif
+    // How long a worker waits for a client that stopped reading its responses
+    const int SEND_TIMEOUT_MS = 5000;
+    // Bytes read from one connection per turn, so a busy client can't hold a worker
+    const size_t READ_BUDGET = 1 << 20;
+
+    void appendFrame(std::string &out, const std::string &payload)
+    {
+        uint32_t length = static_cast<uint32_t>(payload.size());
+        out += static_cast<char>(length >> 24);
+        out += static_cast<char>(length >> 16);
+        out += static_cast<char>(length >> 8);
+        out += static_cast<char>(length);
+        out += payload;
+    }
+
+    uint32_t frameLength(const char *header)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(header);
+        return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | bytes[3];
+    }
+
+    // Takes the next whole frame off the front of buffer; false if it isn't all there
+    bool takeFrame(std::string &buffer, size_t &offset, std::string &payload)
+    {
+        if (buffer.size() - offset < 4)
+        {
+            return false;
+        }
+        uint32_t length = frameLength(buffer.data() + offset);
+        if (buffer.size() - offset - 4 < length)
+        {
+            return false;
+        }
+        payload.assign(buffer, offset + 4, length);
+        offset += 4 + length;
+        return true;
+    }
+
+    bool setNonBlocking(int fd)
+    {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 && fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+    }
+
+    bool sendAll(int fd, const std::string &data)
+    {
+        size_t sent = 0;
+        while (sent < data.size())
+        {
+            ssize_t count = ::send(fd, data.data() + sent, data.size() - sent, SEND_FLAGS);
+            if (count > 0)
+            {
+                sent += static_cast<size_t>(count);
+            }
+            else if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                pollfd writable = {fd, POLLOUT, 0};
+                if (::poll(&writable, 1, SEND_TIMEOUT_MS) <= 0)
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool makeAddress(const std::string &path, sockaddr_un &address)
+    {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+        {
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+}
+
+RequestServer::RequestServer(UserManager &users, CustomerManager &customers, ProductManager &products,
+                             OrderManager &orders)
+    : users(users), customers(customers), products(products), orders(orders), listenFd(-1), wakeFds{-1, -1},
+      stopping(false)
+{
+}
+
+RequestServer::~RequestServer()
+{
+    stop();
+}
+
+bool RequestServer::start(const std::string &path, size_t workerCount)
+{
+    if (isRunning())
+    {
+        return false;
+    }
+
+    sockaddr_un address;
+    if (!makeAddress(path, address))
+    {
+        LOG_ERROR("Invalid socket path: " + path);
+        return false;
+    }
+
+    // A socket file nobody answers on is left over from a server that died
+    struct stat existing;
+    if (::lstat(path.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+        {
+            LOG_ERROR("Cannot listen on " + path + ": the file exists and is not a socket");
+            return false;
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool live = probe >= 0 && ::connect(probe, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+        if (probe >= 0)
+        {
+            ::close(probe);
+        }
+        if (live)
+        {
+            LOG_ERROR("Another server is listening on " + path);
+            return false;
+        }
+        ::unlink(path.c_str());
+    }
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 || !setNonBlocking(listenFd) ||
+        ::bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0 || ::listen(listenFd, SOMAXCONN) != 0 ||
+        ::pipe(wakeFds) != 0 || !setNonBlocking(wakeFds[0]) || !setNonBlocking(wakeFds[1]))
+    {
+        LOG_ERROR("Failed to listen on " + path + ": " + std::strerror(errno));
+        closeAll();
+        ::unlink(path.c_str());
+        return false;
+    }
+
+    socketPath = path;
+    stopping = false;
+    for (size_t i = 0; i < std::max<size_t>(workerCount, 1); ++i)
+    {
+        workers.emplace_back(&RequestServer::workerLoop, this);
+    }
+    pollThread = std::thread(&RequestServer::pollLoop, this);
+    LOG_INFO("Serving requests on " + path + " with " + std::to_string(workers.size()) + " workers");
+    return true;
+}
+
+void RequestServer::stop()
+{
+    if (!isRunning())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    wake();
+    pollThread.join();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+
+    closeAll();
+    ::unlink(socketPath.c_str());
+    LOG_INFO("Stopped serving requests on " + socketPath);
+}
+
+void RequestServer::closeAll()
+{
+    for (auto &entry : connections)
+    {
+        ::close(entry.first);
+    }
+    connections.clear();
+    idle.clear();
+    ready.clear();
+    served.clear();
+    for (int *fd : {&listenFd, &wakeFds[0], &wakeFds[1]})
+    {
+        if (*fd >= 0)
+        {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void RequestServer::wake()
+{
+    char byte = 0;
+    // A full pipe already holds a wake-up, so a failed write loses nothing
+    ssize_t ignored = ::write(wakeFds[1], &byte, 1);
+    (void)ignored;
+}
+
+void RequestServer::pollLoop()
+{
+    std::vector<pollfd> fds;
+    while (!stopping)
+    {
+        fds.clear();
+        fds.push_back({listenFd, POLLIN, 0});
+        fds.push_back({wakeFds[0], POLLIN, 0});
+        for (int fd : idle)
+        {
+            fds.push_back({fd, POLLIN, 0});
+        }
+
+        if (::poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            LOG_ERROR("Request server poll failed: " + std::string(std::strerror(errno)));
+            break;
+        }
+
+        if (fds[1].revents)
+        {
+            char drain[256];
+            while (::read(wakeFds[0], drain, sizeof(drain)) > 0)
+            {
+            }
+
+            std::vector<Connection *> back;
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                back.swap(served);
+            }
+            for (Connection *connection : back)
+            {
+                if (connection->open)
+                {
+                    idle.push_back(connection->fd);
+                }
+                else
+                {
+                    ::close(connection->fd);
+                    connections.erase(connection->fd);
+                }
+            }
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            acceptConnections();
+        }
+
+        std::vector<Connection *> readable;
+        for (size_t i = 2; i < fds.size(); ++i)
+        {
+            if (fds[i].revents)
+            {
+                readable.push_back(connections[fds[i].fd].get());
+                idle.erase(std::find(idle.begin(), idle.end(), fds[i].fd));
+            }
+        }
+        if (!readable.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                ready.insert(ready.end(), readable.begin(), readable.end());
+            }
+            if (readable.size() == 1)
+            {
+                queueReady.notify_one();
+            }
+            else
+            {
+                queueReady.notify_all();
+            }
+        }
+    }
+}
+
+void RequestServer::acceptConnections()
+{
+    while (true)
+    {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                LOG_WARNING("Failed to accept a request connection: " + std::string(std::strerror(errno)));
+            }
+            return;
+        }
+        if (!setNonBlocking(fd))
+        {
+            ::close(fd);
+            continue;
+        }
+        connections[fd] = std::make_unique<Connection>(fd, users, customers, products, orders);
+        idle.push_back(fd);
+        METRIC_INCREMENT("server_connections");
+    }
+}
+
+void RequestServer::workerLoop()
+{
+    while (true)
+    {
+        Connection *connection = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]
+                            { return stopping || !ready.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+            connection = ready.front();
+            ready.pop_front();
+        }
+
+        connection->open = serve(*connection);
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            served.push_back(connection);
+        }
+        wake();
+    }
+}
+
+bool RequestServer::serve(Connection &connection)
+{
+    bool open = true;
+    char buffer[64 * 1024];
+    size_t received = 0;
+    while (received < READ_BUDGET)
+    {
+        ssize_t count = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (count > 0)
+        {
+            connection.input.append(buffer, static_cast<size_t>(count));
+            received += static_cast<size_t>(count);
+        }
+        else if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            // 0 is the client closing; still answer what it sent before that
+            open = count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            break;
+        }
+    }
+
+    std::string responses;
+    std::string request;
+    size_t offset = 0;
+    while (takeFrame(connection.input, offset, request))
+    {
+        appendFrame(responses, handle(connection, request));
+    }
+    connection.input.erase(0, offset);
+    if (connection.input.size() >= 4 && frameLength(connection.input.data()) > MAX_FRAME)
+    {
+        appendFrame(responses, "error\nrequest larger than " + std::to_string(MAX_FRAME) + " bytes");
+        open = false;
+    }
+
+    if (!responses.empty() && !sendAll(connection.fd, responses))
+    {
+        open = false;
+    }
+    return open;
+}
+
+std::string RequestServer::handle(Connection &connection, const std::string &request)
+{
+    std::vector<std::string> commands;
+    std::istringstream lines(request);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start != std::string::npos && line[start] != '#')
+        {
+            commands.push_back(line.substr(start));
+        }
+    }
+    if (commands.size() > 1)
+    {
+        return handleBatch(connection, commands);
+    }
+
+    METRIC_TIMER("server_request");
+    TRACE_SPAN("server.request");
+    std::ostringstream output;
+    std::string reason;
+    if (connection.runner.execute(request, output, reason))
+    {
+        return "ok\n" + output.str();
+    }
+    METRIC_INCREMENT("server_request_failures");
+    return "error\n" + reason;
+}
+
+std::string RequestServer::handleBatch(Connection &connection, const std::vector<std::string> &commands)
+{
+    METRIC_TIMER("server_batch");
+    TRACE_SPAN("server.batch");
+    METRIC_COUNT("server_batch_commands", commands.size());
+    std::vector<BatchRunner::Outcome> outcomes;
+    bool saved = connection.runner.runAll(commands, outcomes);
+
+    // As for a single command, ok says whether the changes were made; a failed
+    // write leaves them in memory for the next save and gets its own line
+    bool ok = true;
+    std::string results;
+    for (const auto &outcome : outcomes)
+    {
+        ok = ok && outcome.ok;
+        results += outcome.ok ? "ok" : "error";
+        if (!outcome.text.empty())
+        {
+            results += " " + outcome.text;
+        }
+        results += "\n";
+    }
+    if (!saved)
+    {
+        METRIC_INCREMENT("server_save_failures");
+        results += "error not saved: the changes were applied but writing the data files failed\n";
+    }
+    if (!ok)
+    {
+        METRIC_INCREMENT("server_request_failures");
+    }
+    return (ok ? "ok\n" : "error\n") + results;
+}
+
+RequestClient::RequestClient() : fd(-1)
+{
+}
+
+RequestClient::~RequestClient()
+{
+    close();
+}
+
+bool RequestClient::connect(const std::string &socketPath)
+{
+    close();
+    sockaddr_un address;
+    if (!makeAddress(socketPath, address))
+    {
+        return false;
+    }
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool RequestClient::send(const std::string &command)
+{
+    std::string frame;
+    appendFrame(frame, command);
+    return fd >= 0 && sendAll(fd, frame);
+}
+
+bool RequestClient::sendBatch(const std::vector<std::string> &commands)
+{
+    std::string request;
+    for (const auto &command : commands)
+    {
+        request += command + "\n";
+    }
+    return send(request);
+}
+
+bool RequestClient::receive(bool &ok, std::string &body)
+{
+    std::string payload;
+    size_t offset = 0;
+    char buffer[64 * 1024];
+    while (!takeFrame(input, offset, payload))
+    {
+        ssize_t count = fd >= 0 ? ::recv(fd, buffer, sizeof(buffer), 0) : -1;
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            return false;
+        }
+        input.append(buffer, static_cast<size_t>(count));
+    }
+    input.erase(0, offset);
+
+    size_t newline = payload.find('\n');
+    ok = payload.compare(0, newline, "ok") == 0;
+    body = newline == std::string::npos ? "" : payload.substr(newline + 1);
+    return true;
+}
+
+bool RequestClient::call(const std::string &command, bool &ok, std::string &body)
+{
+    return send(command) && receive(ok, body);
+}
+
+void RequestClient::close()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+    input.clear();
+}
+
+#else
+
+RequestServer::RequestServer(UserManager &users, CustomerManager &customers, ProductManager &products,
+                             OrderManager &orders)
+    : users(users), customers(customers), products(products), orders(orders), listenFd(-1), wakeFds{-1, -1},
+      stopping(false)
+{
+}
+
+RequestServer::~RequestServer() = default;
+
+bool RequestServer::start(const std::string &, size_t)
+{
+    LOG_ERROR("The request server needs Unix domain sockets, which this build does not support");
+    return false;
+}
+
+void RequestServer::stop()
+{
+}
+
+RequestClient::RequestClient() : fd(-1)
+{
+}
+
+RequestClient::~RequestClient() = default;
+
+bool RequestClient::connect(const std::string &)
+{
+    return false;
+}
+
+bool RequestClient::send(const std::string &)
+{
+    return false;
+}
+
+bool RequestClient::sendBatch(const std::vector<std::string> &)
+{
+    return false;
+}
+
+bool RequestClient::receive(bool &, std::string &)
+{
+    return false;
+}
+
+bool RequestClient::call(const std::string &, bool &, std::string &)
+{
+    return false;
+}
+
+void RequestClient::close()
+{
+}
+
+#endif
@@ -0,0 +1,238 @@
+#include "utils/Csv.h"
+#include "utils/Utils.h"
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Csv
+{
+    std::vector<std::string> parseRecord(std::string_view record)
+    {
+        if (!record.empty() && record.back() == '\r')
+        {
+            record.remove_suffix(1);
+        }
+
+        std::vector<std::string> fields;
+        std::string field;
+        bool quoted = false;
+        for (size_t i = 0; i < record.size(); ++i)
+        {
+            char c = record[i];
+            if (quoted)
+            {
+                if (c != '"')
+                {
+                    field += c;
+                }
+                else if (i + 1 < record.size() && record[i + 1] == '"')
+                {
+                    field += '"';
+                    ++i;
+                }
+                else
+                {
+                    quoted = false;
+                }
+            }
+            else if (c == '"')
+            {
+                quoted = true;
+            }
+            else if (c == ',')
+            {
+                fields.push_back(std::move(field));
+                field.clear();
+            }
+            else
+            {
+                field += c;
+            }
+        }
+        fields.push_back(std::move(field));
+        return fields;
+    }
+
+    void appendField(std::string &out, std::string_view field)
+    {
+        if (field.find_first_of(",\"\r\n") == std::string_view::npos)
+        {
+            out.append(field);
+            return;
+        }
+
+        out += '"';
+        for (char c : field)
+        {
+            if (c == '"')
+            {
+                out += '"';
+            }
+            out += c;
+        }
+        out += '"';
+    }
+
+    Header::Header(const std::vector<std::string> &names)
+    {
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            columns.emplace(Utils::toLower(Utils::trim(names[i])), i);
+        }
+    }
+
+    int Header::indexOf(const std::string &column) const
+    {
+        auto it = columns.find(Utils::toLower(column));
+        return it != columns.end() ? static_cast<int>(it->second) : -1;
+    }
+
+    std::string Row::get(const std::string &column) const
+    {
+        int index = header.indexOf(column);
+        if (index < 0 || static_cast<size_t>(index) >= fields.size())
+        {
+            return "";
+        }
+        return Utils::trim(fields[index]);
+    }
+
+    bool parseInt(const std::string &text, int &value)
+    {
+        char *end = nullptr;
+        long parsed = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || parsed < INT_MIN || parsed > INT_MAX)
+        {
+            return false;
+        }
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    bool Row::getInt(const std::string &column, int &value) const
+    {
+        return parseInt(get(column), value);
+    }
+
+    bool Row::getDouble(const std::string &column, double &value) const
+    {
+        std::string text = get(column);
+        char *end = nullptr;
+        double parsed = std::strtod(text.c_str(), &end);
+        if (text.empty() || *end != '\0')
+        {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+
+    bool Row::getBool(const std::string &column, bool &value) const
+    {
+        std::string text = Utils::toLower(get(column));
+        if (text.empty())
+        {
+            return true;
+        }
+        if (text == "1" || text == "true" || text == "yes")
+        {
+            value = true;
+            return true;
+        }
+        if (text == "0" || text == "false" || text == "no")
+        {
+            value = false;
+            return true;
+        }
+        return false;
+    }
+
+    ChunkReader::ChunkReader(std::istream &in, size_t chunkSize)
+        : in(in), chunkSize(chunkSize), scanned(0), inQuotes(false), nextRecord(1), bytesRead(0)
+    {
+    }
+
+    bool ChunkReader::next(Block &block)
+    {
+        block.text.swap(carry);
+        block.ends.clear();
+        block.firstRecord = nextRecord;
+        carry.clear();
+
+        // Read until the block holds at least one complete record, or the input ends
+        while (true)
+        {
+            size_t start = block.text.size();
+            block.text.resize(start + chunkSize);
+            in.read(&block.text[start], static_cast<std::streamsize>(chunkSize));
+            size_t got = static_cast<size_t>(in.gcount());
+            block.text.resize(start + got);
+            bytesRead += got;
+
+            for (size_t i = scanned; i < block.text.size(); ++i)
+            {
+                char c = block.text[i];
+                if (c == '"')
+                {
+                    inQuotes = !inQuotes;
+                }
+                else if (c == '\n' && !inQuotes)
+                {
+                    block.ends.push_back(i);
+                }
+            }
+            scanned = block.text.size();
+
+            if (!block.ends.empty() || got == 0)
+            {
+                break;
+            }
+        }
+
+        size_t complete = block.ends.empty() ? 0 : block.ends.back() + 1;
+        if (complete < block.text.size())
+        {
+            if (in)
+            {
+                carry.assign(block.text, complete, std::string::npos);
+                block.text.resize(complete);
+            }
+            else
+            {
+                // The last record has no line break after it
+                block.ends.push_back(block.text.size());
+                block.text += '\n';
+            }
+        }
+        scanned = carry.size();
+        if (!in && carry.empty())
+        {
+            inQuotes = false;
+        }
+
+        nextRecord += block.ends.size();
+        return !block.ends.empty();
+    }
+
+    std::string ImportReport::summary() const
+    {
+        double rate = seconds > 0 ? rows / seconds : 0.0;
+        double megabytes = seconds > 0 ? bytes / seconds / (1024.0 * 1024.0) : 0.0;
+        char timing[128];
+        std::snprintf(timing, sizeof(timing), " in %.2f s: %.0f rows/s, %.1f MB/s", seconds, rate, megabytes);
+        return "Imported " + std::to_string(imported) + " of " + std::to_string(rows) + " rows (" +
+               std::to_string(rejectedCount) + " rejected)" + timing;
+    }
+
+    namespace detail
+    {
+        void reject(ImportReport &report, const BatchResult::Failure &failure, const ImportOptions &options)
+        {
+            ++report.rejectedCount;
+            if (report.rejected.size() < options.maxRejectedDetails)
+            {
+                report.rejected.push_back(failure);
+            }
+        }
+    }
+}
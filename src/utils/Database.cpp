@@ -1,28 +1,169 @@
 #include "utils/Database.h"
 #include "utils/Utils.h"
 #include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include "utils/Startup.h"
+#include "utils/Trace.h"
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <map>
+#include <sstream>
+#include <cstdint>
 
 std::unique_ptr<Database> Database::instance = nullptr;
+std::once_flag Database::instanceFlag;
 
-Database::Database() : dataDirectory("data/")
+namespace
+{
+    using FileSet = std::map<std::string, std::vector<std::string>>;
+
+    // Files saved inside the calling thread's open transaction (latest contents win),
+    // with each copy's sequence number
+    struct StagedFiles
+    {
+        bool open = false;
+        FileSet files;
+        std::map<std::string, std::uint64_t> sequences;
+    };
+    thread_local StagedFiles staged;
+
+    // FNV-1a over every journal line before the COMMIT line, so a damaged record
+    // is never replayed
+    constexpr std::uint64_t CHECKSUM_SEED = 1469598103934665603ull;
+
+    std::uint64_t addToChecksum(std::uint64_t hash, const std::string &line)
+    {
+        for (unsigned char c : line)
+        {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        return (hash ^ '\n') * 1099511628211ull;
+    }
+
+    std::string checksumToString(std::uint64_t hash)
+    {
+        std::stringstream ss;
+        ss << std::hex << hash;
+        return ss.str();
+    }
+
+    // Journal layout, one record per file:
+    //   JOURNAL|<file count>
+    //   FILE|<name>|<line count>
+    //   <lines...>
+    //   COMMIT|<checksum>
+    bool writeJournal(const std::string &path, const FileSet &files)
+    {
+        TRACE_SPAN("database.journal");
+        std::ofstream journal(path, std::ios::trunc);
+        if (!journal.is_open())
+        {
+            return false;
+        }
+
+        std::uint64_t hash = CHECKSUM_SEED;
+        auto put = [&journal, &hash](const std::string &line)
+        {
+            journal << line << '\n';
+            hash = addToChecksum(hash, line);
+        };
+
+        put("JOURNAL|" + std::to_string(files.size()));
+        for (const auto &file : files)
+        {
+            put("FILE|" + file.first + "|" + std::to_string(file.second.size()));
+            for (const auto &line : file.second)
+            {
+                put(line);
+            }
+        }
+        journal << "COMMIT|" << checksumToString(hash) << '\n';
+        journal.flush();
+        return static_cast<bool>(journal);
+    }
+
+    bool readJournal(const std::string &path, FileSet &files)
+    {
+        std::ifstream journal(path);
+        std::string line;
+        std::uint64_t hash = CHECKSUM_SEED;
+
+        if (!std::getline(journal, line) || !Utils::startsWith(line, "JOURNAL|"))
+        {
+            return false;
+        }
+        hash = addToChecksum(hash, line);
+
+        try
+        {
+            size_t fileCount = std::stoul(line.substr(8));
+            for (size_t f = 0; f < fileCount; ++f)
+            {
+                std::vector<std::string> header;
+                if (!std::getline(journal, line) ||
+                    (header = Utils::split(line, '|')).size() != 3 || header[0] != "FILE")
+                {
+                    return false;
+                }
+                hash = addToChecksum(hash, line);
+
+                std::vector<std::string> &lines = files[header[1]];
+                size_t lineCount = std::stoul(header[2]);
+                for (size_t i = 0; i < lineCount; ++i)
+                {
+                    if (!std::getline(journal, line))
+                    {
+                        return false;
+                    }
+                    hash = addToChecksum(hash, line);
+                    lines.push_back(line);
+                }
+            }
+        }
+        catch (const std::exception &)
+        {
+            return false;
+        }
+
+        return std::getline(journal, line) && line == "COMMIT|" + checksumToString(hash);
+    }
+}
+
+Database::Database() : dataDirectory("data/"), saveSequence(0)
 {
 }
 
 Database &Database::getInstance()
 {
-    if (!instance)
-    {
-        instance = std::unique_ptr<Database>(new Database());
-    }
+    std::call_once(instanceFlag, []
+                   { instance = std::unique_ptr<Database>(new Database()); });
     return *instance;
 }
 
 bool Database::initialize(const std::string &dataDir)
 {
+    setDataDirectory(dataDir);
+    if (!createDirectories())
+    {
+        return false;
+    }
+
+    // Loading the data files now would read them without the committed changes
+    // still in the journal
+    if (!recoverJournal())
+    {
+        LOG_ERROR("Failed to recover the transaction journal in " + dataDir);
+        return false;
+    }
+    return true;
+}
+
+void Database::setDataDirectory(const std::string &dataDir)
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
     dataDirectory = dataDir;
-    return createDirectories();
+    writtenSequence.clear();
 }
 
 bool Database::fileExists(const std::string &filename) const
@@ -35,29 +176,83 @@ bool Database::createDirectories() const
     return Utils::createDirectory(dataDirectory);
 }
 
-bool Database::saveToFile(const std::string &filename, const std::vector<std::string> &data)
+bool Database::saveToFile(const std::string &filename, const std::vector<std::string> &data,
+                          std::uint64_t sequence)
+{
+    if (sequence == 0)
+    {
+        sequence = nextSaveSequence();
+    }
+    if (staged.open)
+    {
+        staged.files[filename] = data;
+        staged.sequences[filename] = sequence;
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    return writeInOrderLocked(filename, data, sequence);
+}
+
+std::uint64_t Database::nextSaveSequence()
+{
+    return saveSequence.fetch_add(1) + 1;
+}
+
+bool Database::writeInOrderLocked(const std::string &filename, const std::vector<std::string> &data,
+                                  std::uint64_t sequence)
+{
+    std::uint64_t &written = writtenSequence[filename];
+    if (sequence < written)
+    {
+        LOG_DEBUGF("Skipped writing {}: a later copy is already written", filename);
+        return true;
+    }
+    if (!writeFileLocked(filename, data))
+    {
+        return false;
+    }
+    written = sequence;
+    return true;
+}
+
+bool Database::writeFileLocked(const std::string &filename, const std::vector<std::string> &data)
 {
+    METRIC_TIMER("database_write");
+    TRACE_SPAN("database.write");
     std::string fullPath = dataDirectory + filename;
     std::ofstream file(fullPath);
 
     if (!file.is_open())
     {
+        METRIC_INCREMENT("database_write_failures");
         LOG_ERROR("Failed to open file for writing: " + fullPath);
         return false;
     }
 
-    for (const auto &line : data)
+    std::uint64_t bytes = 0;
     {
-        file << line << std::endl;
+        TRACE_SPAN("database.write_lines");
+        for (const auto &line : data)
+        {
+            file << line << std::endl;
+            bytes += line.size() + 1;
+        }
     }
 
-    file.close();
-    LOG_DEBUG("Saved " + std::to_string(data.size()) + " records to " + filename);
+    {
+        TRACE_SPAN("database.close");
+        file.close();
+    }
+    METRIC_COUNT("database_bytes_written", bytes);
+    LOG_DEBUGF("Saved {} records to {}", data.size(), filename);
     return true;
 }
 
 std::vector<std::string> Database::loadFromFile(const std::string &filename)
 {
+    METRIC_TIMER("database_load");
+    StartupPhase phase("database.read");
     std::vector<std::string> data;
     std::string fullPath = dataDirectory + filename;
     std::ifstream file(fullPath);
@@ -69,8 +264,10 @@ std::vector<std::string> Database::loadFromFile(const std::string &filename)
     }
 
     std::string line;
+    std::uint64_t bytes = 0;
     while (std::getline(file, line))
     {
+        bytes += line.size() + 1;
         if (!line.empty())
         {
             data.push_back(line);
@@ -78,12 +275,15 @@ std::vector<std::string> Database::loadFromFile(const std::string &filename)
     }
 
     file.close();
-    LOG_DEBUG("Loaded " + std::to_string(data.size()) + " records from " + filename);
+    phase.setBytes(bytes);
+    phase.setRecords(data.size());
+    LOG_DEBUGF("Loaded {} records from {}", data.size(), filename);
     return data;
 }
 
 bool Database::appendToFile(const std::string &filename, const std::string &data)
 {
+    std::lock_guard<std::mutex> lock(fileMutex);
     std::string fullPath = dataDirectory + filename;
     std::ofstream file(fullPath, std::ios::app);
 
@@ -145,9 +345,9 @@ std::vector<std::string> Database::loadCustomers()
     return loadFromFile("customers.txt");
 }
 
-bool Database::saveProducts(const std::vector<std::string> &productData)
+bool Database::saveProducts(const std::vector<std::string> &productData, std::uint64_t sequence)
 {
-    return saveToFile("products.txt", productData);
+    return saveToFile("products.txt", productData, sequence);
 }
 
 std::vector<std::string> Database::loadProducts()
@@ -192,6 +392,142 @@ bool Database::updateNextId(const std::string &entityType, int nextId)
     return saveToFile(filename, data);
 }
 
+bool Database::beginTransaction()
+{
+    if (staged.open)
+    {
+        return false;
+    }
+    staged.open = true;
+    staged.files.clear();
+    staged.sequences.clear();
+    return true;
+}
+
+bool Database::commitTransaction()
+{
+    METRIC_TIMER("database_commit");
+    TRACE_SPAN("database.commit");
+    if (!staged.open)
+    {
+        return false;
+    }
+
+    FileSet files;
+    std::map<std::string, std::uint64_t> sequences;
+    files.swap(staged.files);
+    sequences.swap(staged.sequences);
+    staged.open = false;
+
+    // The manager locks were released before this commit, so another thread may
+    // have written a later copy of a file meanwhile; that copy already holds this
+    // transaction's changes to it
+    std::lock_guard<std::mutex> lock(fileMutex);
+    for (auto it = files.begin(); it != files.end();)
+    {
+        if (sequences[it->first] < writtenSequence[it->first])
+        {
+            LOG_DEBUGF("Dropped {} from the commit: a later copy is already written", it->first);
+            it = files.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    if (files.empty())
+    {
+        return true;
+    }
+    if (files.size() == 1)
+    {
+        // One file is replaced by a single write anyway; the journal is only
+        // needed to tie several together
+        const auto &file = *files.begin();
+        return writeInOrderLocked(file.first, file.second, sequences[file.first]);
+    }
+
+    // The journal only becomes visible, by rename, once the whole record is written
+    std::string tempPath = journalPath() + ".tmp";
+    std::error_code ec;
+    if (!writeJournal(tempPath, files))
+    {
+        LOG_ERROR("Failed to write transaction journal: " + tempPath);
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    std::filesystem::rename(tempPath, journalPath(), ec);
+    if (ec)
+    {
+        LOG_ERROR("Failed to commit transaction journal: " + ec.message());
+        return false;
+    }
+
+    // If this is interrupted, recoverJournal finishes it on the next start
+    bool applied = true;
+    for (const auto &file : files)
+    {
+        applied = writeInOrderLocked(file.first, file.second, sequences[file.first]) && applied;
+    }
+    if (!applied)
+    {
+        // Committed all the same: the journal holds every file and is replayed
+        // on the next start
+        LOG_ERROR("Committed transaction not applied yet, keeping its journal: " + journalPath());
+        return true;
+    }
+    std::filesystem::remove(journalPath(), ec);
+    LOG_DEBUGF("Committed transaction touching {} files", files.size());
+    return true;
+}
+
+void Database::abortTransaction()
+{
+    staged.open = false;
+    staged.files.clear();
+    staged.sequences.clear();
+}
+
+bool Database::inTransaction() const
+{
+    return staged.open;
+}
+
+bool Database::recoverJournal()
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+
+    // A leftover temp journal was never renamed: its transaction did not commit
+    std::error_code ec;
+    std::filesystem::remove(journalPath() + ".tmp", ec);
+    if (!fileExists("journal.txt"))
+    {
+        return true;
+    }
+
+    FileSet files;
+    if (!readJournal(journalPath(), files))
+    {
+        LOG_ERROR("Discarding unreadable transaction journal: " + journalPath());
+        std::filesystem::remove(journalPath(), ec);
+        return false;
+    }
+
+    bool applied = true;
+    for (const auto &file : files)
+    {
+        applied = writeFileLocked(file.first, file.second) && applied;
+    }
+    if (!applied)
+    {
+        LOG_ERROR("Failed to apply transaction journal, keeping it: " + journalPath());
+        return false;
+    }
+    std::filesystem::remove(journalPath(), ec);
+    LOG_WARNING("Recovered interrupted transaction touching " + std::to_string(files.size()) + " files");
+    return true;
+}
+
 bool Database::createBackup(const std::string &backupDir)
 {
     // Implementation for backup functionality
@@ -213,5 +549,6 @@ void Database::close()
 
 Database::~Database()
 {
-    close();
+    // Runs during static destruction, possibly after the Logger singleton is gone,
+    // so don't call close() and log from here
 }
\ No newline at end of file
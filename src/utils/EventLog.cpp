@@ -0,0 +1,383 @@
+#include "utils/EventLog.h"
+#include "utils/TimestampService.h"
+#include "utils/Utils.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <iostream>
+#include <sstream>
+
+std::unique_ptr<EventLog> EventLog::instance = nullptr;
+std::once_flag EventLog::instanceFlag;
+const char *const EventLog::FILE_MAGIC = "OMEVLOG1";
+
+namespace
+{
+    // Fixed part of a record payload: type + timestamp + 4 x i32 + text length
+    constexpr std::size_t FIXED_PAYLOAD_SIZE = 1 + 8 + 4 * 4 + 2;
+
+    template <typename T>
+    void putLittleEndian(std::string &out, T value)
+    {
+        using U = typename std::make_unsigned<T>::type;
+        U bits = static_cast<U>(value);
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+        }
+    }
+
+    template <typename T>
+    T getLittleEndian(const char *data)
+    {
+        using U = typename std::make_unsigned<T>::type;
+        U bits = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            bits |= static_cast<U>(static_cast<unsigned char>(data[i])) << (8 * i);
+        }
+        return static_cast<T>(bits);
+    }
+}
+
+// EventRecord
+std::string EventRecord::typeToString(EventType type)
+{
+    switch (type)
+    {
+    case EventType::ORDER_CREATED:
+        return "order_created";
+    case EventType::ORDER_STATUS_CHANGED:
+        return "order_status";
+    case EventType::STOCK_UPDATED:
+        return "stock";
+    case EventType::USER_LOGIN:
+        return "login";
+    case EventType::USER_LOGOUT:
+        return "logout";
+    default:
+        return "unknown";
+    }
+}
+
+bool EventRecord::stringToType(const std::string &name, EventType &type)
+{
+    const EventType all[] = {EventType::ORDER_CREATED, EventType::ORDER_STATUS_CHANGED,
+                             EventType::STOCK_UPDATED, EventType::USER_LOGIN, EventType::USER_LOGOUT};
+    for (EventType candidate : all)
+    {
+        if (typeToString(candidate) == name)
+        {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string EventRecord::toString() const
+{
+    std::stringstream ss;
+    ss << TimestampService::formatDateTime(static_cast<std::time_t>(timestamp)) << " "
+       << typeToString(type);
+
+    switch (type)
+    {
+    case EventType::ORDER_CREATED:
+        ss << " order=" << entityId << " customer=" << relatedId;
+        break;
+    case EventType::ORDER_STATUS_CHANGED:
+    case EventType::STOCK_UPDATED:
+        ss << (type == EventType::STOCK_UPDATED ? " product=" : " order=") << entityId
+           << " from=" << oldValue << " to=" << newValue;
+        break;
+    case EventType::USER_LOGIN:
+    case EventType::USER_LOGOUT:
+        ss << " user=" << text;
+        break;
+    }
+    return ss.str();
+}
+
+// EventLog
+EventLog::EventLog() : lastFlushTimestamp(0)
+{
+}
+
+EventLog &EventLog::getInstance()
+{
+    std::call_once(instanceFlag, []
+                   { instance = std::unique_ptr<EventLog>(new EventLog()); });
+    return *instance;
+}
+
+bool EventLog::initialize(const std::string &filename)
+{
+    std::lock_guard<std::mutex> lock(logMutex);
+
+    if (logFile.is_open())
+    {
+        flushBuffer();
+        logFile.close();
+    }
+
+    size_t lastSlash = filename.find_last_of("/\\");
+    if (lastSlash != std::string::npos)
+    {
+        Utils::createDirectory(filename.substr(0, lastSlash));
+    }
+
+    bool isNew = Utils::getFileSize(filename) <= 0;
+    logFile.open(filename, std::ios::binary | std::ios::app);
+    if (!logFile.is_open())
+    {
+        std::cerr << "Failed to open event log: " << filename << std::endl;
+        return false;
+    }
+
+    if (isNew)
+    {
+        logFile.write(FILE_MAGIC, HEADER_SIZE);
+    }
+
+    logFilePath = filename;
+    return true;
+}
+
+bool EventLog::isOpen()
+{
+    std::lock_guard<std::mutex> lock(logMutex);
+    return logFile.is_open();
+}
+
+void EventLog::encode(const EventRecord &event, std::string &out)
+{
+    std::size_t textLength = std::min<std::size_t>(event.text.size(), UINT16_MAX);
+
+    putLittleEndian<std::uint32_t>(out, static_cast<std::uint32_t>(FIXED_PAYLOAD_SIZE + textLength));
+    out.push_back(static_cast<char>(event.type));
+    putLittleEndian<std::int64_t>(out, event.timestamp);
+    putLittleEndian<std::int32_t>(out, event.entityId);
+    putLittleEndian<std::int32_t>(out, event.relatedId);
+    putLittleEndian<std::int32_t>(out, event.oldValue);
+    putLittleEndian<std::int32_t>(out, event.newValue);
+    putLittleEndian<std::uint16_t>(out, static_cast<std::uint16_t>(textLength));
+    out.append(event.text, 0, textLength);
+}
+
+void EventLog::record(const EventRecord &event)
+{
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (!logFile.is_open())
+    {
+        return;
+    }
+
+    encode(event, buffer);
+
+    // Hand buffered events to the OS at least once per second so a crash loses little
+    if (buffer.size() >= FLUSH_THRESHOLD || event.timestamp != lastFlushTimestamp)
+    {
+        flushBuffer();
+        lastFlushTimestamp = event.timestamp;
+    }
+}
+
+void EventLog::recordOrderCreated(int orderId, int customerId)
+{
+    EventRecord event;
+    event.type = EventType::ORDER_CREATED;
+    event.timestamp = TimestampService::getInstance().epochSeconds();
+    event.entityId = orderId;
+    event.relatedId = customerId;
+    record(event);
+}
+
+void EventLog::recordOrderStatusChanged(int orderId, int oldStatus, int newStatus)
+{
+    EventRecord event;
+    event.type = EventType::ORDER_STATUS_CHANGED;
+    event.timestamp = TimestampService::getInstance().epochSeconds();
+    event.entityId = orderId;
+    event.oldValue = oldStatus;
+    event.newValue = newStatus;
+    record(event);
+}
+
+void EventLog::recordStockUpdate(int productId, int oldStock, int newStock)
+{
+    EventRecord event;
+    event.type = EventType::STOCK_UPDATED;
+    event.timestamp = TimestampService::getInstance().epochSeconds();
+    event.entityId = productId;
+    event.oldValue = oldStock;
+    event.newValue = newStock;
+    record(event);
+}
+
+void EventLog::recordUserLogin(const std::string &username)
+{
+    EventRecord event;
+    event.type = EventType::USER_LOGIN;
+    event.timestamp = TimestampService::getInstance().epochSeconds();
+    event.text = username;
+    record(event);
+}
+
+void EventLog::recordUserLogout(const std::string &username)
+{
+    EventRecord event;
+    event.type = EventType::USER_LOGOUT;
+    event.timestamp = TimestampService::getInstance().epochSeconds();
+    event.text = username;
+    record(event);
+}
+
+void EventLog::flushBuffer()
+{
+    if (!buffer.empty() && logFile.is_open())
+    {
+        logFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        logFile.flush();
+    }
+    buffer.clear();
+}
+
+void EventLog::flush()
+{
+    std::lock_guard<std::mutex> lock(logMutex);
+    flushBuffer();
+}
+
+void EventLog::close()
+{
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (logFile.is_open())
+    {
+        flushBuffer();
+        logFile.close();
+    }
+}
+
+EventLog::~EventLog()
+{
+    close();
+}
+
+// EventFilter
+bool EventFilter::matches(const EventRecord &event) const
+{
+    return (!hasType || event.type == type) &&
+           (entityId < 0 || event.entityId == entityId) &&
+           event.timestamp >= fromTimestamp &&
+           event.timestamp <= toTimestamp;
+}
+
+// EventLogReader
+EventLogReader::EventLogReader(const std::string &filename)
+    : filename(filename), corruptRecords(0)
+{
+}
+
+bool EventLogReader::decode(const char *payload, std::size_t length, EventRecord &event)
+{
+    if (length < FIXED_PAYLOAD_SIZE)
+    {
+        return false;
+    }
+
+    event.type = static_cast<EventType>(static_cast<unsigned char>(payload[0]));
+    event.timestamp = getLittleEndian<std::int64_t>(payload + 1);
+    event.entityId = getLittleEndian<std::int32_t>(payload + 9);
+    event.relatedId = getLittleEndian<std::int32_t>(payload + 13);
+    event.oldValue = getLittleEndian<std::int32_t>(payload + 17);
+    event.newValue = getLittleEndian<std::int32_t>(payload + 21);
+    std::uint16_t textLength = getLittleEndian<std::uint16_t>(payload + 25);
+
+    if (FIXED_PAYLOAD_SIZE + textLength > length)
+    {
+        return false;
+    }
+    event.text.assign(payload + FIXED_PAYLOAD_SIZE, textLength);
+    return true;
+}
+
+bool EventLogReader::forEach(const std::function<bool(const EventRecord &)> &visitor,
+                             const EventFilter &filter)
+{
+    corruptRecords = 0;
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    char header[EventLog::HEADER_SIZE];
+    if (!file.read(header, EventLog::HEADER_SIZE) ||
+        std::memcmp(header, EventLog::FILE_MAGIC, EventLog::HEADER_SIZE) != 0)
+    {
+        return false;
+    }
+
+    // Read in large chunks and carry any partial record over to the next chunk
+    const std::size_t chunkSize = 1 << 20;
+    std::vector<char> chunk;
+    std::size_t used = 0;
+    EventRecord event;
+
+    while (true)
+    {
+        chunk.resize(used + chunkSize);
+        file.read(chunk.data() + used, static_cast<std::streamsize>(chunkSize));
+        std::size_t available = used + static_cast<std::size_t>(file.gcount());
+        if (available == used)
+        {
+            break;
+        }
+
+        std::size_t offset = 0;
+        while (available - offset >= 4)
+        {
+            std::uint32_t length = getLittleEndian<std::uint32_t>(chunk.data() + offset);
+            if (available - offset - 4 < length)
+            {
+                break;
+            }
+
+            const char *payload = chunk.data() + offset + 4;
+            offset += 4 + length;
+
+            if (!decode(payload, length, event))
+            {
+                ++corruptRecords;
+                continue;
+            }
+            if (filter.matches(event) && !visitor(event))
+            {
+                return true;
+            }
+        }
+
+        used = available - offset;
+        std::memmove(chunk.data(), chunk.data() + offset, used);
+    }
+
+    if (used > 0)
+    {
+        // Trailing bytes from a record that was never completely written
+        ++corruptRecords;
+    }
+    return true;
+}
+
+std::vector<EventRecord> EventLogReader::readAll(const EventFilter &filter)
+{
+    std::vector<EventRecord> events;
+    forEach([&events](const EventRecord &event)
+            {
+                events.push_back(event);
+                return true; },
+            filter);
+    return events;
+}
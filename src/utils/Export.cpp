@@ -0,0 +1,202 @@
+#include "utils/Export.h"
+#include "utils/Csv.h"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+namespace Export
+{
+    Encoder::Encoder(Format format, const std::vector<std::string> &columns, std::string &out)
+        : format(format), columns(columns), out(out), column(0)
+    {
+    }
+
+    void Encoder::beginRecord()
+    {
+        column = 0;
+        if (format == Format::JSONL)
+        {
+            out += '{';
+        }
+    }
+
+    void Encoder::endRecord()
+    {
+        if (format == Format::JSONL)
+        {
+            out += '}';
+        }
+        out += '\n';
+    }
+
+    void Encoder::nextField()
+    {
+        if (column > 0)
+        {
+            out += ',';
+        }
+        if (format == Format::JSONL)
+        {
+            out += '"';
+            out += columns[column];
+            out += "\":";
+        }
+        ++column;
+    }
+
+    void Encoder::text(std::string_view value)
+    {
+        nextField();
+        if (format == Format::CSV)
+        {
+            Csv::appendField(out, value);
+            return;
+        }
+
+        out += '"';
+        for (char c : value)
+        {
+            switch (c)
+            {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
+
+    void Encoder::integer(long long value)
+    {
+        nextField();
+        char digits[24];
+        out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+    }
+
+    void Encoder::decimal(double value)
+    {
+        nextField();
+        if (!std::isfinite(value))
+        {
+            out += format == Format::JSONL ? "null" : "";
+            return;
+        }
+        // Shortest text that reads back as the same double, e.g. 29.99
+        char digits[32];
+        out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+    }
+
+    void Encoder::boolean(bool value)
+    {
+        nextField();
+        if (format == Format::JSONL)
+        {
+            out += value ? "true" : "false";
+        }
+        else
+        {
+            out += value ? '1' : '0';
+        }
+    }
+
+    std::string header(Format format, const std::vector<std::string> &columns)
+    {
+        std::string text;
+        if (format == Format::CSV)
+        {
+            for (size_t i = 0; i < columns.size(); ++i)
+            {
+                if (i > 0)
+                {
+                    text += ',';
+                }
+                Csv::appendField(text, columns[i]);
+            }
+            text += '\n';
+        }
+        return text;
+    }
+
+    std::string Report::summary() const
+    {
+        double rate = seconds > 0 ? records / seconds : 0.0;
+        double megabytes = bytes / (1024.0 * 1024.0);
+        char text[160];
+        std::snprintf(text, sizeof(text), "Exported %zu records (%.1f MB) in %.2f s: %.0f records/s, %.1f MB/s",
+                      records, megabytes, seconds, rate, seconds > 0 ? megabytes / seconds : 0.0);
+        return text;
+    }
+
+    namespace detail
+    {
+        Output::Output(const std::string &filename)
+            : filename(filename), partName(filename + ".part"), bytes(0)
+        {
+            out.open(partName, std::ios::binary | std::ios::trunc);
+        }
+
+        Output::~Output()
+        {
+            if (out.is_open())
+            {
+                // Not committed: leave no partial file behind
+                out.close();
+                std::remove(partName.c_str());
+            }
+        }
+
+        void Output::write(const std::string &text)
+        {
+            TRACE_SPAN("export.write");
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            bytes += text.size();
+        }
+
+        bool Output::commit(std::string &error)
+        {
+            TRACE_SPAN("export.commit");
+            out.close();
+            if (!out)
+            {
+                error = "cannot write " + partName;
+                std::remove(partName.c_str());
+                return false;
+            }
+            // std::filesystem::rename replaces an existing file on every platform,
+            // where std::rename fails on Windows
+            std::error_code ec;
+            std::filesystem::rename(partName, filename, ec);
+            if (ec)
+            {
+                error = "cannot rename " + partName + " to " + filename + ": " + ec.message();
+                std::filesystem::remove(partName, ec);
+                return false;
+            }
+            return true;
+        }
+    }
+}
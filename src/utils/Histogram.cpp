@@ -0,0 +1,115 @@
+#include "utils/Histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    int highestBit(std::uint64_t value)
+    {
+        int bit = 0;
+        while (value >>= 1)
+        {
+            ++bit;
+        }
+        return bit;
+    }
+}
+
+// Values below SUB_COUNT have a bucket each. Above that, the power of two 2^e
+// (e >= SUB_BITS) is block e - SUB_BITS + 1 of SUB_COUNT buckets, each
+// 2^(e - SUB_BITS) wide.
+size_t Histogram::bucketOf(std::uint64_t value)
+{
+    if (value < SUB_COUNT)
+    {
+        return static_cast<size_t>(value);
+    }
+    int shift = highestBit(value) - SUB_BITS;
+    std::uint64_t sub = (value >> shift) - SUB_COUNT;
+    return static_cast<size_t>((shift + 1) * SUB_COUNT + sub);
+}
+
+std::uint64_t Histogram::bucketTop(size_t bucket)
+{
+    if (bucket < SUB_COUNT)
+    {
+        return bucket;
+    }
+    int shift = static_cast<int>(bucket / SUB_COUNT) - 1;
+    std::uint64_t bottom = (SUB_COUNT + bucket % SUB_COUNT) << shift;
+    return bottom + ((std::uint64_t(1) << shift) - 1);
+}
+
+Histogram::Histogram()
+    : counts(BUCKET_COUNT, 0), total(0),
+      minValue(std::numeric_limits<std::uint64_t>::max()), maxValue(0), sum(0)
+{
+}
+
+void Histogram::record(std::uint64_t value)
+{
+    ++counts[bucketOf(value)];
+    ++total;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    sum += value;
+}
+
+void Histogram::record(std::uint64_t value, std::uint64_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    counts[bucketOf(value)] += count;
+    total += count;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    sum += static_cast<long double>(value) * count;
+}
+
+void Histogram::merge(const Histogram &other)
+{
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sum += other.sum;
+}
+
+void Histogram::reset()
+{
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    minValue = std::numeric_limits<std::uint64_t>::max();
+    maxValue = 0;
+    sum = 0;
+}
+
+std::uint64_t Histogram::percentile(double percent) const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    // Rank of the value wanted, counting from 1
+    double clamped = std::min(100.0, std::max(0.0, percent));
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total)));
+    rank = std::max<std::uint64_t>(rank, 1);
+
+    std::uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts.size(); ++bucket)
+    {
+        seen += counts[bucket];
+        if (seen >= rank)
+        {
+            return std::min(bucketTop(bucket), maxValue);
+        }
+    }
+    return maxValue;
+}
@@ -0,0 +1,258 @@
+#include "utils/LogRotator.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#ifdef ORDERMGMT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+
+LogRotator::LogRotator() : stopRequested(false), workerBusy(false)
+{
+}
+
+LogRotator::~LogRotator()
+{
+    stop();
+}
+
+bool LogRotator::compressionAvailable()
+{
+#ifdef ORDERMGMT_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LogRotator::setPolicy(const LogRotationPolicy &newPolicy)
+{
+    std::lock_guard<std::mutex> lock(workMutex);
+    policy = newPolicy;
+}
+
+LogRotationPolicy LogRotator::getPolicy() const
+{
+    std::lock_guard<std::mutex> lock(workMutex);
+    return policy;
+}
+
+bool LogRotator::shouldRotate(std::uint64_t currentBytes, std::uint64_t lineBytes,
+                              const std::string &fileDay, const std::string &recordDay) const
+{
+    std::uint64_t maxFileBytes;
+    bool rotateDaily;
+    {
+        std::lock_guard<std::mutex> lock(workMutex);
+        maxFileBytes = policy.maxFileBytes;
+        rotateDaily = policy.rotateDaily;
+    }
+
+    if (maxFileBytes > 0 && currentBytes > 0 && currentBytes + lineBytes > maxFileBytes)
+    {
+        return true;
+    }
+
+    return rotateDaily && !fileDay.empty() && recordDay != fileDay;
+}
+
+std::string LogRotator::nextRotatedPath(const std::string &stamp) const
+{
+    // logs/application.log -> logs/application.20261018-102203.log
+    fs::path active(activePath);
+    fs::path base = active.parent_path() / active.stem();
+    std::string extension = active.extension().string();
+
+    std::string candidate = base.string() + "." + stamp + extension;
+    for (int suffix = 1; fs::exists(candidate) || fs::exists(candidate + ".gz"); ++suffix)
+    {
+        candidate = base.string() + "." + stamp + "-" + std::to_string(suffix) + extension;
+    }
+    return candidate;
+}
+
+bool LogRotator::rotate(const std::string &stamp)
+{
+    std::error_code ec;
+    if (!fs::exists(activePath, ec))
+    {
+        return false;
+    }
+
+    std::string rotatedPath = nextRotatedPath(stamp);
+    fs::rename(activePath, rotatedPath, ec);
+    if (ec)
+    {
+        std::cerr << "Failed to rotate log file " << activePath << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(workMutex);
+        pendingFiles.push_back(rotatedPath);
+        if (!workerThread.joinable())
+        {
+            stopRequested = false;
+            workerThread = std::thread(&LogRotator::workerLoop, this);
+        }
+    }
+    workCondition.notify_all();
+    return true;
+}
+
+void LogRotator::workerLoop()
+{
+    while (true)
+    {
+        std::string path;
+        {
+            std::unique_lock<std::mutex> lock(workMutex);
+            workCondition.wait(lock, [this]
+                               { return stopRequested || !pendingFiles.empty(); });
+            if (pendingFiles.empty())
+            {
+                break;
+            }
+            path = pendingFiles.front();
+            pendingFiles.pop_front();
+            workerBusy = true;
+        }
+
+        processRotatedFile(path);
+
+        {
+            std::lock_guard<std::mutex> lock(workMutex);
+            workerBusy = false;
+        }
+        workCondition.notify_all();
+    }
+}
+
+void LogRotator::processRotatedFile(const std::string &path)
+{
+    LogRotationPolicy current = getPolicy();
+    if (current.compress && compressionAvailable())
+    {
+        std::string compressedPath = path + ".gz";
+        if (compressFile(path, compressedPath))
+        {
+            std::error_code ec;
+            fs::remove(path, ec);
+        }
+        else
+        {
+            std::error_code ec;
+            fs::remove(compressedPath, ec);
+        }
+    }
+
+    enforceRetention(current.maxRotatedFiles);
+}
+
+bool LogRotator::compressFile(const std::string &source, const std::string &destination)
+{
+#ifdef ORDERMGMT_HAVE_ZLIB
+    std::ifstream input(source, std::ios::binary);
+    if (!input.is_open())
+    {
+        return false;
+    }
+
+    gzFile output = gzopen(destination.c_str(), "wb6");
+    if (!output)
+    {
+        return false;
+    }
+
+    std::vector<char> buffer(1 << 16);
+    bool ok = true;
+    while (ok && input)
+    {
+        input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize count = input.gcount();
+        if (count > 0 && gzwrite(output, buffer.data(), static_cast<unsigned>(count)) != count)
+        {
+            ok = false;
+        }
+    }
+
+    return gzclose(output) == Z_OK && ok;
+#else
+    (void)source;
+    (void)destination;
+    return false;
+#endif
+}
+
+void LogRotator::enforceRetention(int maxRotatedFiles)
+{
+    if (maxRotatedFiles <= 0)
+    {
+        return;
+    }
+
+    fs::path active(activePath);
+    fs::path directory = active.parent_path().empty() ? fs::path(".") : active.parent_path();
+    std::string activeName = active.filename().string();
+    std::string prefix = active.stem().string() + ".";
+    std::string extension = active.extension().string();
+
+    std::vector<fs::directory_entry> rotated;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(directory, ec))
+    {
+        std::string name = entry.path().filename().string();
+        bool isRotated = name.compare(0, prefix.size(), prefix) == 0 &&
+                         name != activeName &&
+                         (name.find(extension + ".gz") != std::string::npos ||
+                          (name.size() > extension.size() &&
+                           name.compare(name.size() - extension.size(), extension.size(), extension) == 0));
+        if (entry.is_regular_file() && isRotated)
+        {
+            rotated.push_back(entry);
+        }
+    }
+
+    if (static_cast<int>(rotated.size()) <= maxRotatedFiles)
+    {
+        return;
+    }
+
+    // Oldest first
+    std::sort(rotated.begin(), rotated.end(),
+              [](const fs::directory_entry &a, const fs::directory_entry &b)
+              {
+                  std::error_code ea, eb;
+                  return fs::last_write_time(a.path(), ea) < fs::last_write_time(b.path(), eb);
+              });
+
+    size_t excess = rotated.size() - static_cast<size_t>(maxRotatedFiles);
+    for (size_t i = 0; i < excess; ++i)
+    {
+        fs::remove(rotated[i].path(), ec);
+    }
+}
+
+void LogRotator::waitForIdle()
+{
+    std::unique_lock<std::mutex> lock(workMutex);
+    workCondition.wait(lock, [this]
+                       { return (pendingFiles.empty() && !workerBusy) || !workerThread.joinable(); });
+}
+
+void LogRotator::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(workMutex);
+        if (!workerThread.joinable())
+        {
+            return;
+        }
+        stopRequested = true;
+    }
+    workCondition.notify_all();
+    workerThread.join();
+}
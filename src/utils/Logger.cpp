@@ -1,20 +1,38 @@
 #include "utils/Logger.h"
 #include "utils/Utils.h"
+#include "utils/TimestampService.h"
 #include <iostream>
 #include <iomanip>
+#include <sys/stat.h>
 
 std::unique_ptr<Logger> Logger::instance = nullptr;
+std::once_flag Logger::instanceFlag;
 
-Logger::Logger() : currentLogLevel(LogLevel::INFO)
+namespace
+{
+    // "YYYY-MM-DD HH:MM:SS" -> "YYYYMMDD-HHMMSS", used in rotated file names
+    std::string toRotationStamp(const std::string &timestamp)
+    {
+        std::string stamp;
+        for (char ch : timestamp)
+        {
+            if (ch == ' ')
+                stamp += '-';
+            else if (ch != '-' && ch != ':')
+                stamp += ch;
+        }
+        return stamp;
+    }
+}
+
+Logger::Logger() : currentLogLevel(LogLevel::INFO), currentFileBytes(0), writerRunning(false), stopRequested(false), writerBusy(false)
 {
 }
 
 Logger &Logger::getInstance()
 {
-    if (!instance)
-    {
-        instance = std::unique_ptr<Logger>(new Logger());
-    }
+    std::call_once(instanceFlag, []
+                   { instance = std::unique_ptr<Logger>(new Logger()); });
     return *instance;
 }
 
@@ -31,20 +49,65 @@ bool Logger::initialize(const std::string &filename, LogLevel level)
         Utils::createDirectory(directory);
     }
 
-    logFile.open(filename, std::ios::app);
-    if (!logFile.is_open())
+    stopWriter();
+    if (logFile.is_open())
+    {
+        logFile.close();
+    }
+
+    rotator.setActivePath(filename);
+
+    // A file left over from an earlier day is rotated before we append to it
+    struct stat info;
+    if (rotator.getPolicy().rotateDaily && stat(filename.c_str(), &info) == 0 && info.st_size > 0)
+    {
+        std::string fileTimestamp = TimestampService::formatDateTime(info.st_mtime);
+        if (fileTimestamp.substr(0, 10) != getCurrentTimestamp().substr(0, 10))
+        {
+            rotator.rotate(toRotationStamp(fileTimestamp));
+        }
+    }
+
+    if (!openLogFile())
     {
-        std::cerr << "Failed to open log file: " << filename << std::endl;
         return false;
     }
 
+    startWriter();
     log(LogLevel::INFO, "Logger initialized - Application started");
     return true;
 }
 
+bool Logger::openLogFile()
+{
+    logFile.open(logFilePath, std::ios::app);
+    if (!logFile.is_open())
+    {
+        std::cerr << "Failed to open log file: " << logFilePath << std::endl;
+        return false;
+    }
+
+    long long existingSize = Utils::getFileSize(logFilePath);
+    currentFileBytes = existingSize > 0 ? static_cast<std::uint64_t>(existingSize) : 0;
+    currentFileDay = getCurrentTimestamp().substr(0, 10);
+    return true;
+}
+
+void Logger::rotateLogFile(const std::string &timestamp)
+{
+    // Runs on the writer thread: callers keep queueing records while the file is swapped
+    logFile.flush();
+    logFile.close();
+
+    rotator.rotate(toRotationStamp(timestamp));
+
+    openLogFile();
+    currentFileDay = timestamp.substr(0, 10);
+}
+
 std::string Logger::getCurrentTimestamp() const
 {
-    return Utils::getCurrentDateTime();
+    return TimestampService::getInstance().now();
 }
 
 std::string Logger::logLevelToString(LogLevel level) const
@@ -68,23 +131,128 @@ std::string Logger::logLevelToString(LogLevel level) const
 
 void Logger::log(LogLevel level, const std::string &message)
 {
-    if (level < currentLogLevel || !logFile.is_open())
+    if (!isEnabled(level))
+    {
+        return;
+    }
+
+    LogRecord record;
+    record.level = level;
+    record.timestamp = getCurrentTimestamp();
+    record.message = message;
+    enqueue(std::move(record));
+}
+
+void Logger::enqueue(LogRecord record)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pendingRecords.push_back(std::move(record));
+    }
+    queueCondition.notify_one();
+}
+
+void Logger::startWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopRequested = false;
+    }
+    writerRunning = true;
+    writerThread = std::thread(&Logger::writerLoop, this);
+}
+
+void Logger::stopWriter()
+{
+    if (!writerThread.joinable())
     {
         return;
     }
 
-    std::string timestamp = getCurrentTimestamp();
-    std::string levelStr = logLevelToString(level);
+    writerRunning = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopRequested = true;
+    }
+    queueCondition.notify_all();
+    drainedCondition.notify_all();
+    writerThread.join();
+}
+
+void Logger::writerLoop()
+{
+    std::deque<LogRecord> batch;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]
+                                { return stopRequested || !pendingRecords.empty(); });
+
+            if (pendingRecords.empty() && stopRequested)
+            {
+                break;
+            }
+            batch.swap(pendingRecords);
+            writerBusy = true;
+        }
+
+        writeRecords(batch);
+        batch.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            writerBusy = false;
+        }
+        // Wake any flush() callers waiting for the queue to drain
+        drainedCondition.notify_all();
+    }
+}
+
+void Logger::writeRecords(std::deque<LogRecord> &records)
+{
+    std::string line;
+    for (auto &record : records)
+    {
+        const std::string &message = record.formatter ? (record.message = record.formatter()) : record.message;
+        std::string levelStr = logLevelToString(record.level);
+
+        // Format: [TIMESTAMP] [LEVEL] MESSAGE
+        line.clear();
+        line.append("[").append(record.timestamp).append("] [").append(levelStr).append("] ");
+        line.append(message).append("\n");
+
+        if (rotator.shouldRotate(currentFileBytes, line.size(), currentFileDay, record.timestamp.substr(0, 10)))
+        {
+            rotateLogFile(record.timestamp);
+        }
 
-    // Format: [TIMESTAMP] [LEVEL] MESSAGE
-    logFile << "[" << timestamp << "] [" << levelStr << "] " << message << std::endl;
+        if (logFile.is_open())
+        {
+            logFile << line;
+            currentFileBytes += line.size();
+        }
+
+        // Also output to console for errors and critical messages
+        if (record.level >= LogLevel::ERROR)
+        {
+            std::cerr << line << std::flush;
+        }
+    }
     logFile.flush();
+}
 
-    // Also output to console for errors and critical messages
-    if (level >= LogLevel::ERROR)
+void Logger::flush()
+{
+    if (!writerThread.joinable())
     {
-        std::cerr << "[" << timestamp << "] [" << levelStr << "] " << message << std::endl;
+        return;
     }
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    drainedCondition.wait(lock, [this]
+                          { return (pendingRecords.empty() && !writerBusy) || stopRequested; });
 }
 
 void Logger::debug(const std::string &message)
@@ -147,8 +315,10 @@ void Logger::close()
     if (logFile.is_open())
     {
         log(LogLevel::INFO, "Logger closing - Application shutdown");
+        stopWriter();
         logFile.close();
     }
+    rotator.stop();
 }
 
 Logger::~Logger()
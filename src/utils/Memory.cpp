@@ -0,0 +1,47 @@
+#include "utils/Memory.h"
+#include <cstring>
+
+void MemoryUsage::addString(const char *field, const std::string &value)
+{
+    size_t bytes = Memory::stringHeapBytes(value);
+    stringBytes += bytes;
+    addField(field, bytes);
+}
+
+void MemoryUsage::addField(const char *field, size_t bytes)
+{
+    // A handful of fields per record type, so a linear scan beats a map. Callers
+    // pass the same literal each time, so comparing pointers almost always hits.
+    for (auto &entry : fields)
+    {
+        if (entry.first == field)
+        {
+            entry.second += bytes;
+            return;
+        }
+    }
+    for (auto &entry : fields)
+    {
+        if (std::strcmp(entry.first, field) == 0)
+        {
+            entry.second += bytes;
+            return;
+        }
+    }
+    fields.emplace_back(field, bytes);
+}
+
+namespace Memory
+{
+    size_t stringHeapBytes(const std::string &value)
+    {
+        // Short strings live in a buffer inside the string object itself
+        const char *data = value.data();
+        const char *self = reinterpret_cast<const char *>(&value);
+        if (data >= self && data < self + sizeof(std::string))
+        {
+            return 0;
+        }
+        return value.capacity() + 1;
+    }
+}
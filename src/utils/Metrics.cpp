@@ -0,0 +1,247 @@
+#include "utils/Metrics.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+std::unique_ptr<Metrics> Metrics::instance = nullptr;
+std::once_flag Metrics::instanceFlag;
+
+namespace
+{
+    const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+    void appendNumber(std::string &out, const char *format, double value)
+    {
+        char text[64];
+        std::snprintf(text, sizeof(text), format, value);
+        out += text;
+    }
+}
+
+LatencyHistogram::LatencyHistogram()
+    : counts(new std::atomic<std::uint64_t>[Histogram::BUCKET_COUNT]), total(0), sum(0), maxValue(0)
+{
+    for (size_t i = 0; i < Histogram::BUCKET_COUNT; ++i)
+    {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds)
+{
+    counts[Histogram::bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    std::uint64_t seen = maxValue.load(std::memory_order_relaxed);
+    while (nanoseconds > seen && !maxValue.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+Histogram LatencyHistogram::snapshot() const
+{
+    Histogram copy;
+    std::uint64_t max = maxValue.load(std::memory_order_relaxed);
+    for (size_t bucket = 0; bucket < Histogram::BUCKET_COUNT; ++bucket)
+    {
+        std::uint64_t count = counts[bucket].load(std::memory_order_relaxed);
+        if (count > 0)
+        {
+            copy.record(std::min(Histogram::bucketTop(bucket), max), count);
+        }
+    }
+    return copy;
+}
+
+void LatencyHistogram::reset()
+{
+    for (size_t i = 0; i < Histogram::BUCKET_COUNT; ++i)
+    {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    maxValue.store(0, std::memory_order_relaxed);
+}
+
+Metrics::Metrics() : stopRequested(false)
+{
+}
+
+Metrics::~Metrics()
+{
+    stopDump();
+}
+
+Metrics &Metrics::getInstance()
+{
+    std::call_once(instanceFlag, []
+                   { instance = std::unique_ptr<Metrics>(new Metrics()); });
+    return *instance;
+}
+
+Counter &Metrics::counter(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::unique_ptr<Counter> &slot = counters[name];
+    if (!slot)
+    {
+        slot = std::make_unique<Counter>();
+    }
+    return *slot;
+}
+
+LatencyHistogram &Metrics::latency(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::unique_ptr<LatencyHistogram> &slot = latencies[name];
+    if (!slot)
+    {
+        slot = std::make_unique<LatencyHistogram>();
+    }
+    return *slot;
+}
+
+std::vector<std::pair<std::string, std::uint64_t>> Metrics::counterValues()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<std::pair<std::string, std::uint64_t>> values;
+    for (const auto &entry : counters)
+    {
+        values.emplace_back(entry.first, entry.second->get());
+    }
+    return values;
+}
+
+std::vector<std::pair<std::string, Histogram>> Metrics::latencySnapshots()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<std::pair<std::string, Histogram>> snapshots;
+    for (const auto &entry : latencies)
+    {
+        snapshots.emplace_back(entry.first, entry.second->snapshot());
+    }
+    return snapshots;
+}
+
+std::string Metrics::prometheusText()
+{
+    std::string text;
+    for (const auto &entry : counterValues())
+    {
+        std::string name = "ordermgmt_" + entry.first + "_total";
+        text += "# TYPE " + name + " counter\n";
+        text += name + " " + std::to_string(entry.second) + "\n";
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (!latencies.empty())
+    {
+        text += "# HELP ordermgmt_operation_duration_seconds Latency of manager and database operations\n";
+        text += "# TYPE ordermgmt_operation_duration_seconds summary\n";
+    }
+    for (const auto &entry : latencies)
+    {
+        const std::string label = "operation=\"" + entry.first + "\"";
+        Histogram histogram = entry.second->snapshot();
+        for (double quantile : QUANTILES)
+        {
+            text += "ordermgmt_operation_duration_seconds{" + label + ",quantile=\"";
+            appendNumber(text, "%g", quantile);
+            text += "\"} ";
+            appendNumber(text, "%.9g", histogram.percentile(quantile * 100) / 1e9);
+            text += "\n";
+        }
+        // Read after the snapshot, so it may include a few more records than the count
+        text += "ordermgmt_operation_duration_seconds_sum{" + label + "} ";
+        appendNumber(text, "%.9g", entry.second->getSum() / 1e9);
+        text += "\nordermgmt_operation_duration_seconds_count{" + label + "} " +
+                std::to_string(histogram.getCount()) + "\n";
+    }
+    return text;
+}
+
+bool Metrics::writePrometheus(const std::string &filename)
+{
+    std::string tempPath = filename + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+        out << prometheusText();
+        if (!out.flush())
+        {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, filename, ec);
+    return !ec;
+}
+
+bool Metrics::startDump(const std::string &filename, std::chrono::milliseconds interval)
+{
+    stopDump();
+    if (interval.count() <= 0 || !writePrometheus(filename))
+    {
+        LOG_ERROR("Cannot write metrics to " + filename);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex);
+        stopRequested = false;
+    }
+    dumpThread = std::thread(&Metrics::dumpLoop, this, filename, interval);
+    return true;
+}
+
+void Metrics::stopDump()
+{
+    if (!dumpThread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex);
+        stopRequested = true;
+    }
+    dumpCondition.notify_all();
+    dumpThread.join();
+}
+
+void Metrics::dumpLoop(std::string filename, std::chrono::milliseconds interval)
+{
+    std::unique_lock<std::mutex> lock(dumpMutex);
+    while (!dumpCondition.wait_for(lock, interval, [this]
+                                   { return stopRequested; }))
+    {
+        lock.unlock();
+        writePrometheus(filename);
+        lock.lock();
+    }
+    lock.unlock();
+
+    // One last write, so the file covers the whole run
+    writePrometheus(filename);
+}
+
+void Metrics::reset()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto &entry : counters)
+    {
+        entry.second->reset();
+    }
+    for (auto &entry : latencies)
+    {
+        entry.second->reset();
+    }
+}
@@ -0,0 +1,292 @@
+#include "utils/Query.h"
+#include "utils/Utils.h"
+#include <cctype>
+#include <sstream>
+
+namespace
+{
+    char lower(char c)
+    {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    bool containsIgnoreCase(std::string_view text, std::string_view part)
+    {
+        return std::search(text.begin(), text.end(), part.begin(), part.end(),
+                           [](char a, char b)
+                           { return lower(a) == lower(b); }) != text.end();
+    }
+
+    const char *kindName(Predicate::Kind kind)
+    {
+        switch (kind)
+        {
+        case Predicate::Kind::AND:
+            return " AND ";
+        case Predicate::Kind::OR:
+            return " OR ";
+        default:
+            return "";
+        }
+    }
+}
+
+namespace QueryValues
+{
+    int compare(const FieldValue &a, const FieldValue &b)
+    {
+        if (a.index() != b.index())
+        {
+            return a.index() < b.index() ? -1 : 1;
+        }
+
+        if (const double *number = std::get_if<double>(&a))
+        {
+            double other = std::get<double>(b);
+            return *number < other ? -1 : (*number > other ? 1 : 0);
+        }
+
+        std::string_view left = std::get<std::string_view>(a);
+        std::string_view right = std::get<std::string_view>(b);
+        size_t common = std::min(left.size(), right.size());
+        for (size_t i = 0; i < common; ++i)
+        {
+            char l = lower(left[i]);
+            char r = lower(right[i]);
+            if (l != r)
+            {
+                return l < r ? -1 : 1;
+            }
+        }
+        return left.size() < right.size() ? -1 : (left.size() > right.size() ? 1 : 0);
+    }
+
+    FieldValue view(const QueryValue &value)
+    {
+        if (const double *number = std::get_if<double>(&value))
+        {
+            return *number;
+        }
+        return std::string_view(std::get<std::string>(value));
+    }
+
+    std::string toString(const QueryValue &value)
+    {
+        if (const double *number = std::get_if<double>(&value))
+        {
+            std::ostringstream oss;
+            oss << *number;
+            return oss.str();
+        }
+        return "'" + std::get<std::string>(value) + "'";
+    }
+}
+
+Predicate Predicate::eq(const std::string &field, const QueryValue &value)
+{
+    Predicate predicate;
+    predicate.kind = Kind::EQ;
+    predicate.field = field;
+    predicate.values = {value};
+    return predicate;
+}
+
+Predicate Predicate::range(const std::string &field, const QueryValue &min, const QueryValue &max)
+{
+    Predicate predicate;
+    predicate.kind = Kind::RANGE;
+    predicate.field = field;
+    predicate.values = {min, max};
+    return predicate;
+}
+
+Predicate Predicate::contains(const std::string &field, const std::string &text)
+{
+    Predicate predicate;
+    predicate.kind = Kind::CONTAINS;
+    predicate.field = field;
+    predicate.values = {text};
+    return predicate;
+}
+
+Predicate Predicate::in(const std::string &field, const std::vector<QueryValue> &values)
+{
+    Predicate predicate;
+    predicate.kind = Kind::IN;
+    predicate.field = field;
+    predicate.values = values;
+    return predicate;
+}
+
+Predicate Predicate::combine(Kind kind, const Predicate &left, const Predicate &right)
+{
+    if (left.kind == Kind::ALL)
+    {
+        return kind == Kind::AND ? right : left;
+    }
+    if (right.kind == Kind::ALL)
+    {
+        return kind == Kind::AND ? left : right;
+    }
+
+    // Flatten so (a AND b) AND c plans as three conjuncts
+    Predicate predicate;
+    predicate.kind = kind;
+    for (const Predicate *side : {&left, &right})
+    {
+        if (side->kind == kind)
+        {
+            predicate.children.insert(predicate.children.end(), side->children.begin(), side->children.end());
+        }
+        else
+        {
+            predicate.children.push_back(*side);
+        }
+    }
+    return predicate;
+}
+
+Predicate Predicate::operator&&(const Predicate &other) const
+{
+    return combine(Kind::AND, *this, other);
+}
+
+Predicate Predicate::operator||(const Predicate &other) const
+{
+    return combine(Kind::OR, *this, other);
+}
+
+bool Predicate::matches(const FieldValue &value) const
+{
+    switch (kind)
+    {
+    case Kind::EQ:
+        return QueryValues::compare(value, QueryValues::view(values[0])) == 0;
+    case Kind::RANGE:
+        return QueryValues::compare(value, QueryValues::view(values[0])) >= 0 &&
+               QueryValues::compare(value, QueryValues::view(values[1])) <= 0;
+    case Kind::CONTAINS:
+    {
+        const std::string_view *text = std::get_if<std::string_view>(&value);
+        return text && containsIgnoreCase(*text, std::get<std::string>(values[0]));
+    }
+    case Kind::IN:
+        return std::any_of(values.begin(), values.end(),
+                           [&value](const QueryValue &candidate)
+                           { return QueryValues::compare(value, QueryValues::view(candidate)) == 0; });
+    default:
+        return true;
+    }
+}
+
+std::vector<Predicate> Predicate::conjuncts() const
+{
+    if (kind == Kind::ALL)
+    {
+        return {};
+    }
+    if (kind == Kind::AND)
+    {
+        return children;
+    }
+    return {*this};
+}
+
+std::string Predicate::toString() const
+{
+    switch (kind)
+    {
+    case Kind::ALL:
+        return "TRUE";
+    case Kind::EQ:
+        return field + " = " + QueryValues::toString(values[0]);
+    case Kind::RANGE:
+        return field + " BETWEEN " + QueryValues::toString(values[0]) + " AND " + QueryValues::toString(values[1]);
+    case Kind::CONTAINS:
+        return field + " CONTAINS " + QueryValues::toString(values[0]);
+    case Kind::IN:
+    {
+        std::vector<std::string> parts;
+        for (const auto &value : values)
+        {
+            parts.push_back(QueryValues::toString(value));
+        }
+        return field + " IN (" + Utils::join(parts, ", ") + ")";
+    }
+    default:
+    {
+        std::vector<std::string> parts;
+        for (const auto &child : children)
+        {
+            parts.push_back(child.toString());
+        }
+        return "(" + Utils::join(parts, kindName(kind)) + ")";
+    }
+    }
+}
+
+Query &Query::where(const Predicate &predicate)
+{
+    filter = filter && predicate;
+    return *this;
+}
+
+Query &Query::orderBy(const std::string &field, bool ascending)
+{
+    sortField = field;
+    this->ascending = ascending;
+    return *this;
+}
+
+Query &Query::offset(size_t count)
+{
+    offsetCount = count;
+    return *this;
+}
+
+Query &Query::limit(size_t count)
+{
+    limitCount = count;
+    return *this;
+}
+
+std::string QueryPlan::toString() const
+{
+    if (!valid)
+    {
+        return table + ": invalid query: " + error;
+    }
+
+    std::ostringstream oss;
+    if (indexField.empty())
+    {
+        oss << table << ": full scan";
+    }
+    else
+    {
+        std::vector<std::string> keys;
+        for (const auto &key : indexKeys)
+        {
+            keys.push_back(QueryValues::toString(key));
+        }
+        oss << table << ": index lookup on " << indexField << " (" << Utils::join(keys, ", ") << ")";
+    }
+
+    for (const auto &filter : filters)
+    {
+        oss << "\n  filter " << filter.toString();
+    }
+    if (!sortField.empty())
+    {
+        oss << "\n  sort by " << sortField << (ascending ? " asc" : " desc");
+    }
+    if (offset > 0 || limit != Scan::NO_LIMIT)
+    {
+        oss << "\n  offset " << offset;
+        if (limit != Scan::NO_LIMIT)
+        {
+            oss << ", limit " << limit;
+        }
+    }
+    return oss.str();
+}
@@ -0,0 +1,160 @@
+#include "utils/Startup.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <cstdio>
+
+std::unique_ptr<StartupProfiler> StartupProfiler::instance = nullptr;
+std::once_flag StartupProfiler::instanceFlag;
+
+namespace
+{
+    // Phases open on this thread, for nesting
+    thread_local int openPhases = 0;
+
+    std::string formatPhase(const StartupProfiler::Phase &phase)
+    {
+        std::string name = std::string(static_cast<size_t>(phase.depth) * 2, ' ') + phase.name;
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-28s %10.1f", name.c_str(), phase.seconds * 1000);
+        std::string text = line;
+
+        double megabytes = phase.bytes / (1024.0 * 1024.0);
+        if (phase.bytes > 0)
+        {
+            std::snprintf(line, sizeof(line), " %8.2f MB", megabytes);
+            text += line;
+        }
+        else
+        {
+            text += std::string(12, ' ');
+        }
+        if (phase.records > 0)
+        {
+            std::snprintf(line, sizeof(line), " %10llu", static_cast<unsigned long long>(phase.records));
+            text += line;
+        }
+        else
+        {
+            text += std::string(11, ' ');
+        }
+        if (phase.seconds > 0 && phase.records > 0)
+        {
+            std::snprintf(line, sizeof(line), " %12.0f/s", phase.records / phase.seconds);
+            text += line;
+        }
+        if (phase.seconds > 0 && phase.bytes > 0)
+        {
+            std::snprintf(line, sizeof(line), " %8.1f MB/s", megabytes / phase.seconds);
+            text += line;
+        }
+        return text;
+    }
+}
+
+StartupProfiler::StartupProfiler() : recording(false), started(std::chrono::steady_clock::now()), totalSeconds(0)
+{
+}
+
+StartupProfiler &StartupProfiler::getInstance()
+{
+    std::call_once(instanceFlag, []
+                   { instance = std::unique_ptr<StartupProfiler>(new StartupProfiler()); });
+    return *instance;
+}
+
+void StartupProfiler::begin()
+{
+    {
+        std::lock_guard<std::mutex> lock(phasesMutex);
+        phases.clear();
+        started = std::chrono::steady_clock::now();
+        totalSeconds = 0;
+    }
+    recording.store(true, std::memory_order_release);
+}
+
+void StartupProfiler::finish()
+{
+    totalSeconds = elapsed();
+    recording.store(false, std::memory_order_relaxed);
+}
+
+double StartupProfiler::elapsed() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+void StartupProfiler::record(const Phase &phase)
+{
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    phases.push_back(phase);
+}
+
+std::vector<StartupProfiler::Phase> StartupProfiler::getPhases()
+{
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    std::vector<Phase> ordered = phases;
+    // Phases are recorded when they end; a parent starts before its children
+    std::stable_sort(ordered.begin(), ordered.end(), [](const Phase &a, const Phase &b)
+                     { return a.start < b.start || (a.start == b.start && a.depth < b.depth); });
+    return ordered;
+}
+
+std::string StartupProfiler::report()
+{
+    char header[160];
+    std::snprintf(header, sizeof(header), "%-28s %10s %11s %10s %14s %13s\n", "Startup phase", "ms", "read",
+                  "records", "records/s", "throughput");
+    std::string text = header;
+    text += std::string(90, '-') + "\n";
+    for (const auto &phase : getPhases())
+    {
+        text += formatPhase(phase) + "\n";
+    }
+    text += std::string(90, '-') + "\n";
+    char total[80];
+    std::snprintf(total, sizeof(total), "%-28s %10.1f\n", "Total", totalSeconds * 1000);
+    text += total;
+    return text;
+}
+
+void StartupProfiler::logReport()
+{
+    for (const auto &phase : getPhases())
+    {
+        LOG_INFO("Startup: " + formatPhase(phase));
+    }
+    char total[80];
+    std::snprintf(total, sizeof(total), "Startup finished in %.1f ms", totalSeconds * 1000);
+    LOG_INFO(total);
+}
+
+StartupPhase::StartupPhase(const char *name)
+    : span(name), name(name), start(-1), bytes(0), records(0)
+{
+    StartupProfiler &profiler = StartupProfiler::getInstance();
+    if (profiler.isRecording())
+    {
+        start = profiler.elapsed();
+        ++openPhases;
+    }
+}
+
+StartupPhase::~StartupPhase()
+{
+    if (start < 0)
+    {
+        return;
+    }
+
+    --openPhases;
+    StartupProfiler &profiler = StartupProfiler::getInstance();
+    StartupProfiler::Phase phase;
+    phase.name = name;
+    phase.depth = openPhases;
+    phase.start = start;
+    phase.seconds = profiler.elapsed() - start;
+    phase.bytes = bytes;
+    phase.records = records;
+    profiler.record(phase);
+}
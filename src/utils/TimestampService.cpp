@@ -0,0 +1,98 @@
+#include "utils/TimestampService.h"
+#include <chrono>
+#include <time.h>
+
+std::unique_ptr<TimestampService> TimestampService::instance = nullptr;
+std::once_flag TimestampService::instanceFlag;
+
+TimestampService::TimestampService() : cachedEpoch(0)
+{
+    refresh(readClock());
+}
+
+TimestampService &TimestampService::getInstance()
+{
+    std::call_once(instanceFlag, []
+                   { instance = std::unique_ptr<TimestampService>(new TimestampService()); });
+    return *instance;
+}
+
+std::time_t TimestampService::readClock()
+{
+#ifdef CLOCK_REALTIME_COARSE
+    // Updated once per tick, so reading it skips the clock source; whole seconds
+    // are all the cache needs
+    timespec now;
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &now) == 0)
+    {
+        return now.tv_sec;
+    }
+#endif
+    return std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+}
+
+std::time_t TimestampService::epochSeconds()
+{
+    std::time_t epoch = readClock();
+    {
+        std::shared_lock<std::shared_mutex> lock(cacheMutex);
+        if (epoch == cachedEpoch)
+        {
+            return cachedEpoch;
+        }
+    }
+
+    refresh(epoch);
+
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return cachedEpoch;
+}
+
+std::tm TimestampService::toLocalTime(std::time_t epoch)
+{
+    std::tm result{};
+#ifdef _WIN32
+    localtime_s(&result, &epoch);
+#else
+    localtime_r(&epoch, &result);
+#endif
+    return result;
+}
+
+std::string TimestampService::formatDateTime(std::time_t epoch)
+{
+    std::tm local = toLocalTime(epoch);
+    char buffer[32];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    return std::string(buffer, length);
+}
+
+void TimestampService::refresh(std::time_t epoch)
+{
+    std::string formatted = formatDateTime(epoch);
+
+    std::unique_lock<std::shared_mutex> lock(cacheMutex);
+    // Another thread may already have moved the cache forward
+    if (epoch > cachedEpoch || cachedDateTime.empty())
+    {
+        cachedEpoch = epoch;
+        cachedDateTime = std::move(formatted);
+    }
+}
+
+std::string TimestampService::now()
+{
+    std::time_t epoch = readClock();
+    {
+        std::shared_lock<std::shared_mutex> lock(cacheMutex);
+        if (epoch == cachedEpoch)
+        {
+            return cachedDateTime;
+        }
+    }
+
+    refresh(epoch);
+
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return cachedDateTime;
+}
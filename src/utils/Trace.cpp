@@ -0,0 +1,122 @@
+#include "utils/Trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+std::unique_ptr<Tracer> Tracer::instance = nullptr;
+std::once_flag Tracer::instanceFlag;
+
+Tracer::Tracer() : enabled(false), epoch(std::chrono::steady_clock::now()), nextThreadId(1)
+{
+}
+
+Tracer &Tracer::getInstance()
+{
+    std::call_once(instanceFlag, []
+                   { instance = std::unique_ptr<Tracer>(new Tracer()); });
+    return *instance;
+}
+
+Tracer::ThreadBuffer &Tracer::threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer)
+    {
+        buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffer->threadId = nextThreadId++;
+        buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        // Threads that have exited own nothing new; drop their buffers
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                     [](const std::shared_ptr<ThreadBuffer> &buffer)
+                                     { return buffer.use_count() == 1; }),
+                      buffers.end());
+        for (auto &buffer : buffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->spans.clear();
+            buffer->dropped = 0;
+        }
+    }
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop()
+{
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::record(const char *name, std::int64_t start, std::int64_t duration)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.spans.size() < MAX_SPANS_PER_THREAD)
+    {
+        buffer.spans.push_back({name, start, duration});
+    }
+    else
+    {
+        ++buffer.dropped;
+    }
+}
+
+std::vector<std::pair<int, Tracer::Span>> Tracer::spans()
+{
+    std::vector<std::pair<int, Span>> all;
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (auto &buffer : buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const Span &span : buffer->spans)
+        {
+            all.emplace_back(buffer->threadId, span);
+        }
+    }
+    return all;
+}
+
+std::uint64_t Tracer::droppedSpans()
+{
+    std::uint64_t dropped = 0;
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (auto &buffer : buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        dropped += buffer->dropped;
+    }
+    return dropped;
+}
+
+bool Tracer::writeChromeTrace(const std::string &filename)
+{
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out)
+    {
+        return false;
+    }
+
+    // Timestamps and durations are in microseconds; keep nanosecond precision
+    out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedSpans\":" << droppedSpans() << "},\"traceEvents\":[";
+    bool first = true;
+    char event[256];
+    for (const auto &entry : spans())
+    {
+        const Span &span = entry.second;
+        std::snprintf(event, sizeof(event),
+                      "%s\n{\"name\":\"%s\",\"cat\":\"ordermgmt\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                      "\"ts\":%.3f,\"dur\":%.3f}",
+                      first ? "" : ",", span.name, entry.first, span.start / 1000.0, span.duration / 1000.0);
+        out << event;
+        first = false;
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out.flush());
+}
@@ -0,0 +1,172 @@
+#include "utils/Transaction.h"
+#include "utils/Database.h"
+#include "utils/Logger.h"
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct TransactionState
+    {
+        int depth = 0;
+        bool undoing = false;
+        std::vector<std::function<void()>> undoLog;
+        bool deferring = false;
+        bool flushing = false;
+        std::vector<std::pair<const void *, std::function<void()>>> deferredSaves;
+        std::vector<std::function<void()>> afterCommitLog;
+    };
+    thread_local TransactionState state;
+
+    // Runs undo actions above mark, newest first
+    void rollBackTo(size_t mark)
+    {
+        state.undoing = true;
+        while (state.undoLog.size() > mark)
+        {
+            std::function<void()> undo = std::move(state.undoLog.back());
+            state.undoLog.pop_back();
+            undo();
+        }
+        state.undoing = false;
+    }
+}
+
+Transaction::Transaction()
+    : outermost(state.depth == 0), finished(false), undoMark(state.undoLog.size()),
+      afterCommitMark(state.afterCommitLog.size())
+{
+    if (outermost)
+    {
+        Database::getInstance().beginTransaction();
+    }
+    ++state.depth;
+}
+
+Transaction::~Transaction()
+{
+    if (!finished)
+    {
+        abort();
+    }
+}
+
+bool Transaction::commit()
+{
+    if (finished)
+    {
+        return false;
+    }
+    finished = true;
+    --state.depth;
+
+    if (!outermost)
+    {
+        // The outer transaction keeps the undo actions until it finishes
+        return true;
+    }
+
+    // Deferred saves stage their files now, while the database transaction is open.
+    // The database numbers each copy, so a slower commit can't replace a file with an
+    // older copy than one already written.
+    if (state.deferring)
+    {
+        state.flushing = true;
+        for (auto &entry : state.deferredSaves)
+        {
+            entry.second();
+        }
+        state.flushing = false;
+        state.deferring = false;
+        state.deferredSaves.clear();
+    }
+
+    // As with a failed save, memory keeps the changes and the next save writes them
+    bool committed = Database::getInstance().commitTransaction();
+    if (!committed)
+    {
+        LOG_ERROR("Transaction commit failed; changes were not written");
+    }
+    state.undoLog.clear();
+
+    // The changes stand now, so what they report can go out
+    std::vector<std::function<void()>> records;
+    records.swap(state.afterCommitLog);
+    for (auto &record : records)
+    {
+        record();
+    }
+    return committed;
+}
+
+void Transaction::abort()
+{
+    if (finished)
+    {
+        return;
+    }
+    finished = true;
+    --state.depth;
+
+    if (outermost)
+    {
+        // Drop the staged files first so the undo actions' own saves go straight to disk
+        Database::getInstance().abortTransaction();
+        state.deferring = false;
+        state.deferredSaves.clear();
+    }
+    state.afterCommitLog.resize(afterCommitMark);
+    rollBackTo(undoMark);
+}
+
+void Transaction::deferSaves()
+{
+    if (outermost && !finished)
+    {
+        state.deferring = true;
+    }
+}
+
+bool Transaction::active()
+{
+    return state.depth > 0;
+}
+
+void Transaction::onAbort(std::function<void()> undo)
+{
+    if (state.depth > 0 && !state.undoing)
+    {
+        state.undoLog.push_back(std::move(undo));
+    }
+}
+
+void Transaction::afterCommit(std::function<void()> record)
+{
+    if (state.undoing)
+    {
+        return;
+    }
+    if (state.depth == 0)
+    {
+        record();
+        return;
+    }
+    state.afterCommitLog.push_back(std::move(record));
+}
+
+bool Transaction::deferSave(const void *owner, std::function<void()> save)
+{
+    if (!state.deferring || state.flushing)
+    {
+        return false;
+    }
+    for (const auto &entry : state.deferredSaves)
+    {
+        if (entry.first == owner)
+        {
+            return true;
+        }
+    }
+    state.deferredSaves.emplace_back(owner, std::move(save));
+    return true;
+}
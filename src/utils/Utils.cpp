@@ -1,4 +1,5 @@
 #include "utils/Utils.h"
+#include "utils/TimestampService.h"
 #include <algorithm>
 #include <cctype>
 #include <chrono>
@@ -88,50 +89,37 @@ namespace Utils
     // Date and time utilities
     std::string getCurrentDateTime()
     {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        return ss.str();
+        return TimestampService::getInstance().now();
     }
 
     std::string getCurrentDate()
     {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d");
-        return ss.str();
+        // "YYYY-MM-DD HH:MM:SS" -> "YYYY-MM-DD"
+        return TimestampService::getInstance().now().substr(0, 10);
     }
 
     std::string getCurrentTime()
     {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
-        return ss.str();
+        // "YYYY-MM-DD HH:MM:SS" -> "HH:MM:SS"
+        return TimestampService::getInstance().now().substr(11);
     }
 
     bool isValidDate(const std::string &date)
     {
-        std::regex dateRegex(R"(\d{4}-\d{2}-\d{2})");
+        static const std::regex dateRegex(R"(\d{4}-\d{2}-\d{2})");
         return std::regex_match(date, dateRegex);
     }
 
-    // Validation utilities
+    // Validation utilities. The patterns compile once: imports validate every row.
     bool isValidEmail(const std::string &email)
     {
-        std::regex emailRegex(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
+        static const std::regex emailRegex(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
         return std::regex_match(email, emailRegex);
     }
 
     bool isValidPhone(const std::string &phone)
     {
-        std::regex phoneRegex(R"([\d\-\(\)\+\s]{10,})");
+        static const std::regex phoneRegex(R"([\d\-\(\)\+\s]{10,})");
         return std::regex_match(phone, phoneRegex);
     }
 
@@ -320,6 +308,21 @@ namespace Utils
         return ss.str();
     }
 
+    std::string formatBytes(size_t bytes)
+    {
+        static const char *const units[] = {"B", "KB", "MB", "GB", "TB"};
+        double value = static_cast<double>(bytes);
+        int unit = 0;
+        while (value >= 1024 && unit < 4)
+        {
+            value /= 1024;
+            ++unit;
+        }
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+        return ss.str();
+    }
+
     // File utilities
     bool createDirectory(const std::string &path)
     {
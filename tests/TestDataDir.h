@@ -0,0 +1,95 @@
+#pragma once
+#include <gtest/gtest.h>
+#include "managers/CustomerManager.h"
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "utils/Database.h"
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// Points the Database at a fresh directory for as long as it lives, then removes
+// the directory and points the Database back where it was. The previous directory
+// is not created, so fixtures that rely on a missing data/ still start empty.
+class TestDataDir
+{
+private:
+    std::string path;
+    std::string previous;
+    bool ready;
+
+public:
+    explicit TestDataDir(const std::string &name)
+        : path(name + "/"), previous(Database::getInstance().getDataDirectory()), ready(false)
+    {
+        std::filesystem::remove_all(path);
+        ready = Database::getInstance().initialize(path);
+    }
+
+    ~TestDataDir()
+    {
+        Database::getInstance().setDataDirectory(previous);
+        std::filesystem::remove_all(path);
+    }
+
+    bool isReady() const { return ready; }
+    // With the trailing slash, as Database expects
+    const std::string &getPath() const { return path; }
+
+    TestDataDir(const TestDataDir &) = delete;
+    TestDataDir &operator=(const TestDataDir &) = delete;
+};
+
+// Fixture base for tests of the product, customer and order managers over their
+// own TestDataDir. Fixtures that add data in SetUp call
+// ASSERT_NO_FATAL_FAILURE(ManagerTest::SetUp()) first, and fixtures with more
+// members release them before calling ManagerTest::TearDown().
+class ManagerTest : public ::testing::Test
+{
+private:
+    std::string dataDirName;
+    std::unique_ptr<TestDataDir> dataDir;
+
+protected:
+    std::unique_ptr<ProductManager> productManager;
+    std::unique_ptr<CustomerManager> customerManager;
+    std::unique_ptr<OrderManager> orderManager;
+
+    explicit ManagerTest(std::string dataDirName) : dataDirName(std::move(dataDirName)) {}
+
+    void SetUp() override
+    {
+        dataDir = std::make_unique<TestDataDir>(dataDirName);
+        ASSERT_TRUE(dataDir->isReady());
+        createManagers();
+    }
+
+    void TearDown() override
+    {
+        resetManagers();
+        dataDir.reset();
+    }
+
+    const std::string &dataPath() const { return dataDir->getPath(); }
+
+    virtual void createManagers()
+    {
+        productManager = std::make_unique<ProductManager>();
+        customerManager = std::make_unique<CustomerManager>();
+        orderManager = std::make_unique<OrderManager>(productManager.get(), customerManager.get());
+    }
+
+    virtual void resetManagers()
+    {
+        orderManager.reset();
+        customerManager.reset();
+        productManager.reset();
+    }
+
+    // Drops the in-memory state and loads what reached the data files
+    void reloadManagers()
+    {
+        resetManagers();
+        createManagers();
+    }
+};
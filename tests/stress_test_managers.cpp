@@ -0,0 +1,373 @@
+#include <gtest/gtest.h>
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "managers/CustomerManager.h"
+#include "managers/UserManager.h"
+#include "utils/Database.h"
+#include "utils/Logger.h"
+#include "TestDataDir.h"
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Multi-threaded stress tests for the managers. Built as a separate target
+// (OrderManagementStressTests) because they take longer than the unit tests.
+class ManagerStressTest : public ManagerTest
+{
+protected:
+    static constexpr int READER_THREADS = 6;
+    static constexpr int WRITER_THREADS = 4;
+
+    ManagerStressTest() : ManagerTest("stress_test_data") {}
+
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(ManagerTest::SetUp());
+        for (int i = 0; i < 10; ++i)
+        {
+            productManager->addProduct(Product(0, "Product " + std::to_string(i), "Stress test product",
+                                               i % 2 ? "Books" : "Electronics", 10.0 + i, 1000, 5));
+        }
+        customerManager->addCustomer(Customer(0, "Stress Customer", "stress@email.com", "+1555000000",
+                                              "1 Load St", "Cairo", "Egypt"));
+    }
+};
+
+TEST(SingletonStressTest, ConcurrentGetInstanceReturnsOneObject)
+{
+    std::vector<std::thread> threads;
+    std::vector<Database *> databases(16, nullptr);
+    std::vector<Logger *> loggers(16, nullptr);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        threads.emplace_back([i, &databases, &loggers]
+                             {
+                                 databases[i] = &Database::getInstance();
+                                 loggers[i] = &Logger::getInstance(); });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int i = 1; i < 16; ++i)
+    {
+        EXPECT_EQ(databases[i], databases[0]);
+        EXPECT_EQ(loggers[i], loggers[0]);
+    }
+}
+
+TEST_F(ManagerStressTest, ParallelReadersWithStockWriters)
+{
+    const int addsPerWriter = 50;
+    std::atomic<int> inconsistentReads(0);
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < WRITER_THREADS; ++w)
+    {
+        threads.emplace_back([this, w]
+                             {
+                                 for (int i = 0; i < addsPerWriter; ++i)
+                                 {
+                                     productManager->addStock(1 + (w + i) % 10, 1);
+                                 } });
+    }
+
+    for (int r = 0; r < READER_THREADS; ++r)
+    {
+        threads.emplace_back([this, &inconsistentReads]
+                             {
+                                 for (int i = 0; i < 200; ++i)
+                                 {
+                                     std::vector<Product> all = productManager->getAllProducts();
+                                     if (all.size() != 10 ||
+                                         productManager->searchByName("product").size() != 10 ||
+                                         productManager->getActiveProductsCount() != 10 ||
+                                         productManager->getProductsByCategory("books").size() != 5)
+                                     {
+                                         ++inconsistentReads;
+                                     }
+
+                                     Product product;
+                                     if (!productManager->getProductCopy(3, product) ||
+                                         product.getStockQuantity() < 1000)
+                                     {
+                                         ++inconsistentReads;
+                                     }
+                                 } });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(inconsistentReads.load(), 0);
+
+    int totalStock = 0;
+    for (const auto &product : productManager->getAllProducts())
+    {
+        totalStock += product.getStockQuantity();
+    }
+    EXPECT_EQ(totalStock, 10 * 1000 + WRITER_THREADS * addsPerWriter);
+}
+
+TEST_F(ManagerStressTest, ConcurrentOrderCreationAssignsUniqueIds)
+{
+    const int ordersPerThread = 25;
+    std::vector<std::thread> threads;
+    std::atomic<int> failures(0);
+
+    for (int w = 0; w < WRITER_THREADS; ++w)
+    {
+        threads.emplace_back([this, &failures]
+                             {
+                                 for (int i = 0; i < ordersPerThread; ++i)
+                                 {
+                                     if (!orderManager->createOrder(1))
+                                     {
+                                         ++failures;
+                                     }
+                                 } });
+    }
+    for (int r = 0; r < READER_THREADS; ++r)
+    {
+        threads.emplace_back([this]
+                             {
+                                 for (int i = 0; i < 100; ++i)
+                                 {
+                                     orderManager->getOrdersByCustomer(1);
+                                     orderManager->getOrdersByStatusCount(OrderStatus::PENDING);
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+
+    std::vector<Order> orders = orderManager->getAllOrders();
+    ASSERT_EQ(orders.size(), static_cast<size_t>(WRITER_THREADS * ordersPerThread));
+
+    std::set<int> ids;
+    for (const auto &order : orders)
+    {
+        ids.insert(order.getOrderId());
+    }
+    EXPECT_EQ(ids.size(), orders.size());
+}
+
+TEST_F(ManagerStressTest, ConcurrentItemAdditionAndStatusChanges)
+{
+    const int ordersPerThread = 10;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < WRITER_THREADS * ordersPerThread; ++i)
+    {
+        ASSERT_TRUE(orderManager->createOrder(1));
+    }
+
+    for (int w = 0; w < WRITER_THREADS; ++w)
+    {
+        threads.emplace_back([this, w]
+                             {
+                                 for (int i = 0; i < ordersPerThread; ++i)
+                                 {
+                                     int orderId = 1 + w * ordersPerThread + i;
+                                     orderManager->addItemToOrder(orderId, 1 + i % 10, 2);
+                                     orderManager->confirmOrder(orderId);
+                                 } });
+    }
+    for (int r = 0; r < READER_THREADS; ++r)
+    {
+        threads.emplace_back([this]
+                             {
+                                 for (int i = 0; i < 100; ++i)
+                                 {
+                                     Order order;
+                                     orderManager->getOrderCopy(1 + i % 40, order);
+                                     orderManager->canFulfillOrder(1 + i % 40);
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(orderManager->getOrdersByStatusCount(OrderStatus::CONFIRMED), WRITER_THREADS * ordersPerThread);
+    for (const auto &order : orderManager->getAllOrders())
+    {
+        EXPECT_EQ(order.getItems().size(), 1u);
+    }
+}
+
+TEST_F(ManagerStressTest, HotProductConfirmationsNeverOversell)
+{
+    // Product 1 starts with 1000 units; 8 threads try to confirm orders for 1500
+    const int entryThreads = 8;
+    const int ordersPerThread = 75;
+    std::vector<std::thread> threads;
+    std::atomic<int> confirmed(0);
+
+    for (int i = 0; i < entryThreads * ordersPerThread; ++i)
+    {
+        ASSERT_TRUE(orderManager->createOrder(1));
+    }
+
+    for (int t = 0; t < entryThreads; ++t)
+    {
+        threads.emplace_back([this, t, &confirmed]
+                             {
+                                 for (int i = 0; i < ordersPerThread; ++i)
+                                 {
+                                     int orderId = 1 + t * ordersPerThread + i;
+                                     if (orderManager->addItemToOrder(orderId, 1, 2) &&
+                                         orderManager->confirmOrder(orderId))
+                                     {
+                                         ++confirmed;
+                                     }
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    Product product;
+    ASSERT_TRUE(productManager->getProductCopy(1, product));
+    EXPECT_EQ(confirmed.load(), 500);
+    EXPECT_EQ(product.getStockQuantity(), 1000);
+    EXPECT_EQ(product.getReservedQuantity(), 1000);
+    EXPECT_EQ(product.getAvailableQuantity(), 0);
+
+    // Cancelling releases the reservations
+    for (int orderId = 1; orderId <= entryThreads * ordersPerThread; ++orderId)
+    {
+        orderManager->cancelOrder(orderId);
+    }
+    ASSERT_TRUE(productManager->getProductCopy(1, product));
+    EXPECT_EQ(product.getReservedQuantity(), 0);
+    EXPECT_EQ(product.getAvailableQuantity(), 1000);
+}
+
+TEST_F(ManagerStressTest, SnapshotReadersDuringOrderEntry)
+{
+    const int ordersPerThread = 25;
+    std::vector<std::thread> threads;
+    std::atomic<bool> writing(true);
+    std::atomic<int> inconsistentReads(0);
+
+    for (int i = 0; i < WRITER_THREADS * ordersPerThread; ++i)
+    {
+        ASSERT_TRUE(orderManager->createOrder(1));
+    }
+
+    for (int w = 0; w < WRITER_THREADS; ++w)
+    {
+        threads.emplace_back([this, w]
+                             {
+                                 for (int i = 0; i < ordersPerThread; ++i)
+                                 {
+                                     int orderId = 1 + w * ordersPerThread + i;
+                                     orderManager->addItemToOrder(orderId, 1 + i % 10, 2);
+                                     orderManager->confirmOrder(orderId);
+                                 } });
+    }
+    for (int r = 0; r < READER_THREADS; ++r)
+    {
+        threads.emplace_back([this, &writing, &inconsistentReads]
+                             {
+                                 while (writing)
+                                 {
+                                     // A snapshot must read the same however many times it is scanned
+                                     OrderSnapshot orders = orderManager->getSnapshot();
+                                     ProductSnapshot products = productManager->getSnapshot();
+                                     int confirmedOrders = 0;
+                                     for (const auto &order : orders)
+                                     {
+                                         confirmedOrders += order.getStatus() == OrderStatus::CONFIRMED;
+                                     }
+                                     int reservedUnits = 0;
+                                     for (const auto &product : products)
+                                     {
+                                         reservedUnits += product.getReservedQuantity();
+                                     }
+                                     std::this_thread::yield();
+
+                                     int confirmedAgain = 0;
+                                     for (const auto &order : orders)
+                                     {
+                                         confirmedAgain += order.getStatus() == OrderStatus::CONFIRMED;
+                                     }
+                                     int reservedAgain = 0;
+                                     for (const auto &product : products)
+                                     {
+                                         reservedAgain += product.getReservedQuantity();
+                                     }
+                                     if (orders.size() != static_cast<size_t>(WRITER_THREADS * ordersPerThread) ||
+                                         confirmedAgain != confirmedOrders || reservedAgain != reservedUnits)
+                                     {
+                                         ++inconsistentReads;
+                                     }
+                                 } });
+    }
+    for (int w = 0; w < WRITER_THREADS; ++w)
+    {
+        threads[w].join();
+    }
+    writing = false;
+    for (size_t i = WRITER_THREADS; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+
+    EXPECT_EQ(inconsistentReads.load(), 0);
+    EXPECT_EQ(orderManager->getOrdersByStatusCount(OrderStatus::CONFIRMED), WRITER_THREADS * ordersPerThread);
+
+    int reserved = 0;
+    for (const auto &product : productManager->getSnapshot())
+    {
+        reserved += product.getReservedQuantity();
+    }
+    EXPECT_EQ(reserved, WRITER_THREADS * ordersPerThread * 2);
+}
+
+TEST_F(ManagerStressTest, ConcurrentUserRegistration)
+{
+    UserManager userManager;
+    const int usersPerThread = 20;
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < WRITER_THREADS; ++w)
+    {
+        threads.emplace_back([&userManager, w]
+                             {
+                                 for (int i = 0; i < usersPerThread; ++i)
+                                 {
+                                     std::string name = "user" + std::to_string(w) + "_" + std::to_string(i);
+                                     userManager.addUser(User(0, name, "secret", "Stress User",
+                                                              name + "@email.com", UserRole::EMPLOYEE));
+                                 } });
+    }
+    for (int r = 0; r < READER_THREADS; ++r)
+    {
+        threads.emplace_back([&userManager]
+                             {
+                                 for (int i = 0; i < 100; ++i)
+                                 {
+                                     userManager.searchByUsername("user");
+                                     userManager.getUserCountByRole(UserRole::EMPLOYEE);
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    // Default admin plus every registered user
+    EXPECT_EQ(userManager.getTotalUsers(), 1 + WRITER_THREADS * usersPerThread);
+    EXPECT_EQ(userManager.getUserCountByRole(UserRole::EMPLOYEE), WRITER_THREADS * usersPerThread);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "managers/CustomerManager.h"
+#include "utils/Database.h"
+#include "utils/Transaction.h"
+#include "TestDataDir.h"
+
+class BatchTest : public ManagerTest
+{
+protected:
+    BatchTest() : ManagerTest("test_batch_data") {}
+
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(ManagerTest::SetUp());
+        ASSERT_TRUE(customerManager->addCustomer(Customer(0, "John Doe", "john@email.com", "+1234567890",
+                                                          "123 Main St", "New York", "USA")));
+        ASSERT_TRUE(productManager->addProduct(Product(0, "Laptop", "Work laptop", "Electronics", 999.99, 10, 2)));
+        ASSERT_TRUE(productManager->addProduct(Product(0, "Mouse", "Wireless mouse", "Electronics", 29.99, 5, 1)));
+    }
+
+    static std::vector<size_t> failedRows(const BatchResult &result)
+    {
+        std::vector<size_t> rows;
+        for (const auto &failure : result.failures)
+        {
+            rows.push_back(failure.row);
+        }
+        return rows;
+    }
+};
+
+TEST_F(BatchTest, AddProductsReportsRowsItSkips)
+{
+    BatchResult result = productManager->addProducts({
+        Product(0, "Keyboard", "Mechanical", "Electronics", 79.0, 3, 1),
+        Product(0, "laptop", "Duplicate name", "Electronics", 10.0, 1, 0),
+        Product(0, "", "No name", "Electronics", 10.0, 1, 0),
+        Product(0, "Monitor", "27 inch", "Electronics", 199.0, 2, 1),
+        Product(0, "MONITOR", "Duplicate within the batch", "Electronics", 1.0, 1, 0),
+    });
+
+    EXPECT_EQ(result.applied, 2u);
+    EXPECT_EQ(failedRows(result), (std::vector<size_t>{1, 2, 4}));
+    EXPECT_EQ(productManager->getTotalProducts(), 4);
+
+    // Saved once, and it reloads
+    productManager = std::make_unique<ProductManager>();
+    EXPECT_EQ(productManager->getTotalProducts(), 4);
+    Product monitor;
+    ASSERT_TRUE(productManager->getProductCopy(4, monitor));
+    EXPECT_EQ(monitor.getName(), "Monitor");
+}
+
+TEST_F(BatchTest, UpdateStocksAppliesValidRows)
+{
+    BatchResult result = productManager->updateStocks({{1, 50}, {99, 5}, {2, -1}, {2, 7}});
+    EXPECT_EQ(result.applied, 2u);
+    EXPECT_EQ(failedRows(result), (std::vector<size_t>{1, 2}));
+    EXPECT_EQ(productManager->getAvailableQuantity(1), 50);
+    EXPECT_EQ(productManager->getAvailableQuantity(2), 7);
+
+    {
+        Transaction transaction;
+        productManager->updateStocks({{1, 0}, {2, 0}});
+    }
+    EXPECT_EQ(productManager->getAvailableQuantity(1), 50);
+    EXPECT_EQ(productManager->getAvailableQuantity(2), 7);
+}
+
+TEST_F(BatchTest, AddCustomersChecksUniquenessAcrossTheBatch)
+{
+    BatchResult result = customerManager->addCustomers({
+        Customer(0, "Jane Smith", "jane@email.com", "+1987654321", "456 Oak Ave", "Cairo", "Egypt"),
+        Customer(0, "John Again", "JOHN@email.com", "+1000000000", "1 Elm St", "Paris", "France"),
+        Customer(0, "Jane Twin", "twin@email.com", "+1987654321", "456 Oak Ave", "Cairo", "Egypt"),
+    });
+
+    EXPECT_EQ(result.applied, 1u);
+    EXPECT_EQ(failedRows(result), (std::vector<size_t>{1, 2}));
+    EXPECT_EQ(customerManager->getTotalCustomers(), 2);
+}
+
+TEST_F(BatchTest, AddItemsToOrderChecksStockAcrossRows)
+{
+    ASSERT_TRUE(orderManager->createOrder(1));
+    BatchResult result = orderManager->addItemsToOrder(1, {{2, 3}, {2, 3}, {7, 1}, {1, 0}, {1, 2}});
+    EXPECT_EQ(result.applied, 2u);
+    EXPECT_EQ(failedRows(result), (std::vector<size_t>{1, 2, 3}));
+
+    Order order;
+    ASSERT_TRUE(orderManager->getOrderCopy(1, order));
+    EXPECT_EQ(order.getItems().size(), 2u);
+
+    EXPECT_EQ(orderManager->addItemsToOrder(42, {{1, 1}}).failures.size(), 1u);
+}
+
+TEST_F(BatchTest, AddItemsToConfirmedOrderReserves)
+{
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 1));
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+
+    BatchResult result = orderManager->addItemsToOrder(1, {{2, 4}, {2, 4}});
+    EXPECT_EQ(result.applied, 1u);
+    EXPECT_EQ(failedRows(result), (std::vector<size_t>{1}));
+    EXPECT_EQ(productManager->getAvailableQuantity(2), 1);
+}
+
+TEST_F(BatchTest, StatusTransitionsMoveStockPerOrder)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(orderManager->createOrder(1));
+    }
+    ASSERT_TRUE(orderManager->addItemToOrder(1, 2, 3));
+    ASSERT_TRUE(orderManager->addItemToOrder(2, 2, 3));
+    ASSERT_TRUE(orderManager->addItemToOrder(3, 1, 1));
+
+    // Only one of orders 1 and 2 fits in the five mice
+    BatchResult confirmed = orderManager->updateOrderStatuses({1, 2, 3, 3, 9}, OrderStatus::CONFIRMED);
+    EXPECT_EQ(confirmed.applied, 2u);
+    EXPECT_EQ(failedRows(confirmed), (std::vector<size_t>{1, 3, 4}));
+    EXPECT_EQ(productManager->getAvailableQuantity(2), 2);
+    EXPECT_EQ(productManager->getAvailableQuantity(1), 9);
+
+    BatchResult cancelled = orderManager->updateOrderStatuses({1, 2, 3}, OrderStatus::CANCELLED);
+    EXPECT_EQ(cancelled.applied, 3u);
+    EXPECT_TRUE(cancelled.ok());
+    EXPECT_EQ(productManager->getAvailableQuantity(2), 5);
+    EXPECT_EQ(productManager->getAvailableQuantity(1), 10);
+
+    EXPECT_EQ(orderManager->getOrdersByStatus(OrderStatus::CANCELLED).size(), 3u);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "ui/BatchRunner.h"
+#include "utils/Database.h"
+#include "utils/Metrics.h"
+#include "TestDataDir.h"
+#include <sstream>
+
+class BatchRunnerTest : public ManagerTest
+{
+protected:
+    BatchRunnerTest() : ManagerTest("test_batch_runner_data") {}
+
+    void createManagers() override
+    {
+        userManager = std::make_unique<UserManager>();
+        ManagerTest::createManagers();
+        runner = std::make_unique<BatchRunner>(*userManager, *customerManager, *productManager, *orderManager);
+    }
+
+    void resetManagers() override
+    {
+        runner.reset();
+        ManagerTest::resetManagers();
+        userManager.reset();
+    }
+
+    BatchRunner::Report run(const std::string &commands, std::string *output = nullptr)
+    {
+        std::istringstream in(commands);
+        std::ostringstream out;
+        BatchRunner::Report report = runner->run(in, out);
+        if (output)
+        {
+            *output = out.str();
+        }
+        return report;
+    }
+
+    std::unique_ptr<UserManager> userManager;
+    std::unique_ptr<BatchRunner> runner;
+};
+
+TEST_F(BatchRunnerTest, RunsCommandsAndSavesOnce)
+{
+    ASSERT_TRUE(userManager->login("admin", "admin"));
+    size_t ordersSaved = Metrics::getInstance().latency("order_save").snapshot().getCount();
+
+    std::string output;
+    BatchRunner::Report report = run("# set-up\n"
+                                     "customer.add,Jane Doe,jane@example.com,+1-555-0100,\"1 Main St, Apt 2\",Cairo,Egypt\n"
+                                     "product.add,USB Cable,Accessories,9.99,500\n"
+                                     "\n"
+                                     "order.create,$customer\n"
+                                     "order.add_item,$order,$product,2\n"
+                                     "order.status,$order,Confirmed\n"
+                                     "order.create,1\n"
+                                     "order.add_item,2,1,3\n"
+                                     "stock.add,$product,10\n",
+                                     &output);
+    EXPECT_TRUE(report.saved);
+    EXPECT_TRUE(report.result.ok());
+    EXPECT_EQ(report.commands, 8u);
+    EXPECT_EQ(report.result.applied, 8u);
+    EXPECT_EQ(output, "customer 1\nproduct 1\norder 1\norder 2\n");
+    EXPECT_EQ(Metrics::getInstance().latency("order_save").snapshot().getCount(), ordersSaved + 1);
+
+    userManager->logout();
+    reloadManagers();
+    Customer customer;
+    ASSERT_TRUE(customerManager->getCustomerCopy(1, customer));
+    EXPECT_EQ(customer.getAddress(), "1 Main St, Apt 2");
+    Order order;
+    ASSERT_TRUE(orderManager->getOrderCopy(1, order));
+    EXPECT_EQ(order.getStatus(), OrderStatus::CONFIRMED);
+    EXPECT_EQ(orderManager->getTotalOrders(), 2);
+    Product product;
+    ASSERT_TRUE(productManager->getProductCopy(1, product));
+    EXPECT_EQ(product.getStockQuantity(), 510);
+    EXPECT_EQ(product.getReservedQuantity(), 2);
+}
+
+TEST_F(BatchRunnerTest, ReportsFailedLinesAndRunsTheRest)
+{
+    ASSERT_TRUE(userManager->login("admin", "admin"));
+    BatchRunner::Report report = run("order.add_item,$order,1,1\n"
+                                     "product.add,Desk,Furniture,150,4\n"
+                                     "order.fly,1\n"
+                                     "stock.add,1\n"
+                                     "stock.reduce,1,9\n"
+                                     "order.create,42\n"
+                                     "stock.reduce,1,x\n"
+                                     "stock.set,1,7\n");
+    EXPECT_TRUE(report.saved);
+    EXPECT_EQ(report.commands, 8u);
+    EXPECT_EQ(report.result.applied, 2u);
+    ASSERT_EQ(report.result.failures.size(), 6u);
+    EXPECT_EQ(report.result.failures[0].row, 1u);
+    EXPECT_EQ(report.result.failures[0].reason, "no order created yet");
+    EXPECT_EQ(report.result.failures[1].reason, "unknown command: order.fly");
+    EXPECT_EQ(report.result.failures[2].reason, "usage: stock.add,PRODUCT,QUANTITY");
+    EXPECT_EQ(report.result.failures[3].row, 5u);
+    EXPECT_EQ(report.result.failures[3].reason, "stock.reduce,1,9: rejected");
+    EXPECT_EQ(report.result.failures[4].reason, "order.create,42: rejected");
+    EXPECT_EQ(report.result.failures[5].reason, "quantity must be a whole number: x");
+
+    Product product;
+    ASSERT_TRUE(productManager->getProductCopy(1, product));
+    EXPECT_EQ(product.getStockQuantity(), 7);
+}
+
+TEST_F(BatchRunnerTest, CommandsNeedPermission)
+{
+    BatchRunner::Report report = run("product.add,Desk,Furniture,150,4\n");
+    ASSERT_EQ(report.result.failures.size(), 1u);
+    EXPECT_EQ(report.result.failures[0].reason, "product.add: access denied");
+    EXPECT_EQ(productManager->getTotalProducts(), 0);
+}
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "managers/CustomerManager.h"
+#include "managers/UserManager.h"
+#include "utils/Csv.h"
+#include "utils/Database.h"
+#include "TestDataDir.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+TEST(CsvTest, ParsesQuotedFields)
+{
+    EXPECT_EQ(Csv::parseRecord("a,\"b,c\",\"say \"\"hi\"\"\",,\"multi\nline\"\r"),
+              (std::vector<std::string>{"a", "b,c", "say \"hi\"", "", "multi\nline"}));
+    EXPECT_EQ(Csv::parseRecord(""), (std::vector<std::string>{""}));
+}
+
+TEST(CsvTest, ChunksEndOnRecordBoundaries)
+{
+    std::istringstream in("id,note\r\n1,\"spans\na chunk\"\n2,plain\n3,last");
+    Csv::ChunkReader reader(in, 4); // smaller than any record
+
+    std::vector<std::string> records;
+    std::vector<size_t> numbers;
+    Csv::Block block;
+    while (reader.next(block))
+    {
+        size_t start = 0;
+        for (size_t i = 0; i < block.ends.size(); ++i)
+        {
+            records.push_back(block.text.substr(start, block.ends[i] - start));
+            numbers.push_back(block.firstRecord + i);
+            start = block.ends[i] + 1;
+        }
+    }
+
+    EXPECT_EQ(records, (std::vector<std::string>{"id,note\r", "1,\"spans\na chunk\"", "2,plain", "3,last"}));
+    EXPECT_EQ(numbers, (std::vector<size_t>{1, 2, 3, 4}));
+}
+
+class CsvImportTest : public ManagerTest
+{
+protected:
+    CsvImportTest() : ManagerTest("test_csv_data") {}
+
+    static std::string write(const std::string &name, const std::string &contents)
+    {
+        std::string path = "test_csv_data/" + name;
+        std::ofstream(path, std::ios::binary) << contents;
+        return path;
+    }
+
+    static std::string read(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    static std::vector<size_t> rejectedRows(const Csv::ImportReport &report)
+    {
+        std::vector<size_t> rows;
+        for (const auto &failure : report.rejected)
+        {
+            rows.push_back(failure.row);
+        }
+        return rows;
+    }
+};
+
+TEST_F(CsvImportTest, ImportsCustomersAndReportsRejectedRows)
+{
+    std::string path = write("customers.csv",
+                             "\xEF\xBB\xBFName,Email,Phone,Address,City,Country,Active\r\n"
+                             "John Doe,john@email.com,+1234567890,\"123 Main St, Apt 4\",New York,USA,1\r\n"
+                             "No Email,,+1000000000,1 Elm St,Paris,France,1\r\n"
+                             "Jane Smith,jane@email.com,+1987654321,456 Oak Ave,Cairo,Egypt,0\r\n"
+                             "John Again,JOHN@email.com,+1555555555,9 Pine Rd,Boston,USA,\r\n");
+
+    Csv::ImportOptions options;
+    options.chunkSize = 64; // several blocks, parsed on several threads
+    options.threads = 3;
+    Csv::ImportReport report = customerManager->importFromCSV(path, options);
+
+    ASSERT_TRUE(report.ok) << report.error;
+    EXPECT_EQ(report.rows, 4u);
+    EXPECT_EQ(report.imported, 2u);
+    EXPECT_EQ(report.rejectedCount, 2u);
+    EXPECT_EQ(rejectedRows(report), (std::vector<size_t>{3, 5}));
+
+    std::vector<Customer> customers = customerManager->getAllCustomers();
+    ASSERT_EQ(customers.size(), 2u);
+    EXPECT_EQ(customers[0].getAddress(), "123 Main St, Apt 4");
+    EXPECT_FALSE(customers[1].getIsActive());
+}
+
+TEST_F(CsvImportTest, ImportsProductsThenOrders)
+{
+    std::string products = write("products.csv",
+                                 "name,category,price,stock,minStock,description\n"
+                                 "Laptop,Electronics,999.99,10,2,\"15\"\" screen\"\n"
+                                 "Mouse,Electronics,29.99,5,,Wireless\n"
+                                 "Broken,Electronics,cheap,5,1,\n");
+    Csv::ImportReport report = productManager->importFromCSV(products, Csv::ImportOptions());
+    ASSERT_TRUE(report.ok) << report.error;
+    EXPECT_EQ(report.imported, 2u);
+    EXPECT_EQ(rejectedRows(report), (std::vector<size_t>{4}));
+
+    Product laptop;
+    ASSERT_TRUE(productManager->getProductCopy(1, laptop));
+    EXPECT_EQ(laptop.getDescription(), "15\" screen");
+
+    ASSERT_TRUE(customerManager->addCustomer(Customer(0, "John Doe", "john@email.com", "+1234567890",
+                                                      "123 Main St", "New York", "USA")));
+    std::string orders = write("orders.csv",
+                               "customer,items,notes\n"
+                               "1,1:1;2:2,first\n"
+                               "1,2:9,too many mice\n"
+                               "7,1:1,no such customer\n"
+                               "1,1:x,bad items\n"
+                               "1,2:3,\n");
+    report = orderManager->importFromCSV(orders, Csv::ImportOptions());
+    ASSERT_TRUE(report.ok) << report.error;
+    EXPECT_EQ(report.imported, 2u);
+    EXPECT_EQ(rejectedRows(report), (std::vector<size_t>{3, 4, 5}));
+
+    Order first;
+    ASSERT_TRUE(orderManager->getOrderCopy(1, first));
+    EXPECT_EQ(first.getCustomerName(), "John Doe");
+    EXPECT_EQ(first.getNotes(), "first");
+    ASSERT_EQ(first.getItems().size(), 2u);
+    EXPECT_DOUBLE_EQ(first.getTotalAmount(), 999.99 + 2 * 29.99);
+    EXPECT_EQ(orderManager->getOrdersPage(0, 10).items.size(), 2u);
+}
+
+TEST_F(CsvImportTest, RejectsFilesMissingColumns)
+{
+    Csv::ImportReport report = productManager->importFromCSV(write("bad.csv", "name,price\nLaptop,1\n"),
+                                                             Csv::ImportOptions());
+    EXPECT_FALSE(report.ok);
+    EXPECT_EQ(report.error, "missing column 'category'");
+    EXPECT_FALSE(productManager->importFromCSV("test_csv_data/missing.csv"));
+}
+
+TEST_F(CsvImportTest, ExportsFilteredProductsInParallelChunks)
+{
+    ASSERT_TRUE(productManager->addProduct(Product(0, "Laptop", "15\" screen, matte", "Electronics", 999.99, 10, 2)));
+    ASSERT_TRUE(productManager->addProduct(Product(0, "Mouse", "Wireless", "Accessories", 29.99, 5, 1)));
+    ASSERT_TRUE(productManager->addProduct(Product(0, "Cable", "", "Accessories", 4.5, 0, 0)));
+    ASSERT_TRUE(productManager->addProduct(Product(0, "Stand", "Aluminium", "Accessories", 40.0, 3, 1)));
+
+    Export::Options options;
+    options.threads = 3;
+    options.chunkRecords = 1; // a chunk per record, written back in order
+    Export::Report report = productManager->exportToFile("test_csv_data/accessories.csv", options,
+                                                         Query().where(Predicate::eq("category", "Accessories")));
+    ASSERT_TRUE(report.ok) << report.error;
+    EXPECT_EQ(report.records, 3u);
+    EXPECT_EQ(read("test_csv_data/accessories.csv"),
+              "id,name,description,category,price,stock,reserved,minStock,active\n"
+              "2,Mouse,Wireless,Accessories,29.99,5,0,1,1\n"
+              "3,Cable,,Accessories,4.5,0,0,0,1\n"
+              "4,Stand,Aluminium,Accessories,40,3,0,1,1\n");
+    EXPECT_FALSE(std::filesystem::exists("test_csv_data/accessories.csv.part"));
+
+    // Quoted fields read back intact
+    ASSERT_TRUE(productManager->exportToCSV("test_csv_data/products.csv"));
+    std::string all = read("test_csv_data/products.csv");
+    EXPECT_NE(all.find("1,Laptop,\"15\"\" screen, matte\",Electronics,999.99,10,0,2,1\n"), std::string::npos);
+
+    EXPECT_FALSE(productManager->exportToFile("test_csv_data/bad.csv", options,
+                                              Query().where(Predicate::eq("colour", "red"))).ok);
+    EXPECT_FALSE(productManager->exportToCSV("test_csv_data/no/such/dir.csv"));
+}
+
+TEST_F(CsvImportTest, ExportReplacesExistingFile)
+{
+    {
+        std::ofstream old("test_csv_data/customers.csv");
+        old << "stale contents\n";
+    }
+    ASSERT_TRUE(customerManager->addCustomer(Customer(0, "John Doe", "john@email.com", "+1234567890",
+                                                      "123 Main St", "New York", "USA")));
+    Export::Report report = customerManager->exportToFile("test_csv_data/customers.csv", Export::Options());
+    ASSERT_TRUE(report.ok) << report.error;
+
+    std::string contents = read("test_csv_data/customers.csv");
+    EXPECT_EQ(contents.find("stale"), std::string::npos);
+    EXPECT_NE(contents.find("John Doe"), std::string::npos);
+}
+
+TEST_F(CsvImportTest, ExportedOrdersImportBack)
+{
+    ASSERT_TRUE(productManager->addProduct(Product(0, "Laptop", "Work laptop", "Electronics", 999.99, 10, 2)));
+    ASSERT_TRUE(productManager->addProduct(Product(0, "Mouse", "Wireless mouse", "Electronics", 29.99, 50, 1)));
+    ASSERT_TRUE(customerManager->addCustomer(Customer(0, "John Doe", "john@email.com", "+1234567890",
+                                                      "123 Main St", "New York", "USA")));
+    for (int i = 1; i <= 3; ++i)
+    {
+        ASSERT_TRUE(orderManager->createOrder(1));
+        ASSERT_TRUE(orderManager->addItemToOrder(i, 2, i));
+    }
+    ASSERT_TRUE(orderManager->addItemToOrder(2, 1, 1));
+    ASSERT_TRUE(orderManager->confirmOrder(3));
+
+    Export::Report report = orderManager->exportToFile("test_csv_data/pending.csv", Export::Options(),
+                                                       Query().where(Predicate::eq("status", "Pending")));
+    ASSERT_TRUE(report.ok) << report.error;
+    EXPECT_EQ(report.records, 2u);
+
+    Csv::ImportReport imported = orderManager->importFromCSV("test_csv_data/pending.csv", Csv::ImportOptions());
+    ASSERT_TRUE(imported.ok) << imported.error;
+    EXPECT_EQ(imported.imported, 2u);
+
+    Order original, copy;
+    ASSERT_TRUE(orderManager->getOrderCopy(2, original));
+    ASSERT_TRUE(orderManager->getOrderCopy(5, copy));
+    ASSERT_EQ(copy.getItems().size(), 2u);
+    EXPECT_DOUBLE_EQ(copy.getTotalAmount(), original.getTotalAmount());
+}
+
+TEST_F(CsvImportTest, ExportsJsonLines)
+{
+    ASSERT_TRUE(customerManager->addCustomer(Customer(0, "Jane \"JJ\" Smith", "jane@email.com", "+1987654321",
+                                                      "456 Oak Ave\nSuite\t5", "Cairo", "Egypt")));
+    Export::Options options;
+    options.format = Export::Format::JSONL;
+    ASSERT_TRUE(customerManager->exportToFile("test_csv_data/customers.jsonl", options).ok);
+    EXPECT_EQ(read("test_csv_data/customers.jsonl"),
+              "{\"id\":1,\"name\":\"Jane \\\"JJ\\\" Smith\",\"email\":\"jane@email.com\","
+              "\"phone\":\"+1987654321\",\"address\":\"456 Oak Ave\\nSuite\\t5\",\"city\":\"Cairo\","
+              "\"country\":\"Egypt\",\"active\":true}\n");
+
+    UserManager userManager;
+    ASSERT_TRUE(userManager.exportToFile("test_csv_data/users.jsonl", options).ok);
+    std::string users = read("test_csv_data/users.jsonl");
+    EXPECT_NE(users.find("\"username\":\"admin\""), std::string::npos);
+    EXPECT_EQ(users.find("password"), std::string::npos);
+}
@@ -2,6 +2,7 @@
 #include "utils/Database.h"
 #include <filesystem>
 #include <fstream>
+#include <thread>
 
 class DatabaseTest : public ::testing::Test
 {
@@ -51,6 +52,18 @@ TEST_F(DatabaseTest, InitializeWithExistingDirectory)
     EXPECT_EQ(database->getDataDirectory(), testDir + "/");
 }
 
+TEST_F(DatabaseTest, SetDataDirectoryDoesNotCreateIt)
+{
+    std::string previous = database->getDataDirectory();
+    std::filesystem::remove_all("test_data_unset");
+
+    database->setDataDirectory("test_data_unset/");
+    EXPECT_EQ(database->getDataDirectory(), "test_data_unset/");
+    EXPECT_FALSE(std::filesystem::exists("test_data_unset"));
+
+    database->setDataDirectory(previous);
+}
+
 TEST_F(DatabaseTest, GetInstanceSingleton)
 {
     Database &db1 = Database::getInstance();
@@ -316,6 +329,124 @@ TEST_F(DatabaseTest, RestoreFromNonExistentBackup)
     EXPECT_FALSE(database->restoreFromBackup("nonexistent_backup"));
 }
 
+// Transaction Tests
+TEST_F(DatabaseTest, TransactionStagesFilesUntilCommit)
+{
+    std::filesystem::remove(database->getDataDirectory() + "tx_stage_orders.txt");
+    std::filesystem::remove(database->getDataDirectory() + "tx_stage_products.txt");
+
+    ASSERT_TRUE(database->beginTransaction());
+    EXPECT_TRUE(database->inTransaction());
+    EXPECT_TRUE(database->saveToFile("tx_stage_orders.txt", {"order 1"}));
+    EXPECT_TRUE(database->saveToFile("tx_stage_products.txt", {"product 1", "product 2"}));
+    EXPECT_TRUE(database->saveToFile("tx_stage_orders.txt", {"order 1", "order 2"}));
+    EXPECT_TRUE(database->loadFromFile("tx_stage_orders.txt").empty());
+
+    ASSERT_TRUE(database->commitTransaction());
+    EXPECT_FALSE(database->inTransaction());
+    EXPECT_EQ(database->loadFromFile("tx_stage_orders.txt").size(), 2u);
+    EXPECT_EQ(database->loadFromFile("tx_stage_products.txt").size(), 2u);
+    EXPECT_FALSE(std::filesystem::exists(database->getDataDirectory() + "journal.txt"));
+}
+
+TEST_F(DatabaseTest, AbortedTransactionWritesNothing)
+{
+    std::filesystem::remove(database->getDataDirectory() + "tx_abort_orders.txt");
+    std::filesystem::remove(database->getDataDirectory() + "tx_abort_products.txt");
+
+    ASSERT_TRUE(database->beginTransaction());
+    database->saveToFile("tx_abort_orders.txt", {"order 1"});
+    database->saveToFile("tx_abort_products.txt", {"product 1"});
+    database->abortTransaction();
+
+    EXPECT_FALSE(database->inTransaction());
+    EXPECT_TRUE(database->loadFromFile("tx_abort_orders.txt").empty());
+    EXPECT_TRUE(database->loadFromFile("tx_abort_products.txt").empty());
+}
+
+TEST_F(DatabaseTest, CommitNeverReplacesALaterCopy)
+{
+    ASSERT_TRUE(database->beginTransaction());
+    database->saveToFile("tx_order_products.txt", {"staged"});
+    database->saveToFile("tx_order_orders.txt", {"staged"});
+
+    // Another thread saves a later copy of one file before this commit gets to it
+    std::thread saver([this]
+                      { database->saveToFile("tx_order_products.txt", {"later"}); });
+    saver.join();
+
+    ASSERT_TRUE(database->commitTransaction());
+    EXPECT_EQ(database->loadFromFile("tx_order_products.txt"), std::vector<std::string>{"later"});
+    EXPECT_EQ(database->loadFromFile("tx_order_orders.txt"), std::vector<std::string>{"staged"});
+}
+
+TEST_F(DatabaseTest, SavesAreWrittenInSequenceOrder)
+{
+    std::uint64_t first = database->nextSaveSequence();
+    std::uint64_t second = database->nextSaveSequence();
+    EXPECT_LT(first, second);
+
+    EXPECT_TRUE(database->saveToFile("sequenced.txt", {"second"}, second));
+    EXPECT_TRUE(database->saveToFile("sequenced.txt", {"first"}, first));
+    EXPECT_EQ(database->loadFromFile("sequenced.txt"), std::vector<std::string>{"second"});
+
+    EXPECT_TRUE(database->saveToFile("sequenced.txt", {"third"}));
+    EXPECT_EQ(database->loadFromFile("sequenced.txt"), std::vector<std::string>{"third"});
+}
+
+TEST_F(DatabaseTest, RecoverJournalFinishesInterruptedCommit)
+{
+    // A directory in the way makes applying the journal fail after it was written
+    std::string blocked = database->getDataDirectory() + "tx_recover_blocked.txt";
+    std::filesystem::remove_all(blocked);
+    std::filesystem::create_directories(blocked);
+
+    ASSERT_TRUE(database->beginTransaction());
+    database->saveToFile("tx_recover_orders.txt", {"order 1"});
+    database->saveToFile("tx_recover_blocked.txt", {"product 1"});
+    ASSERT_TRUE(database->commitTransaction());
+    EXPECT_TRUE(std::filesystem::exists(database->getDataDirectory() + "journal.txt"));
+
+    std::filesystem::remove_all(blocked);
+    EXPECT_TRUE(database->recoverJournal());
+    EXPECT_EQ(database->loadFromFile("tx_recover_blocked.txt"), std::vector<std::string>{"product 1"});
+    EXPECT_FALSE(std::filesystem::exists(database->getDataDirectory() + "journal.txt"));
+}
+
+TEST_F(DatabaseTest, InitializeFailsWhileJournalCannotBeApplied)
+{
+    std::string blocked = database->getDataDirectory() + "tx_recover_blocked.txt";
+    std::filesystem::remove_all(blocked);
+    std::filesystem::create_directories(blocked);
+
+    ASSERT_TRUE(database->beginTransaction());
+    database->saveToFile("tx_recover_orders.txt", {"order 1"});
+    database->saveToFile("tx_recover_blocked.txt", {"product 1"});
+    ASSERT_TRUE(database->commitTransaction());
+
+    // Loading now would miss the committed product file
+    EXPECT_FALSE(database->initialize(testDir));
+    EXPECT_TRUE(std::filesystem::exists(database->getDataDirectory() + "journal.txt"));
+
+    std::filesystem::remove_all(blocked);
+    EXPECT_TRUE(database->initialize(testDir));
+    EXPECT_EQ(database->loadFromFile("tx_recover_blocked.txt"), std::vector<std::string>{"product 1"});
+    EXPECT_FALSE(std::filesystem::exists(database->getDataDirectory() + "journal.txt"));
+}
+
+TEST_F(DatabaseTest, RecoverJournalDiscardsIncompleteRecord)
+{
+    std::filesystem::remove(database->getDataDirectory() + "tx_discarded.txt");
+    {
+        std::ofstream journal(database->getDataDirectory() + "journal.txt");
+        journal << "JOURNAL|1\nFILE|tx_discarded.txt|2\norder 1\n";
+    }
+
+    EXPECT_FALSE(database->recoverJournal());
+    EXPECT_TRUE(database->loadFromFile("tx_discarded.txt").empty());
+    EXPECT_FALSE(std::filesystem::exists(database->getDataDirectory() + "journal.txt"));
+}
+
 // Edge Cases and Error Handling Tests
 TEST_F(DatabaseTest, SaveToFileWithSpecialCharacters)
 {
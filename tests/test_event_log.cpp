@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "utils/EventLog.h"
+#include <filesystem>
+#include <fstream>
+
+class EventLogTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        logPath = "test_event_logs/events.bin";
+        std::filesystem::remove_all("test_event_logs");
+        eventLog = &EventLog::getInstance();
+        ASSERT_TRUE(eventLog->initialize(logPath));
+    }
+
+    void TearDown() override
+    {
+        eventLog->close();
+        std::filesystem::remove_all("test_event_logs");
+    }
+
+    EventLog *eventLog;
+    std::string logPath;
+};
+
+TEST_F(EventLogTest, RoundTripAllEventTypes)
+{
+    eventLog->recordOrderCreated(10, 3);
+    eventLog->recordOrderStatusChanged(10, 0, 1);
+    eventLog->recordStockUpdate(5, 20, 18);
+    eventLog->recordUserLogin("admin");
+    eventLog->recordUserLogout("admin");
+    eventLog->flush();
+
+    EventLogReader reader(logPath);
+    std::vector<EventRecord> events = reader.readAll();
+
+    ASSERT_EQ(events.size(), 5u);
+    EXPECT_EQ(events[0].type, EventType::ORDER_CREATED);
+    EXPECT_EQ(events[0].entityId, 10);
+    EXPECT_EQ(events[0].relatedId, 3);
+    EXPECT_EQ(events[1].type, EventType::ORDER_STATUS_CHANGED);
+    EXPECT_EQ(events[1].newValue, 1);
+    EXPECT_EQ(events[2].type, EventType::STOCK_UPDATED);
+    EXPECT_EQ(events[2].oldValue, 20);
+    EXPECT_EQ(events[2].newValue, 18);
+    EXPECT_EQ(events[3].text, "admin");
+    EXPECT_EQ(events[4].type, EventType::USER_LOGOUT);
+    EXPECT_EQ(reader.getCorruptRecordCount(), 0u);
+}
+
+TEST_F(EventLogTest, FilterByTypeAndEntity)
+{
+    for (int i = 1; i <= 50; ++i)
+    {
+        eventLog->recordOrderCreated(i, 1);
+        eventLog->recordStockUpdate(i % 5, i, i - 1);
+    }
+    eventLog->flush();
+
+    EventFilter filter;
+    filter.hasType = true;
+    filter.type = EventType::STOCK_UPDATED;
+    filter.entityId = 2;
+
+    std::vector<EventRecord> events = EventLogReader(logPath).readAll(filter);
+    EXPECT_EQ(events.size(), 10u);
+    for (const auto &event : events)
+    {
+        EXPECT_EQ(event.type, EventType::STOCK_UPDATED);
+        EXPECT_EQ(event.entityId, 2);
+    }
+}
+
+TEST_F(EventLogTest, AppendsAcrossReopen)
+{
+    eventLog->recordOrderCreated(1, 1);
+    eventLog->close();
+
+    ASSERT_TRUE(eventLog->initialize(logPath));
+    eventLog->recordOrderCreated(2, 1);
+    eventLog->flush();
+
+    EXPECT_EQ(EventLogReader(logPath).readAll().size(), 2u);
+}
+
+TEST_F(EventLogTest, TruncatedTailIsReportedNotFatal)
+{
+    eventLog->recordOrderCreated(1, 1);
+    eventLog->recordOrderCreated(2, 1);
+    eventLog->close();
+
+    auto size = std::filesystem::file_size(logPath);
+    std::filesystem::resize_file(logPath, size - 3);
+
+    EventLogReader reader(logPath);
+    EXPECT_EQ(reader.readAll().size(), 1u);
+    EXPECT_EQ(reader.getCorruptRecordCount(), 1u);
+}
+
+TEST_F(EventLogTest, RejectsFileWithoutHeader)
+{
+    std::ofstream("test_event_logs/bad.bin") << "not an event log";
+    EventLogReader reader("test_event_logs/bad.bin");
+    EXPECT_FALSE(reader.forEach([](const EventRecord &)
+                                { return true; }));
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "utils/Histogram.h"
+#include <cmath>
+
+TEST(HistogramTest, EmptyHistogramReportsZero)
+{
+    Histogram histogram;
+    EXPECT_EQ(histogram.getCount(), 0u);
+    EXPECT_EQ(histogram.getMin(), 0u);
+    EXPECT_EQ(histogram.getMax(), 0u);
+    EXPECT_EQ(histogram.getMean(), 0.0);
+    EXPECT_EQ(histogram.percentile(99), 0u);
+}
+
+TEST(HistogramTest, SmallValuesAreExact)
+{
+    Histogram histogram;
+    for (std::uint64_t value = 1; value <= 100; ++value)
+    {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.getCount(), 100u);
+    EXPECT_EQ(histogram.getMin(), 1u);
+    EXPECT_EQ(histogram.getMax(), 100u);
+    EXPECT_DOUBLE_EQ(histogram.getMean(), 50.5);
+    EXPECT_EQ(histogram.percentile(50), 50u);
+    EXPECT_EQ(histogram.percentile(99), 99u);
+    EXPECT_EQ(histogram.percentile(100), 100u);
+    EXPECT_EQ(histogram.percentile(0), 1u);
+}
+
+TEST(HistogramTest, LargeValuesStayWithinRelativeError)
+{
+    Histogram histogram;
+    for (std::uint64_t value = 1000; value <= 1000000; value += 1000)
+    {
+        histogram.record(value);
+    }
+    const double bound = 1.0 / (1 << Histogram::SUB_BITS);
+    for (double percent : {50.0, 90.0, 99.0, 99.9})
+    {
+        double exact = std::ceil(percent * 10) * 1000;
+        double reported = static_cast<double>(histogram.percentile(percent));
+        EXPECT_GE(reported, exact) << percent;
+        EXPECT_LE(reported, exact * (1 + bound)) << percent;
+    }
+    EXPECT_EQ(histogram.percentile(100), 1000000u);
+
+    Histogram extremes;
+    extremes.record(UINT64_MAX);
+    EXPECT_EQ(extremes.percentile(50), UINT64_MAX);
+}
+
+TEST(HistogramTest, MergeMatchesRecordingEverythingInOne)
+{
+    Histogram first, second, all;
+    for (std::uint64_t value = 0; value < 5000; ++value)
+    {
+        std::uint64_t sample = value * value % 100003;
+        (value % 2 ? first : second).record(sample);
+        all.record(sample);
+    }
+    first.merge(second);
+
+    EXPECT_EQ(first.getCount(), all.getCount());
+    EXPECT_EQ(first.getMin(), all.getMin());
+    EXPECT_EQ(first.getMax(), all.getMax());
+    EXPECT_DOUBLE_EQ(first.getMean(), all.getMean());
+    for (double percent : {1.0, 50.0, 99.0, 99.9})
+    {
+        EXPECT_EQ(first.percentile(percent), all.percentile(percent)) << percent;
+    }
+
+    first.reset();
+    EXPECT_EQ(first.getCount(), 0u);
+    EXPECT_EQ(first.percentile(50), 0u);
+}
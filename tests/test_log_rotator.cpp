@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "utils/Logger.h"
+#include "utils/LogRotator.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+class LogRotatorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        logDir = "test_rotation_logs";
+        fs::remove_all(logDir);
+        fs::create_directories(logDir);
+    }
+
+    void TearDown() override
+    {
+        Logger::getInstance().close();
+        Logger::getInstance().setRotationPolicy(LogRotationPolicy());
+        fs::remove_all(logDir);
+    }
+
+    int countRotatedFiles(const std::string &suffix)
+    {
+        int count = 0;
+        for (const auto &entry : fs::directory_iterator(logDir))
+        {
+            std::string name = entry.path().filename().string();
+            if (name != "app.log" && name.size() >= suffix.size() &&
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    std::string logDir;
+};
+
+TEST_F(LogRotatorTest, ShouldRotateBySize)
+{
+    LogRotator rotator;
+    LogRotationPolicy policy;
+    policy.maxFileBytes = 100;
+    policy.rotateDaily = false;
+    rotator.setPolicy(policy);
+
+    EXPECT_FALSE(rotator.shouldRotate(50, 40, "2024-01-01", "2024-01-01"));
+    EXPECT_TRUE(rotator.shouldRotate(80, 40, "2024-01-01", "2024-01-01"));
+    // An empty file always accepts the first line
+    EXPECT_FALSE(rotator.shouldRotate(0, 400, "2024-01-01", "2024-01-01"));
+}
+
+TEST_F(LogRotatorTest, ShouldRotateByDay)
+{
+    LogRotator rotator;
+    LogRotationPolicy policy;
+    policy.maxFileBytes = 0;
+    policy.rotateDaily = true;
+    rotator.setPolicy(policy);
+
+    EXPECT_FALSE(rotator.shouldRotate(1000, 10, "2024-01-01", "2024-01-01"));
+    EXPECT_TRUE(rotator.shouldRotate(1000, 10, "2024-01-01", "2024-01-02"));
+
+    policy.rotateDaily = false;
+    rotator.setPolicy(policy);
+    EXPECT_FALSE(rotator.shouldRotate(1000, 10, "2024-01-01", "2024-01-02"));
+}
+
+TEST_F(LogRotatorTest, LoggerRotatesAndKeepsRetentionCount)
+{
+    LogRotationPolicy policy;
+    policy.maxFileBytes = 512;
+    policy.rotateDaily = false;
+    policy.maxRotatedFiles = 3;
+    policy.compress = true;
+
+    Logger &logger = Logger::getInstance();
+    logger.setRotationPolicy(policy);
+    ASSERT_TRUE(logger.initialize(logDir + "/app.log", LogLevel::INFO));
+
+    for (int i = 0; i < 200; ++i)
+    {
+        LOG_INFOF("rotation test line {} with some padding to fill the file", i);
+    }
+    logger.flush();
+    logger.waitForRotation();
+
+    std::string suffix = LogRotator::compressionAvailable() ? ".log.gz" : ".log";
+    EXPECT_EQ(countRotatedFiles(suffix), 3);
+    EXPECT_LE(fs::file_size(logDir + "/app.log"), 512u);
+}
+
+TEST_F(LogRotatorTest, RotateWithoutCompressionKeepsPlainFile)
+{
+    std::string active = logDir + "/app.log";
+    std::ofstream(active) << "old contents\n";
+
+    LogRotator rotator;
+    LogRotationPolicy policy;
+    policy.compress = false;
+    rotator.setPolicy(policy);
+    rotator.setActivePath(active);
+
+    ASSERT_TRUE(rotator.rotate("20240101-000000"));
+    rotator.waitForIdle();
+
+    EXPECT_FALSE(fs::exists(active));
+    EXPECT_TRUE(fs::exists(logDir + "/app.20240101-000000.log"));
+}
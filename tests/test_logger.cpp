@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "utils/Logger.h"
+#include "utils/Format.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+class LoggerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        logPath = "test_logs/logger_test.log";
+        std::filesystem::remove_all("test_logs");
+
+        logger = &Logger::getInstance();
+        ASSERT_TRUE(logger->initialize(logPath, LogLevel::INFO));
+    }
+
+    void TearDown() override
+    {
+        logger->close();
+        std::filesystem::remove_all("test_logs");
+    }
+
+    std::string readLog()
+    {
+        logger->flush();
+        std::ifstream file(logPath);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    Logger *logger;
+    std::string logPath;
+};
+
+static int evaluationCount = 0;
+
+static std::string expensiveMessage()
+{
+    ++evaluationCount;
+    return "expensive message";
+}
+
+// Format Tests
+TEST(FormatTest, ReplacesPlaceholdersInOrder)
+{
+    EXPECT_EQ(Utils::format("Saved {} records to {}", 42, "orders.txt"), "Saved 42 records to orders.txt");
+}
+
+TEST(FormatTest, EscapedBracesAndMissingArguments)
+{
+    EXPECT_EQ(Utils::format("{{}} {}", 1), "{} 1");
+    EXPECT_EQ(Utils::format("{} and {}", "one"), "one and {}");
+    EXPECT_EQ(Utils::format("no placeholders", 5), "no placeholders");
+}
+
+// Level Gating Tests
+TEST_F(LoggerTest, DisabledLevelDoesNotEvaluateMessage)
+{
+    evaluationCount = 0;
+    LOG_DEBUG(expensiveMessage());
+    EXPECT_EQ(evaluationCount, 0);
+
+    LOG_INFO(expensiveMessage());
+    EXPECT_EQ(evaluationCount, 1);
+}
+
+TEST_F(LoggerTest, IsEnabledFollowsLogLevel)
+{
+    EXPECT_FALSE(logger->isEnabled(LogLevel::DEBUG));
+    EXPECT_TRUE(logger->isEnabled(LogLevel::INFO));
+
+    logger->setLogLevel(LogLevel::DEBUG);
+    EXPECT_TRUE(logger->isEnabled(LogLevel::DEBUG));
+    logger->setLogLevel(LogLevel::INFO);
+}
+
+// Output Tests
+TEST_F(LoggerTest, FormattedMessageIsWritten)
+{
+    LOG_INFOF("Order {} moved to {}", 7, "Shipped");
+    LOG_DEBUGF("Hidden {}", 1);
+
+    std::string contents = readLog();
+    EXPECT_NE(contents.find("[INFO] Order 7 moved to Shipped"), std::string::npos);
+    EXPECT_EQ(contents.find("Hidden"), std::string::npos);
+}
+
+TEST_F(LoggerTest, FormattedMessageCopiesCStrings)
+{
+    {
+        std::string format = "Customer {} in {}";
+        char city[16] = "Cairo";
+        std::string name = "Jane";
+        LOG_INFOF(format.c_str(), name.c_str(), city);
+        format.assign(64, 'x');
+        name.assign(64, 'y');
+        city[0] = '\0';
+    }
+
+    std::string contents = readLog();
+    EXPECT_NE(contents.find("[INFO] Customer Jane in Cairo"), std::string::npos);
+}
+
+TEST_F(LoggerTest, MessagesKeepSubmissionOrder)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        LOG_INFOF("line {}", i);
+    }
+
+    std::string contents = readLog();
+    size_t first = contents.find("line 0\n");
+    size_t last = contents.find("line 99\n");
+    ASSERT_NE(first, std::string::npos);
+    ASSERT_NE(last, std::string::npos);
+    EXPECT_LT(first, last);
+}
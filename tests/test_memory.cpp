@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "managers/CustomerManager.h"
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "managers/UserManager.h"
+#include "utils/Database.h"
+#include "utils/Memory.h"
+#include "utils/Utils.h"
+#include "TestDataDir.h"
+#include <cstring>
+
+namespace
+{
+    size_t fieldBytes(const MemoryUsage &usage, const char *field)
+    {
+        for (const auto &entry : usage.fields)
+        {
+            if (std::strcmp(entry.first, field) == 0)
+            {
+                return entry.second;
+            }
+        }
+        return 0;
+    }
+}
+
+TEST(MemoryTest, CountsOnlyStringsOutsideTheInlineBuffer)
+{
+    std::string shortText = "abc";
+    std::string longText(200, 'x');
+    EXPECT_EQ(Memory::stringHeapBytes(shortText), 0u);
+    EXPECT_GE(Memory::stringHeapBytes(longText), 201u);
+
+    std::vector<int> values;
+    values.reserve(100);
+    EXPECT_EQ(Memory::vectorHeapBytes(values), 100 * sizeof(int));
+
+    MemoryUsage usage;
+    usage.addString("text", longText);
+    usage.addString("text", shortText);
+    usage.addVector("values", values);
+    EXPECT_EQ(usage.stringBytes, Memory::stringHeapBytes(longText));
+    EXPECT_EQ(usage.vectorBytes, 100 * sizeof(int));
+    ASSERT_EQ(usage.fields.size(), 2u);
+    EXPECT_EQ(fieldBytes(usage, "text"), usage.stringBytes);
+    EXPECT_EQ(usage.total(), usage.stringBytes + usage.vectorBytes);
+}
+
+TEST(MemoryTest, FormatsBytes)
+{
+    EXPECT_EQ(Utils::formatBytes(512), "512 B");
+    EXPECT_EQ(Utils::formatBytes(1536), "1.5 KB");
+    EXPECT_EQ(Utils::formatBytes(3u * 1024 * 1024), "3.0 MB");
+}
+
+TEST(MemoryTest, ManagersReportRecordsStringsAndIndexes)
+{
+    TestDataDir dataDir("test_memory_data");
+    ASSERT_TRUE(dataDir.isReady());
+
+    {
+        ProductManager products;
+        CustomerManager customers;
+        UserManager users;
+        OrderManager orders(&products, &customers);
+
+        std::string longName(100, 'n');
+        ASSERT_TRUE(customers.addCustomer(Customer(0, "Memory Customer", "memory@example.com", "+1-555-0102",
+                                                   "1 A Street Long Enough To Leave The Inline Buffer", "Cairo",
+                                                   "Egypt")));
+        ASSERT_TRUE(products.addProduct(Product(0, longName, "Accounted", "Books", 10.0, 1000, 1)));
+        for (int i = 0; i < 10; ++i)
+        {
+            int orderId = 0;
+            ASSERT_TRUE(orders.createOrder(1, orderId));
+            ASSERT_TRUE(orders.addItemToOrder(orderId, 1, 1));
+        }
+
+        MemoryUsage orderUsage = orders.getMemoryUsage();
+        EXPECT_EQ(orderUsage.component, "orders");
+        EXPECT_EQ(orderUsage.objects, 10u);
+        EXPECT_GE(orderUsage.recordBytes, 10 * sizeof(Order));
+        EXPECT_GE(orderUsage.vectorBytes, 10 * sizeof(OrderItem));
+        // Every item carries its own copy of the 100-character product name
+        EXPECT_GE(fieldBytes(orderUsage, "item productName"), 10 * 101u);
+        EXPECT_GT(fieldBytes(orderUsage, "shippingAddress"), 0u);
+        EXPECT_GT(orderUsage.indexBytes, 0u);
+        EXPECT_EQ(orderUsage.total(), orderUsage.recordBytes + orderUsage.stringBytes + orderUsage.vectorBytes +
+                                          orderUsage.indexBytes);
+
+        MemoryUsage productUsage = products.getMemoryUsage();
+        EXPECT_EQ(productUsage.objects, 1u);
+        EXPECT_GE(fieldBytes(productUsage, "name"), 101u);
+        // The lower-case name index keeps its own copy
+        EXPECT_GE(productUsage.indexBytes, 101u);
+
+        MemoryUsage customerUsage = customers.getMemoryUsage();
+        EXPECT_EQ(customerUsage.objects, 1u);
+        EXPECT_GE(customerUsage.recordBytes, sizeof(Customer));
+        EXPECT_GT(fieldBytes(customerUsage, "address"), 0u);
+
+        EXPECT_EQ(users.getMemoryUsage().objects, static_cast<size_t>(users.getTotalUsers()));
+    }
+}
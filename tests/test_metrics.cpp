@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "managers/CustomerManager.h"
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "utils/Database.h"
+#include "utils/Metrics.h"
+#include "TestDataDir.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const Histogram *findLatency(const std::vector<std::pair<std::string, Histogram>> &snapshots,
+                                 const std::string &name)
+    {
+        for (const auto &entry : snapshots)
+        {
+            if (entry.first == name)
+            {
+                return &entry.second;
+            }
+        }
+        return nullptr;
+    }
+}
+
+TEST(MetricsTest, CountersAndLatenciesAreSharedByName)
+{
+    Metrics &metrics = Metrics::getInstance();
+    Counter &counter = metrics.counter("test_events");
+    EXPECT_EQ(&counter, &metrics.counter("test_events"));
+    counter.reset();
+    counter.increment();
+    counter.increment(4);
+    EXPECT_EQ(counter.get(), 5u);
+
+    LatencyHistogram &latency = metrics.latency("test_operation");
+    EXPECT_EQ(&latency, &metrics.latency("test_operation"));
+    latency.reset();
+    latency.record(1000);
+    latency.record(3000);
+    Histogram snapshot = latency.snapshot();
+    EXPECT_EQ(snapshot.getCount(), 2u);
+    EXPECT_EQ(latency.getSum(), 4000u);
+    EXPECT_EQ(snapshot.getMax(), 3000u);
+}
+
+TEST(MetricsTest, ConcurrentRecordingLosesNothing)
+{
+    LatencyHistogram latency;
+    Counter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&latency, &counter, t]()
+                             {
+                                 for (int i = 0; i < 10000; ++i)
+                                 {
+                                     latency.record(static_cast<std::uint64_t>(t * 10000 + i));
+                                     counter.increment();
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    Histogram snapshot = latency.snapshot();
+    EXPECT_EQ(counter.get(), 40000u);
+    EXPECT_EQ(snapshot.getCount(), 40000u);
+    EXPECT_EQ(snapshot.getMax(), 39999u);
+    EXPECT_EQ(latency.getSum(), 39999ull * 40000 / 2);
+}
+
+TEST(MetricsTest, ManagerOperationsAreTimed)
+{
+    TestDataDir dataDir("test_metrics_data");
+    ASSERT_TRUE(dataDir.isReady());
+    Metrics::getInstance().reset();
+
+    {
+        ProductManager products;
+        CustomerManager customers;
+        OrderManager orders(&products, &customers);
+        ASSERT_TRUE(customers.addCustomer(Customer(0, "Metrics Customer", "metrics@example.com", "+1-555-0100",
+                                                   "1 Main St", "Cairo", "Egypt")));
+        ASSERT_TRUE(products.addProduct(Product(0, "Metrics Product", "Timed", "Books", 10.0, 100, 1)));
+        int orderId = 0;
+        ASSERT_TRUE(orders.createOrder(1, orderId));
+        ASSERT_TRUE(orders.addItemToOrder(orderId, 1, 2));
+        ASSERT_TRUE(orders.updateOrderStatus(orderId, OrderStatus::CONFIRMED));
+    }
+
+    Metrics &metrics = Metrics::getInstance();
+    auto snapshots = metrics.latencySnapshots();
+    for (const char *name : {"order_create", "order_add_item", "order_update_status", "order_save",
+                             "database_write", "database_commit"})
+    {
+        const Histogram *latency = findLatency(snapshots, name);
+        ASSERT_NE(latency, nullptr) << name;
+        EXPECT_GE(latency->getCount(), 1u) << name;
+    }
+    EXPECT_EQ(metrics.counter("orders_created").get(), 1u);
+    EXPECT_GT(metrics.counter("database_bytes_written").get(), 0u);
+}
+
+TEST(MetricsTest, WritesPrometheusText)
+{
+    Metrics &metrics = Metrics::getInstance();
+    metrics.reset();
+    metrics.counter("test_events").increment(7);
+    metrics.latency("test_operation").record(2000000); // 2 ms
+
+    const std::string filename = "test_metrics.prom";
+    ASSERT_TRUE(metrics.writePrometheus(filename));
+    EXPECT_FALSE(std::filesystem::exists(filename + ".tmp"));
+
+    std::ifstream in(filename);
+    std::stringstream text;
+    text << in.rdbuf();
+    std::string content = text.str();
+    EXPECT_NE(content.find("# TYPE ordermgmt_test_events_total counter\nordermgmt_test_events_total 7\n"),
+              std::string::npos);
+    EXPECT_NE(content.find("# TYPE ordermgmt_operation_duration_seconds summary\n"), std::string::npos);
+    EXPECT_NE(content.find("ordermgmt_operation_duration_seconds{operation=\"test_operation\",quantile=\"0.99\"} 0.002"),
+              std::string::npos);
+    EXPECT_NE(content.find("ordermgmt_operation_duration_seconds_count{operation=\"test_operation\"} 1\n"),
+              std::string::npos);
+    std::filesystem::remove(filename);
+}
+
+TEST(MetricsTest, PeriodicDumpRewritesTheFile)
+{
+    Metrics &metrics = Metrics::getInstance();
+    const std::string filename = "test_metrics_dump.prom";
+    std::filesystem::remove(filename);
+
+    metrics.counter("test_dumps").reset();
+    ASSERT_TRUE(metrics.startDump(filename, std::chrono::milliseconds(10)));
+    EXPECT_TRUE(std::filesystem::exists(filename));
+    metrics.counter("test_dumps").increment(3);
+    metrics.stopDump();
+
+    // stopDump writes once more, so the last value is always in the file
+    std::ifstream in(filename);
+    std::stringstream text;
+    text << in.rdbuf();
+    EXPECT_NE(text.str().find("ordermgmt_test_dumps_total 3\n"), std::string::npos);
+    std::filesystem::remove(filename);
+}
@@ -5,6 +5,12 @@
 #include "models/Order.h"
 #include "models/Product.h"
 #include "models/Customer.h"
+#include "utils/Database.h"
+#include "utils/Transaction.h"
+#include "TestDataDir.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 class OrderManagerTest : public ::testing::Test
 {
@@ -506,4 +512,283 @@ TEST_F(OrderManagerTest, LargeOrderQuantities)
 
     // Check that stock is properly reserved/checked
     EXPECT_FALSE(orderManager->addItemToOrder(1, product2.getProductId(), 60)); // Would exceed total stock
-}
\ No newline at end of file
+}
+
+// Stock reservation ledger, in an isolated data directory
+class OrderReservationTest : public ManagerTest
+{
+protected:
+    OrderReservationTest() : ManagerTest("test_reservation_data") {}
+
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(ManagerTest::SetUp());
+
+        ASSERT_TRUE(customerManager->addCustomer(Customer(0, "John Doe", "john@email.com", "+1234567890",
+                                                          "123 Main St", "New York", "USA")));
+        ASSERT_TRUE(productManager->addProduct(Product(0, "Laptop", "High-performance laptop",
+                                                       "Electronics", 999.99, 10, 2)));
+        ASSERT_TRUE(orderManager->createOrder(1));
+        ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 4));
+    }
+
+    Product product()
+    {
+        Product copy;
+        productManager->getProductCopy(1, copy);
+        return copy;
+    }
+};
+
+TEST_F(OrderReservationTest, PendingOrderDoesNotReserve)
+{
+    EXPECT_EQ(product().getReservedQuantity(), 0);
+    EXPECT_EQ(productManager->getAvailableQuantity(1), 10);
+}
+
+TEST_F(OrderReservationTest, ConfirmReservesShipCommits)
+{
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    EXPECT_EQ(product().getStockQuantity(), 10);
+    EXPECT_EQ(product().getReservedQuantity(), 4);
+    EXPECT_EQ(productManager->getAvailableQuantity(1), 6);
+    EXPECT_TRUE(orderManager->canFulfillOrder(1));
+
+    ASSERT_TRUE(orderManager->processOrder(1));
+    ASSERT_TRUE(orderManager->shipOrder(1));
+    EXPECT_EQ(product().getStockQuantity(), 6);
+    EXPECT_EQ(product().getReservedQuantity(), 0);
+}
+
+TEST_F(OrderReservationTest, CancelReleasesReservation)
+{
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    ASSERT_TRUE(orderManager->cancelOrder(1));
+    EXPECT_EQ(product().getStockQuantity(), 10);
+    EXPECT_EQ(product().getReservedQuantity(), 0);
+}
+
+TEST_F(OrderReservationTest, ConfirmFailsWhenStockIsReservedElsewhere)
+{
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(2, 1, 8));
+
+    ASSERT_TRUE(orderManager->confirmOrder(2));
+    EXPECT_FALSE(orderManager->confirmOrder(1));
+    EXPECT_EQ(orderManager->getOrdersByStatusCount(OrderStatus::PENDING), 1);
+    EXPECT_EQ(product().getReservedQuantity(), 8);
+}
+
+TEST_F(OrderReservationTest, StockCannotBeSetBelowReserved)
+{
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    EXPECT_FALSE(productManager->updateStock(1, 3));
+    EXPECT_EQ(product().getStockQuantity(), 10);
+
+    BatchResult result = productManager->updateStocks({{1, 2}, {1, 4}});
+    EXPECT_EQ(result.applied, 1u);
+    ASSERT_EQ(result.failures.size(), 1u);
+    EXPECT_EQ(result.failures[0].row, 0u);
+    EXPECT_EQ(product().getStockQuantity(), 4);
+    EXPECT_EQ(productManager->getAvailableQuantity(1), 0);
+
+    ASSERT_TRUE(orderManager->processOrder(1));
+    ASSERT_TRUE(orderManager->shipOrder(1));
+    EXPECT_EQ(product().getStockQuantity(), 0);
+}
+
+TEST_F(OrderReservationTest, AbortRestoresOnlyWhatWasReleased)
+{
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    {
+        Transaction transaction;
+        productManager->releaseReservedStock({{1, 9}});
+        EXPECT_EQ(product().getReservedQuantity(), 0);
+    }
+    EXPECT_EQ(product().getReservedQuantity(), 4);
+    EXPECT_EQ(productManager->getAvailableQuantity(1), 6);
+}
+
+TEST_F(OrderReservationTest, ItemChangesOnConfirmedOrderAdjustReservation)
+{
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+
+    EXPECT_TRUE(orderManager->updateOrderItemQuantity(1, 1, 6));
+    EXPECT_EQ(product().getReservedQuantity(), 6);
+    EXPECT_FALSE(orderManager->updateOrderItemQuantity(1, 1, 11));
+
+    EXPECT_TRUE(orderManager->removeItemFromOrder(1, 1));
+    EXPECT_EQ(product().getReservedQuantity(), 0);
+}
+
+TEST_F(OrderReservationTest, LedgerIsRebuiltForProductsFileWithoutReservations)
+{
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    orderManager.reset();
+    productManager.reset();
+
+    // Rewrite products.txt the way versions before the ledger did (no reserved field)
+    std::vector<std::string> lines = Database::getInstance().loadProducts();
+    for (auto &line : lines)
+    {
+        line = line.substr(0, line.find_last_of('|'));
+    }
+    ASSERT_TRUE(Database::getInstance().saveProducts(lines));
+
+    productManager = std::make_unique<ProductManager>();
+    EXPECT_TRUE(productManager->reservationsNeedRebuild());
+    orderManager = std::make_unique<OrderManager>(productManager.get(), customerManager.get());
+    EXPECT_FALSE(productManager->reservationsNeedRebuild());
+    EXPECT_EQ(product().getReservedQuantity(), 4);
+    EXPECT_EQ(product().getStockQuantity(), 10);
+}
+
+TEST_F(OrderReservationTest, SnapshotsAreUnaffectedByLaterWrites)
+{
+    OrderSnapshot orders = orderManager->getSnapshot();
+    ProductSnapshot products = productManager->getSnapshot();
+
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(productManager->addStock(1, 5));
+
+    ASSERT_EQ(orders.size(), 1u);
+    EXPECT_EQ(orders[0].getStatus(), OrderStatus::PENDING);
+    EXPECT_EQ(orders[0].getItems()[0].quantity, 4);
+    ASSERT_EQ(products.size(), 1u);
+    EXPECT_EQ(products[0].getStockQuantity(), 10);
+    EXPECT_EQ(products[0].getReservedQuantity(), 0);
+
+    EXPECT_EQ(orderManager->getTotalOrders(), 2);
+    EXPECT_EQ(orderManager->getOrdersByStatusCount(OrderStatus::CONFIRMED), 1);
+    EXPECT_EQ(product().getStockQuantity(), 15);
+    EXPECT_EQ(product().getReservedQuantity(), 4);
+}
+
+TEST_F(OrderReservationTest, SnapshotsStayFixedDuringStockUpdates)
+{
+    std::atomic<bool> done(false);
+    std::thread stocker([this, &done]
+                        {
+                            for (int i = 0; i < 200; ++i)
+                            {
+                                productManager->addStock(1, 1);
+                                productManager->reduceStock(1, 1);
+                            }
+                            done = true; });
+
+    int changed = 0;
+    while (!done)
+    {
+        ProductSnapshot view = productManager->getSnapshot();
+        int stock = view[0].getStockQuantity();
+        std::this_thread::yield();
+        changed += view[0].getStockQuantity() != stock ? 1 : 0;
+    }
+    stocker.join();
+
+    EXPECT_EQ(changed, 0);
+    EXPECT_EQ(product().getStockQuantity(), 10);
+}
+
+TEST(VersionedVectorTest, SnapshotWaitsOnlyWhileAnInPlaceWriteIsRegistered)
+{
+    VersionedVector<int> records;
+    records.push_back(1);
+
+    InPlaceWrite<int> write = records.beginInPlace();
+    ASSERT_TRUE(records.canWriteInPlace(0));
+    std::atomic<bool> taken(false);
+    std::thread reader([&records, &taken]
+                       {
+                           Snapshot<int> view = records.snapshot();
+                           taken = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(taken);
+
+    records.inPlaceAt(0) = 2;
+    write.end();
+    reader.join();
+    EXPECT_TRUE(taken);
+
+    // Once the snapshot holds the version, writers must copy instead
+    Snapshot<int> view = records.snapshot();
+    InPlaceWrite<int> next = records.beginInPlace();
+    EXPECT_FALSE(records.canWriteInPlace(0));
+    EXPECT_EQ(view[0], 2);
+}
+
+TEST_F(OrderReservationTest, LookupsDoNotCopyRecords)
+{
+    ProductSnapshot products = productManager->getSnapshot();
+    OrderSnapshot orders = orderManager->getSnapshot();
+
+    EXPECT_EQ(productManager->getProduct(1), &products[0]);
+    EXPECT_EQ(orderManager->getOrder(1), &orders[0]);
+}
+
+TEST_F(OrderReservationTest, SnapshotsShareUnchangedRecords)
+{
+    OrderSnapshot before = orderManager->getSnapshot();
+    ASSERT_TRUE(orderManager->createOrder(1));
+    OrderSnapshot after = orderManager->getSnapshot();
+
+    ASSERT_EQ(after.size(), 2u);
+    EXPECT_EQ(&before[0], &after[0]);
+
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    EXPECT_NE(&orderManager->getSnapshot()[0], &after[0]);
+}
+
+TEST_F(OrderReservationTest, ForEachAppliesFilterAndLimit)
+{
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+
+    std::vector<int> pending;
+    size_t visited = orderManager->forEach([&pending](const Order &order)
+                                           {
+                                               pending.push_back(order.getOrderId());
+                                               return true; },
+                                           [](const Order &order)
+                                           { return order.getStatus() == OrderStatus::PENDING; });
+    EXPECT_EQ(visited, 2u);
+    EXPECT_EQ(pending, (std::vector<int>{2, 3}));
+
+    EXPECT_EQ(orderManager->forEach([](const Order &)
+                                    { return true; },
+                                    nullptr, 2),
+              2u);
+    EXPECT_EQ(orderManager->forEach([](const Order &)
+                                    { return false; }),
+              1u);
+}
+
+TEST_F(OrderReservationTest, ForEachVisitorMayCallBackIntoManager)
+{
+    // Order scans run over a snapshot, so a visitor can change the orders it visits
+    ASSERT_TRUE(orderManager->createOrder(1));
+    size_t confirmed = orderManager->forEach([this](const Order &order)
+                                             { return orderManager->confirmOrder(order.getOrderId()); },
+                                             [](const Order &order)
+                                             { return !order.getItems().empty(); });
+    EXPECT_EQ(confirmed, 1u);
+    EXPECT_EQ(orderManager->getOrdersByStatusCount(OrderStatus::CONFIRMED), 1);
+
+    int products = 0;
+    productManager->forEach([this, &products](const Product &product)
+                            {
+                                productManager->addStock(product.getProductId(), 1);
+                                ++products;
+                                return true; });
+    EXPECT_EQ(products, 1);
+    EXPECT_EQ(product().getStockQuantity(), 11);
+
+    std::string names;
+    customerManager->forEach([&names](const Customer &customer)
+                             {
+                                 names += customer.getName();
+                                 return true; });
+    EXPECT_EQ(names, "John Doe");
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "models/Product.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 
 class ProductTest : public ::testing::Test
 {
@@ -313,4 +316,112 @@ TEST_F(ProductTest, StockBoundaryConditions)
     product.addStock(5);
     EXPECT_EQ(product.getStockQuantity(), 5);
     EXPECT_TRUE(product.isInStock());
-}
\ No newline at end of file
+}
+
+TEST_F(ProductTest, ConcurrentReduceStockNeverOversells)
+{
+    Product product = validProduct;
+    product.setStockQuantity(1000);
+
+    std::atomic<int> successes(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&product, &successes]
+                             {
+                                 for (int i = 0; i < 200; ++i)
+                                 {
+                                     if (product.reduceStock(1))
+                                     {
+                                         ++successes;
+                                     }
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(successes.load(), 1000);
+    EXPECT_EQ(product.getStockQuantity(), 0);
+}
+
+TEST_F(ProductTest, CopyKeepsStockQuantity)
+{
+    Product product = validProduct;
+    product.setStockQuantity(42);
+
+    Product copy(product);
+    Product assigned;
+    assigned = product;
+
+    EXPECT_EQ(copy.getStockQuantity(), 42);
+    EXPECT_EQ(assigned.getStockQuantity(), 42);
+    product.reduceStock(2);
+    EXPECT_EQ(copy.getStockQuantity(), 42);
+}
+
+// Reservation Ledger Tests
+TEST_F(ProductTest, ReserveReducesAvailableNotOnHand)
+{
+    Product product = validProduct;
+    product.setStockQuantity(10);
+
+    EXPECT_TRUE(product.reserve(4));
+    EXPECT_EQ(product.getStockQuantity(), 10);
+    EXPECT_EQ(product.getReservedQuantity(), 4);
+    EXPECT_EQ(product.getAvailableQuantity(), 6);
+    EXPECT_FALSE(product.reserve(7));
+    EXPECT_FALSE(product.reduceStock(7)); // reserved stock can't be sold elsewhere
+    EXPECT_TRUE(product.isInStock(6));
+    EXPECT_FALSE(product.isInStock(7));
+}
+
+TEST_F(ProductTest, CommitAndReleaseReservation)
+{
+    Product product = validProduct;
+    product.setStockQuantity(10);
+    ASSERT_TRUE(product.reserve(6));
+
+    int previous = 0;
+    EXPECT_TRUE(product.commitReservation(4, &previous));
+    EXPECT_EQ(previous, 10);
+    EXPECT_EQ(product.getStockQuantity(), 6);
+    EXPECT_EQ(product.getReservedQuantity(), 2);
+
+    EXPECT_FALSE(product.commitReservation(3)); // only 2 left reserved
+    EXPECT_EQ(product.releaseReservation(5), 2); // clamps at zero
+    EXPECT_EQ(product.getReservedQuantity(), 0);
+    EXPECT_EQ(product.getAvailableQuantity(), 6);
+}
+
+TEST_F(ProductTest, StockCannotDropBelowReserved)
+{
+    Product product = validProduct;
+    product.setStockQuantity(10);
+    ASSERT_TRUE(product.reserve(6));
+
+    EXPECT_FALSE(product.setStockQuantity(5));
+    EXPECT_EQ(product.getStockQuantity(), 10);
+    int previous = 0;
+    EXPECT_TRUE(product.setStockQuantity(6, &previous));
+    EXPECT_EQ(previous, 10);
+    EXPECT_EQ(product.getAvailableQuantity(), 0);
+    EXPECT_FALSE(product.adjustStock(-7, -6)); // on-hand would go negative
+}
+
+TEST_F(ProductTest, ReservedQuantitySurvivesSerialization)
+{
+    Product product = validProduct;
+    product.setStockQuantity(20);
+    ASSERT_TRUE(product.reserve(5));
+
+    Product restored = Product::deserialize(product.serialize());
+    EXPECT_EQ(restored.getStockQuantity(), 20);
+    EXPECT_EQ(restored.getReservedQuantity(), 5);
+
+    // Records written before the reserved column existed
+    Product legacy = Product::deserialize("7|Pen|Blue pen|Office|1.5|30|5|1");
+    EXPECT_EQ(legacy.getStockQuantity(), 30);
+    EXPECT_EQ(legacy.getReservedQuantity(), 0);
+}
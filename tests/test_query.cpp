@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "managers/CustomerManager.h"
+#include "utils/Database.h"
+#include "utils/Query.h"
+#include "utils/Transaction.h"
+#include "TestDataDir.h"
+
+TEST(PredicateTest, LeavesCompareCaseInsensitively)
+{
+    EXPECT_TRUE(Predicate::eq("category", "books").matches(std::string_view("Books")));
+    EXPECT_FALSE(Predicate::eq("category", "books").matches(std::string_view("Bookshelves")));
+    EXPECT_TRUE(Predicate::contains("name", "LAP").matches(std::string_view("Gaming laptop")));
+    EXPECT_TRUE(Predicate::range("price", 10, 20).matches(20.0));
+    EXPECT_FALSE(Predicate::range("price", 10, 20).matches(20.5));
+    EXPECT_TRUE(Predicate::in("id", {1, 3}).matches(3.0));
+    EXPECT_FALSE(Predicate::in("id", {1, 3}).matches(2.0));
+
+    // Numbers never equal text
+    EXPECT_FALSE(Predicate::eq("id", "1").matches(1.0));
+}
+
+TEST(PredicateTest, CombinationsFlattenIntoConjuncts)
+{
+    Predicate filter = Predicate::eq("a", 1) && Predicate::eq("b", 2) && (Predicate::eq("c", 3) || Predicate::eq("d", 4));
+    ASSERT_EQ(filter.conjuncts().size(), 3u);
+    EXPECT_EQ(filter.toString(), "(a = 1 AND b = 2 AND (c = 3 OR d = 4))");
+
+    EXPECT_TRUE(Predicate().conjuncts().empty());
+    EXPECT_EQ((Predicate() && Predicate::eq("a", 1)).toString(), "a = 1");
+}
+
+class QueryTest : public ManagerTest
+{
+protected:
+    QueryTest() : ManagerTest("test_query_data") {}
+
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(ManagerTest::SetUp());
+
+        ASSERT_TRUE(customerManager->addCustomer(Customer(0, "John Doe", "john@email.com", "+1234567890",
+                                                          "123 Main St", "New York", "USA")));
+        ASSERT_TRUE(customerManager->addCustomer(Customer(0, "Jane Smith", "jane@email.com", "+1987654321",
+                                                          "456 Oak Ave", "Cairo", "Egypt")));
+
+        ASSERT_TRUE(productManager->addProduct(Product(0, "Laptop", "Work laptop", "Electronics", 999.99, 10, 2)));
+        ASSERT_TRUE(productManager->addProduct(Product(0, "Mouse", "Wireless mouse", "Electronics", 29.99, 100, 5)));
+        ASSERT_TRUE(productManager->addProduct(Product(0, "Novel", "Paperback", "Books", 12.5, 40, 5)));
+        ASSERT_TRUE(productManager->addProduct(Product(0, "Atlas", "World atlas", "Books", 45.0, 0, 1)));
+    }
+
+    static std::vector<std::string> names(const std::vector<Product> &products)
+    {
+        std::vector<std::string> result;
+        for (const auto &product : products)
+        {
+            result.push_back(product.getName());
+        }
+        return result;
+    }
+};
+
+TEST_F(QueryTest, PlannerUsesIndexForEqualityAndScansOtherwise)
+{
+    Query byCategory = Query().where(Predicate::range("price", 10, 50) && Predicate::eq("category", "books"));
+    EXPECT_EQ(productManager->explain(byCategory),
+              "products: index lookup on category ('books')\n"
+              "  filter price BETWEEN 10 AND 50");
+    EXPECT_EQ(names(productManager->query(byCategory)), (std::vector<std::string>{"Novel", "Atlas"}));
+
+    Query byName = Query().where(Predicate::contains("name", "o")).orderBy("price", false).limit(2);
+    EXPECT_EQ(productManager->explain(byName),
+              "products: full scan\n"
+              "  filter name CONTAINS 'o'\n"
+              "  sort by price desc\n"
+              "  offset 0, limit 2");
+    EXPECT_EQ(names(productManager->query(byName)), (std::vector<std::string>{"Laptop", "Mouse"}));
+}
+
+TEST_F(QueryTest, CheapFiltersRunFirst)
+{
+    Query query = Query().where(Predicate::contains("description", "a") || Predicate::eq("stock", 0))
+                      .where(Predicate::contains("name", "a"))
+                      .where(Predicate::range("price", 0, 100));
+    EXPECT_EQ(productManager->explain(query),
+              "products: full scan\n"
+              "  filter price BETWEEN 0 AND 100\n"
+              "  filter name CONTAINS 'a'\n"
+              "  filter (description CONTAINS 'a' OR stock = 0)");
+    EXPECT_EQ(names(productManager->query(query)), (std::vector<std::string>{"Atlas"}));
+}
+
+TEST_F(QueryTest, InUsesIndexAndKeepsRecordOrder)
+{
+    Query query = Query().where(Predicate::in("id", {4, 1, 99}));
+    EXPECT_EQ(productManager->explain(query), "products: index lookup on id (4, 1, 99)");
+    EXPECT_EQ(names(productManager->query(query)), (std::vector<std::string>{"Laptop", "Atlas"}));
+}
+
+TEST_F(QueryTest, OffsetAndLimitPage)
+{
+    Query page = Query().orderBy("name").offset(1).limit(2);
+    EXPECT_EQ(names(productManager->query(page)), (std::vector<std::string>{"Laptop", "Mouse"}));
+    EXPECT_TRUE(productManager->query(Query().offset(10)).empty());
+}
+
+TEST_F(QueryTest, UnknownFieldIsRejected)
+{
+    Query query = Query().where(Predicate::eq("colour", "red"));
+    EXPECT_EQ(productManager->explain(query), "products: invalid query: unknown field 'colour'");
+    EXPECT_TRUE(productManager->query(query).empty());
+    EXPECT_TRUE(productManager->query(Query().orderBy("colour")).empty());
+}
+
+TEST_F(QueryTest, IndexesFollowWrites)
+{
+    Product atlas;
+    ASSERT_TRUE(productManager->getProductCopy(4, atlas));
+    atlas.setCategory("Maps");
+    ASSERT_TRUE(productManager->updateProduct(atlas));
+    ASSERT_TRUE(productManager->deleteProduct(3));
+
+    EXPECT_TRUE(productManager->getProductsByCategory("Books").empty());
+    EXPECT_EQ(names(productManager->getProductsByCategory("maps")), (std::vector<std::string>{"Atlas"}));
+    EXPECT_EQ(names(productManager->query(Query().where(Predicate::eq("id", 4)))), (std::vector<std::string>{"Atlas"}));
+}
+
+TEST_F(QueryTest, OrderQueriesUseCustomerIndex)
+{
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->createOrder(2));
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(3, 2, 1));
+    ASSERT_TRUE(orderManager->confirmOrder(3));
+    ASSERT_TRUE(orderManager->deleteOrder(1));
+
+    Query query = Query().where(Predicate::eq("customer", 1) && Predicate::eq("status", "confirmed"));
+    EXPECT_EQ(orderManager->explain(query),
+              "orders: index lookup on customer (1)\n"
+              "  filter status = 'confirmed'");
+    std::vector<Order> orders = orderManager->query(query);
+    ASSERT_EQ(orders.size(), 1u);
+    EXPECT_EQ(orders[0].getOrderId(), 3);
+
+    EXPECT_EQ(orderManager->getOrdersByCustomer(1).size(), 1u);
+    EXPECT_EQ(orderManager->searchOrders("cairo").size(), 1u);
+    EXPECT_EQ(orderManager->getOrdersByDateRange("2000-01-01", "2999-12-31").size(), 2u);
+}
+
+TEST_F(QueryTest, CustomerQueriesScan)
+{
+    EXPECT_EQ(customerManager->explain(Query().where(Predicate::eq("city", "cairo"))),
+              "customers: full scan\n"
+              "  filter city = 'cairo'");
+    ASSERT_EQ(customerManager->getCustomersByCity("CAIRO").size(), 1u);
+    EXPECT_EQ(customerManager->getCustomersByCountry("usa")[0].getName(), "John Doe");
+}
+
+TEST_F(QueryTest, PagesFollowIdCursor)
+{
+    Page<Product> first = productManager->getProductsPage(0, 3);
+    EXPECT_EQ(names(first.items), (std::vector<std::string>{"Laptop", "Mouse", "Novel"}));
+    EXPECT_TRUE(first.hasMore);
+    EXPECT_EQ(first.nextCursor, 3);
+
+    // The cursor is an id, so deleting a shown record doesn't shift the next page
+    ASSERT_TRUE(productManager->deleteProduct(2));
+    Page<Product> second = productManager->getProductsPage(first.nextCursor, 3);
+    EXPECT_EQ(names(second.items), (std::vector<std::string>{"Atlas"}));
+    EXPECT_FALSE(second.hasMore);
+
+    Page<Product> past = productManager->getProductsPage(second.nextCursor, 3);
+    EXPECT_TRUE(past.items.empty());
+    EXPECT_EQ(past.nextCursor, second.nextCursor);
+
+    Page<Customer> customers = customerManager->getCustomersPage(1, 10);
+    ASSERT_EQ(customers.items.size(), 1u);
+    EXPECT_EQ(customers.items[0].getName(), "Jane Smith");
+}
+
+TEST_F(QueryTest, OrderPagesStayInIdOrderAfterAbortedDelete)
+{
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_TRUE(orderManager->createOrder(1));
+    }
+    {
+        Transaction transaction;
+        ASSERT_TRUE(orderManager->deleteOrder(2));
+    }
+
+    std::vector<int> ids;
+    int cursor = 0;
+    bool hasMore = true;
+    while (hasMore)
+    {
+        Page<Order> page = orderManager->getOrdersPage(cursor, 2);
+        for (const auto &order : page.items)
+        {
+            ids.push_back(order.getOrderId());
+        }
+        cursor = page.nextCursor;
+        hasMore = page.hasMore;
+    }
+    EXPECT_EQ(ids, (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+TEST_F(QueryTest, PrintAllOrdersPagesThroughEveryOrder)
+{
+    int total = static_cast<int>(Scan::PRINT_PAGE_SIZE) + 5;
+    for (int i = 0; i < total; ++i)
+    {
+        ASSERT_TRUE(orderManager->createOrder(1));
+    }
+
+    testing::internal::CaptureStdout();
+    orderManager->printAllOrders();
+    std::string output = testing::internal::GetCapturedStdout();
+
+    int printed = 0;
+    for (size_t at = output.find("Order #"); at != std::string::npos; at = output.find("Order #", at + 1))
+    {
+        ++printed;
+    }
+    EXPECT_EQ(printed, total);
+    EXPECT_NE(output.find("Order #" + std::to_string(total) + " "), std::string::npos);
+}
@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include "ui/RequestServer.h"
+#include "utils/Database.h"
+#include "utils/Metrics.h"
+#include "TestDataDir.h"
+#include <cstring>
+#include <filesystem>
+#include <set>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+class RequestServerTest : public ManagerTest
+{
+protected:
+    const std::string socketPath = "test_request_server.sock";
+
+    RequestServerTest() : ManagerTest("test_request_server_data") {}
+
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(ManagerTest::SetUp());
+        ASSERT_TRUE(userManager->login("admin", "admin"));
+        ASSERT_TRUE(customerManager->addCustomer(Customer(0, "Server Customer", "server@example.com", "+1-555-0105",
+                                                          "1 Main St", "Cairo", "Egypt")));
+        ASSERT_TRUE(productManager->addProduct(Product(0, "Server Product", "", "Books", 5.0, 100000, 0)));
+
+        server = std::make_unique<RequestServer>(*userManager, *customerManager, *productManager, *orderManager);
+        ASSERT_TRUE(server->start(socketPath, 4));
+    }
+
+    void TearDown() override
+    {
+        server.reset();
+        ManagerTest::TearDown();
+        EXPECT_FALSE(std::filesystem::exists(socketPath));
+    }
+
+    void createManagers() override
+    {
+        userManager = std::make_unique<UserManager>();
+        ManagerTest::createManagers();
+    }
+
+    void resetManagers() override
+    {
+        ManagerTest::resetManagers();
+        userManager.reset();
+    }
+
+    std::unique_ptr<UserManager> userManager;
+    std::unique_ptr<RequestServer> server;
+};
+
+TEST_F(RequestServerTest, PipelinedRequestsAreAnsweredInOrder)
+{
+    RequestClient client;
+    ASSERT_TRUE(client.connect(socketPath));
+    const int count = 100;
+    for (int i = 0; i < count; ++i)
+    {
+        ASSERT_TRUE(client.send("order.create,1"));
+        ASSERT_TRUE(client.send("order.add_item,$order,1,2"));
+    }
+    ASSERT_TRUE(client.send("order.fly,1"));
+
+    bool ok = false;
+    std::string body;
+    for (int i = 1; i <= count; ++i)
+    {
+        ASSERT_TRUE(client.receive(ok, body));
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(body, "order " + std::to_string(i) + "\n");
+        ASSERT_TRUE(client.receive(ok, body));
+        EXPECT_TRUE(ok) << body;
+    }
+    ASSERT_TRUE(client.receive(ok, body));
+    EXPECT_FALSE(ok);
+    EXPECT_EQ(body, "unknown command: order.fly");
+
+    ASSERT_TRUE(client.call("order.get,$order", ok, body));
+    EXPECT_TRUE(ok);
+    Order order = Order::deserialize(body.substr(0, body.size() - 1));
+    EXPECT_EQ(order.getOrderId(), count);
+    EXPECT_EQ(order.getItemCount(), 2);
+    EXPECT_EQ(orderManager->getTotalOrders(), count);
+}
+
+TEST_F(RequestServerTest, ServesConcurrentClients)
+{
+    const int clients = 8;
+    const int ordersEach = 25;
+    std::vector<std::vector<int>> created(clients);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c)
+    {
+        threads.emplace_back([this, c, &created]()
+                             {
+                                 RequestClient client;
+                                 if (!client.connect(socketPath))
+                                 {
+                                     return;
+                                 }
+                                 bool ok = false;
+                                 std::string body;
+                                 for (int i = 0; i < ordersEach; ++i)
+                                 {
+                                     if (client.call("order.create,1", ok, body) && ok)
+                                     {
+                                         created[c].push_back(std::stoi(body.substr(6)));
+                                     }
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    std::set<int> ids;
+    for (const auto &list : created)
+    {
+        EXPECT_EQ(list.size(), static_cast<size_t>(ordersEach));
+        ids.insert(list.begin(), list.end());
+    }
+    EXPECT_EQ(ids.size(), static_cast<size_t>(clients * ordersEach));
+    EXPECT_EQ(orderManager->getTotalOrders(), clients * ordersEach);
+}
+
+TEST_F(RequestServerTest, BatchRequestsCommitOnce)
+{
+    Metrics &metrics = Metrics::getInstance();
+    size_t commits = metrics.latency("database_commit").snapshot().getCount();
+    size_t ordersSaved = metrics.latency("order_save").snapshot().getCount();
+
+    const int items = 50;
+    std::vector<std::string> batch = {"# one order per batch", "order.create,1"};
+    for (int i = 0; i < items; ++i)
+    {
+        batch.push_back("order.add_item,$order,1,1");
+    }
+    batch.push_back("order.create,42");
+
+    RequestClient client;
+    ASSERT_TRUE(client.connect(socketPath));
+    ASSERT_TRUE(client.sendBatch(batch));
+    ASSERT_TRUE(client.sendBatch({"order.create,1", "order.get,$order"}));
+
+    bool ok = true;
+    std::string body;
+    ASSERT_TRUE(client.receive(ok, body));
+    EXPECT_FALSE(ok);
+    std::string expected = "ok order 1\n";
+    for (int i = 0; i < items; ++i)
+    {
+        expected += "ok\n";
+    }
+    expected += "error order.create,42: rejected\n";
+    EXPECT_EQ(body, expected);
+
+    // Pipelined behind the first batch, and answered after it
+    ASSERT_TRUE(client.receive(ok, body));
+    EXPECT_TRUE(ok) << body;
+    EXPECT_EQ(body.rfind("ok order 2\nok 2|1|", 0), 0u) << body;
+
+    // One journal commit and one orders file write per batch
+    EXPECT_EQ(metrics.latency("database_commit").snapshot().getCount(), commits + 2);
+    EXPECT_EQ(metrics.latency("order_save").snapshot().getCount(), ordersSaved + 2);
+
+    Order order;
+    ASSERT_TRUE(orderManager->getOrderCopy(1, order));
+    EXPECT_EQ(order.getItemCount(), items);
+}
+
+TEST_F(RequestServerTest, BatchThatCannotBeSavedReportsItAndKeepsChanges)
+{
+    // Nothing can be written once the data directory is gone
+    std::filesystem::remove_all("test_request_server_data");
+
+    RequestClient client;
+    ASSERT_TRUE(client.connect(socketPath));
+    ASSERT_TRUE(client.sendBatch({"order.create,1", "order.add_item,$order,1,2"}));
+
+    bool ok = false;
+    std::string body;
+    ASSERT_TRUE(client.receive(ok, body));
+    EXPECT_TRUE(ok) << body;
+    EXPECT_EQ(body, "ok order 1\nok\n"
+                    "error not saved: the changes were applied but writing the data files failed\n");
+
+    Order order;
+    ASSERT_TRUE(orderManager->getOrderCopy(1, order));
+    EXPECT_EQ(order.getItemCount(), 2);
+}
+
+TEST_F(RequestServerTest, RejectsOversizedRequestsAndLiveSockets)
+{
+    // Just the header of a frame over the limit
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, socketPath.c_str());
+    ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+    uint32_t length = RequestServer::MAX_FRAME + 1;
+    unsigned char header[4] = {static_cast<unsigned char>(length >> 24), static_cast<unsigned char>(length >> 16),
+                               static_cast<unsigned char>(length >> 8), static_cast<unsigned char>(length)};
+    ASSERT_EQ(::write(fd, header, sizeof(header)), 4);
+
+    std::string reply;
+    char buffer[256];
+    ssize_t count;
+    while ((count = ::read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        reply.append(buffer, static_cast<size_t>(count));
+    }
+    ::close(fd);
+    // Answered with an error, then closed
+    ASSERT_GT(reply.size(), 4u);
+    EXPECT_EQ(reply.substr(4).rfind("error\nrequest larger than", 0), 0u);
+
+    RequestClient client;
+    bool ok = false;
+    std::string body;
+
+    // A second server must not take over the socket of a running one
+    RequestServer other(*userManager, *customerManager, *productManager, *orderManager);
+    EXPECT_FALSE(other.start(socketPath, 1));
+    ASSERT_TRUE(client.connect(socketPath));
+    ASSERT_TRUE(client.call("product.get,1", ok, body));
+    EXPECT_TRUE(ok);
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "managers/CustomerManager.h"
+#include "utils/Database.h"
+#include "utils/Startup.h"
+#include "TestDataDir.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+    const StartupProfiler::Phase *findPhase(const std::vector<StartupProfiler::Phase> &phases, const std::string &name)
+    {
+        for (const auto &phase : phases)
+        {
+            if (phase.name == name)
+            {
+                return &phase;
+            }
+        }
+        return nullptr;
+    }
+}
+
+TEST(StartupTest, RecordsNothingOutsideBeginAndFinish)
+{
+    StartupProfiler &profiler = StartupProfiler::getInstance();
+    profiler.begin();
+    profiler.finish();
+    {
+        StartupPhase phase("test.late");
+    }
+    EXPECT_TRUE(profiler.getPhases().empty());
+}
+
+TEST(StartupTest, NestedPhasesFollowTheirParent)
+{
+    StartupProfiler &profiler = StartupProfiler::getInstance();
+    profiler.begin();
+    {
+        StartupPhase outer("test.outer");
+        {
+            StartupPhase inner("test.inner");
+            inner.setBytes(2 * 1024 * 1024);
+            inner.setRecords(500);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    {
+        StartupPhase next("test.next");
+    }
+    profiler.finish();
+
+    auto phases = profiler.getPhases();
+    ASSERT_EQ(phases.size(), 3u);
+    EXPECT_EQ(phases[0].name, "test.outer");
+    EXPECT_EQ(phases[0].depth, 0);
+    EXPECT_EQ(phases[1].name, "test.inner");
+    EXPECT_EQ(phases[1].depth, 1);
+    EXPECT_EQ(phases[2].name, "test.next");
+    EXPECT_EQ(phases[2].depth, 0);
+
+    EXPECT_GE(phases[1].seconds, 0.002);
+    EXPECT_GE(phases[0].seconds, phases[1].seconds);
+    EXPECT_EQ(phases[1].bytes, 2u * 1024 * 1024);
+    EXPECT_EQ(phases[1].records, 500u);
+    EXPECT_GE(profiler.getTotalSeconds(), phases[0].seconds);
+
+    std::string report = profiler.report();
+    EXPECT_EQ(report.rfind("Startup phase", 0), 0u);
+    EXPECT_NE(report.find("\n  test.inner "), std::string::npos);
+    EXPECT_NE(report.find("2.00 MB"), std::string::npos);
+    EXPECT_NE(report.find("records/s"), std::string::npos);
+    EXPECT_NE(report.find("\nTotal "), std::string::npos);
+}
+
+TEST(StartupTest, ManagerLoadsRecordFileBytesAndRecords)
+{
+    TestDataDir dataDir("test_startup_data");
+    ASSERT_TRUE(dataDir.isReady());
+    {
+        std::ofstream file("test_startup_data/customers.txt");
+        file << Customer(1, "First Customer", "first@example.com", "+1-555-0103", "1 Main St", "Cairo", "Egypt")
+                    .serialize()
+             << "\n"
+             << Customer(2, "Second Customer", "second@example.com", "+1-555-0104", "2 Main St", "Giza", "Egypt")
+                    .serialize()
+             << "\n";
+    }
+    uintmax_t fileSize = std::filesystem::file_size("test_startup_data/customers.txt");
+
+    StartupProfiler &profiler = StartupProfiler::getInstance();
+    profiler.begin();
+    {
+        CustomerManager customers;
+        profiler.finish();
+        EXPECT_EQ(customers.getTotalCustomers(), 2);
+    }
+
+    auto phases = profiler.getPhases();
+    const StartupProfiler::Phase *load = findPhase(phases, "customers.load");
+    const StartupProfiler::Phase *read = findPhase(phases, "database.read");
+    const StartupProfiler::Phase *parse = findPhase(phases, "customers.parse");
+    ASSERT_NE(load, nullptr);
+    ASSERT_NE(read, nullptr);
+    ASSERT_NE(parse, nullptr);
+    ASSERT_NE(findPhase(phases, "customers.index"), nullptr);
+    EXPECT_EQ(read->depth, load->depth + 1);
+    EXPECT_EQ(read->bytes, fileSize);
+    EXPECT_EQ(read->records, 2u);
+    EXPECT_EQ(parse->records, 2u);
+}
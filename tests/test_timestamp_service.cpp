@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "utils/TimestampService.h"
+#include "utils/Utils.h"
+#include "models/Order.h"
+#include <regex>
+#include <thread>
+#include <vector>
+
+TEST(TimestampServiceTest, GetInstanceSingleton)
+{
+    EXPECT_EQ(&TimestampService::getInstance(), &TimestampService::getInstance());
+}
+
+TEST(TimestampServiceTest, NowHasDateTimeFormat)
+{
+    std::string now = TimestampService::getInstance().now();
+    EXPECT_TRUE(std::regex_match(now, std::regex(R"(\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2})")));
+}
+
+TEST(TimestampServiceTest, MatchesFormattedEpoch)
+{
+    TimestampService &service = TimestampService::getInstance();
+    std::time_t before = service.epochSeconds();
+    std::string now = service.now();
+    std::time_t after = service.epochSeconds();
+
+    EXPECT_TRUE(now == TimestampService::formatDateTime(before) ||
+                now == TimestampService::formatDateTime(after));
+}
+
+TEST(TimestampServiceTest, UtilsDateAndTimeAreConsistent)
+{
+    std::string date = Utils::getCurrentDate();
+    std::string time = Utils::getCurrentTime();
+
+    EXPECT_TRUE(Utils::isValidDate(date));
+    EXPECT_EQ(time.size(), 8u);
+}
+
+TEST(TimestampServiceTest, ConcurrentCallersGetWellFormedValues)
+{
+    std::vector<std::thread> threads;
+    std::vector<int> malformed(8, 0);
+
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([t, &malformed]
+                             {
+                                 for (int i = 0; i < 2000; ++i)
+                                 {
+                                     if (TimestampService::getInstance().now().size() != 19)
+                                     {
+                                         ++malformed[t];
+                                     }
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int count : malformed)
+    {
+        EXPECT_EQ(count, 0);
+    }
+}
+
+TEST(TimestampServiceTest, DeserializedOrderKeepsStoredDate)
+{
+    Order order(1, 100, "John Doe");
+    order.addItem(OrderItem(1, "Laptop", 1, 999.99));
+    std::string data = order.serialize();
+
+    std::string stored = "2020-01-02 03:04:05";
+    size_t dateStart = data.find(order.getOrderDate());
+    ASSERT_NE(dateStart, std::string::npos);
+    data.replace(dateStart, order.getOrderDate().size(), stored);
+
+    EXPECT_EQ(Order::deserialize(data).getOrderDate(), stored);
+}
+
+TEST(TimestampServiceTest, ShortOrderRecordGetsCurrentDate)
+{
+    Order order = Order::deserialize("7|100|John Doe");
+    EXPECT_TRUE(std::regex_match(order.getOrderDate(), std::regex(R"(\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2})")));
+}
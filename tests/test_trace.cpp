@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "managers/CustomerManager.h"
+#include "utils/Database.h"
+#include "utils/Trace.h"
+#include "TestDataDir.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    size_t countSpans(const std::vector<std::pair<int, Tracer::Span>> &spans, const char *name)
+    {
+        size_t count = 0;
+        for (const auto &entry : spans)
+        {
+            count += std::strcmp(entry.second.name, name) == 0;
+        }
+        return count;
+    }
+}
+
+TEST(TraceTest, RecordsNothingWhileDisabled)
+{
+    Tracer &tracer = Tracer::getInstance();
+    tracer.start();
+    tracer.stop();
+    {
+        TRACE_SPAN("test.disabled");
+    }
+    EXPECT_EQ(countSpans(tracer.spans(), "test.disabled"), 0u);
+}
+
+TEST(TraceTest, NestedSpansAreContained)
+{
+    Tracer &tracer = Tracer::getInstance();
+    tracer.start();
+    {
+        TRACE_SPAN("test.outer");
+        {
+            TRACE_SPAN("test.inner");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    tracer.stop();
+
+    auto spans = tracer.spans();
+    ASSERT_EQ(spans.size(), 2u);
+    // Spans are recorded when they end, so the inner one comes first
+    const Tracer::Span &inner = spans[0].second;
+    const Tracer::Span &outer = spans[1].second;
+    EXPECT_STREQ(inner.name, "test.inner");
+    EXPECT_STREQ(outer.name, "test.outer");
+    EXPECT_GE(inner.duration, 1000000);
+    EXPECT_LE(outer.start, inner.start);
+    EXPECT_GE(outer.start + outer.duration, inner.start + inner.duration);
+    EXPECT_EQ(spans[0].first, spans[1].first);
+}
+
+TEST(TraceTest, EachThreadHasItsOwnBuffer)
+{
+    Tracer &tracer = Tracer::getInstance();
+    tracer.start();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([]()
+                             {
+                                 for (int i = 0; i < 1000; ++i)
+                                 {
+                                     TRACE_SPAN("test.worker");
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    tracer.stop();
+
+    auto spans = tracer.spans();
+    EXPECT_EQ(countSpans(spans, "test.worker"), 4000u);
+    std::set<int> threadIds;
+    for (const auto &entry : spans)
+    {
+        threadIds.insert(entry.first);
+    }
+    EXPECT_EQ(threadIds.size(), 4u);
+    EXPECT_EQ(tracer.droppedSpans(), 0u);
+}
+
+TEST(TraceTest, SavesAndLoadsAreTracedAndExported)
+{
+    TestDataDir dataDir("test_trace_data");
+    ASSERT_TRUE(dataDir.isReady());
+
+    Tracer &tracer = Tracer::getInstance();
+    tracer.start();
+    {
+        ProductManager products;
+        CustomerManager customers;
+        OrderManager orders(&products, &customers);
+        ASSERT_TRUE(customers.addCustomer(Customer(0, "Trace Customer", "trace@example.com", "+1-555-0101",
+                                                   "1 Main St", "Cairo", "Egypt")));
+        ASSERT_TRUE(orders.createOrder(1));
+    }
+    tracer.stop();
+
+    auto spans = tracer.spans();
+    for (const char *name : {"orders.load", "orders.parse", "orders.index", "orders.save", "orders.serialize",
+                             "customers.save", "database.read", "database.write", "database.write_lines",
+                             "database.close"})
+    {
+        EXPECT_GE(countSpans(spans, name), 1u) << name;
+    }
+
+    const std::string filename = "test_trace.json";
+    ASSERT_TRUE(tracer.writeChromeTrace(filename));
+    std::ifstream in(filename);
+    std::stringstream text;
+    text << in.rdbuf();
+    std::string json = text.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedSpans\":0},\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("{\"name\":\"orders.save\",\"cat\":\"ordermgmt\",\"ph\":\"X\",\"pid\":1,\"tid\":"),
+              std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+
+    std::filesystem::remove(filename);
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "managers/CustomerManager.h"
+#include "utils/Database.h"
+#include "utils/EventLog.h"
+#include "utils/Metrics.h"
+#include "utils/Transaction.h"
+#include "TestDataDir.h"
+#include <filesystem>
+
+class TransactionTest : public ManagerTest
+{
+protected:
+    TransactionTest() : ManagerTest("test_transaction_data") {}
+
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(ManagerTest::SetUp());
+
+        ASSERT_TRUE(customerManager->addCustomer(Customer(0, "John Doe", "john@email.com", "+1234567890",
+                                                          "123 Main St", "New York", "USA")));
+        ASSERT_TRUE(productManager->addProduct(Product(0, "Laptop", "High-performance laptop",
+                                                       "Electronics", 999.99, 10, 2)));
+    }
+
+    Product laptop()
+    {
+        Product copy;
+        productManager->getProductCopy(1, copy);
+        return copy;
+    }
+};
+
+TEST_F(TransactionTest, CommitWritesOrdersAndStockTogether)
+{
+    Transaction transaction;
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 4));
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+
+    // Nothing is written until commit
+    EXPECT_TRUE(Database::getInstance().loadOrders().empty());
+    ASSERT_TRUE(transaction.commit());
+    EXPECT_FALSE(Transaction::active());
+    EXPECT_FALSE(std::filesystem::exists("test_transaction_data/journal.txt"));
+
+    reloadManagers();
+    Order order;
+    ASSERT_TRUE(orderManager->getOrderCopy(1, order));
+    EXPECT_EQ(order.getStatus(), OrderStatus::CONFIRMED);
+    EXPECT_EQ(laptop().getReservedQuantity(), 4);
+}
+
+TEST_F(TransactionTest, AbortRollsBackOrdersAndStock)
+{
+    Transaction transaction;
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 4));
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    ASSERT_TRUE(productManager->reduceStock(1, 3));
+    transaction.abort();
+
+    EXPECT_EQ(orderManager->getTotalOrders(), 0);
+    EXPECT_EQ(laptop().getStockQuantity(), 10);
+    EXPECT_EQ(laptop().getReservedQuantity(), 0);
+
+    reloadManagers();
+    EXPECT_EQ(orderManager->getTotalOrders(), 0);
+    EXPECT_EQ(laptop().getStockQuantity(), 10);
+    EXPECT_EQ(laptop().getReservedQuantity(), 0);
+}
+
+TEST_F(TransactionTest, UncommittedTransactionAbortsWhenDestroyed)
+{
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 4));
+    {
+        Transaction transaction;
+        ASSERT_TRUE(orderManager->confirmOrder(1));
+        EXPECT_EQ(laptop().getReservedQuantity(), 4);
+    }
+
+    Order order;
+    ASSERT_TRUE(orderManager->getOrderCopy(1, order));
+    EXPECT_EQ(order.getStatus(), OrderStatus::PENDING);
+    EXPECT_EQ(laptop().getReservedQuantity(), 0);
+}
+
+TEST_F(TransactionTest, NestedAbortOnlyUndoesInnerChanges)
+{
+    Transaction outer;
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 2));
+    {
+        Transaction inner;
+        ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 3));
+        ASSERT_TRUE(orderManager->confirmOrder(1));
+        inner.abort();
+    }
+    EXPECT_TRUE(Transaction::active());
+    ASSERT_TRUE(outer.commit());
+
+    reloadManagers();
+    Order order;
+    ASSERT_TRUE(orderManager->getOrderCopy(1, order));
+    EXPECT_EQ(order.getStatus(), OrderStatus::PENDING);
+    ASSERT_EQ(order.getItems().size(), 1u);
+    EXPECT_EQ(order.getItems()[0].quantity, 2);
+    EXPECT_EQ(laptop().getReservedQuantity(), 0);
+}
+
+TEST_F(TransactionTest, FailedStepDoesNotUndoEarlierSteps)
+{
+    Transaction transaction;
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 4));
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    ASSERT_TRUE(orderManager->createOrder(1));
+    EXPECT_FALSE(orderManager->addItemToOrder(2, 1, 8)); // only 6 left after the reservation
+    ASSERT_TRUE(transaction.commit());
+
+    reloadManagers();
+    EXPECT_EQ(orderManager->getTotalOrders(), 2);
+    EXPECT_EQ(laptop().getReservedQuantity(), 4);
+}
+
+TEST_F(TransactionTest, AuditRecordsWaitForCommit)
+{
+    std::string logPath = "test_transaction_data/events.bin";
+    ASSERT_TRUE(EventLog::getInstance().initialize(logPath));
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 4));
+
+    EventFilter statusChanges;
+    statusChanges.hasType = true;
+    statusChanges.type = EventType::ORDER_STATUS_CHANGED;
+    EventFilter stockUpdates;
+    stockUpdates.hasType = true;
+    stockUpdates.type = EventType::STOCK_UPDATED;
+    auto count = [&logPath](const EventFilter &filter)
+    {
+        EventLog::getInstance().flush();
+        return EventLogReader(logPath).readAll(filter).size();
+    };
+
+    {
+        Transaction transaction;
+        ASSERT_TRUE(orderManager->confirmOrder(1));
+        ASSERT_TRUE(productManager->reduceStock(1, 1));
+        EXPECT_EQ(count(statusChanges), 0u);
+    }
+    EXPECT_EQ(count(statusChanges), 0u);
+    EXPECT_EQ(count(stockUpdates), 0u);
+
+    Transaction transaction;
+    ASSERT_TRUE(orderManager->confirmOrder(1));
+    {
+        Transaction inner;
+        ASSERT_TRUE(productManager->reduceStock(1, 1));
+        inner.abort();
+    }
+    ASSERT_TRUE(productManager->addStock(1, 5));
+    EXPECT_EQ(count(statusChanges), 0u);
+    ASSERT_TRUE(transaction.commit());
+    EXPECT_EQ(count(statusChanges), 1u);
+    EXPECT_EQ(count(stockUpdates), 1u);
+
+    // Outside a transaction the record goes out with the change
+    ASSERT_TRUE(orderManager->processOrder(1));
+    EXPECT_EQ(count(statusChanges), 2u);
+    EventLog::getInstance().close();
+}
+
+TEST_F(TransactionTest, FailedCommitKeepsChangesInMemory)
+{
+    ASSERT_TRUE(orderManager->createOrder(1));
+    ASSERT_TRUE(orderManager->addItemToOrder(1, 1, 4));
+
+    // Nothing can be written once the data directory is gone
+    std::filesystem::remove_all("test_transaction_data");
+    EXPECT_TRUE(orderManager->confirmOrder(1));
+
+    Order order;
+    ASSERT_TRUE(orderManager->getOrderCopy(1, order));
+    EXPECT_EQ(order.getStatus(), OrderStatus::CONFIRMED);
+    EXPECT_EQ(laptop().getReservedQuantity(), 4);
+
+    Transaction transaction;
+    ASSERT_TRUE(orderManager->processOrder(1));
+    EXPECT_FALSE(transaction.commit());
+    ASSERT_TRUE(orderManager->getOrderCopy(1, order));
+    EXPECT_EQ(order.getStatus(), OrderStatus::PROCESSING);
+}
+
+TEST_F(TransactionTest, DeferredSavesSerializeEachFileOnceAtCommit)
+{
+    size_t ordersSaved = Metrics::getInstance().latency("order_save").snapshot().getCount();
+    size_t productsSaved = Metrics::getInstance().latency("product_save").snapshot().getCount();
+    {
+        Transaction transaction;
+        transaction.deferSaves();
+        for (int i = 1; i <= 5; ++i)
+        {
+            ASSERT_TRUE(orderManager->createOrder(1));
+            ASSERT_TRUE(orderManager->addItemToOrder(i, 1, 1));
+            ASSERT_TRUE(orderManager->confirmOrder(i));
+        }
+        EXPECT_EQ(Metrics::getInstance().latency("order_save").snapshot().getCount(), ordersSaved);
+        ASSERT_TRUE(transaction.commit());
+    }
+    EXPECT_EQ(Metrics::getInstance().latency("order_save").snapshot().getCount(), ordersSaved + 1);
+    EXPECT_EQ(Metrics::getInstance().latency("product_save").snapshot().getCount(), productsSaved + 1);
+
+    // Saves go straight through again once the transaction is over
+    ASSERT_TRUE(orderManager->createOrder(1));
+    EXPECT_EQ(Metrics::getInstance().latency("order_save").snapshot().getCount(), ordersSaved + 2);
+
+    reloadManagers();
+    EXPECT_EQ(orderManager->getTotalOrders(), 6);
+    EXPECT_EQ(laptop().getReservedQuantity(), 5);
+}
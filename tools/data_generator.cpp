@@ -0,0 +1,587 @@
+// Writes a synthetic data directory at production scale, so scaling problems can be
+// reproduced locally. The same seed always produces the same files.
+//
+// Usage: OrderManagementDataGen [--out DIR] [--customers N] [--products N] [--orders N]
+//                               [--users N] [--max-items N] [--skew S] [--days N] [--seed N]
+//                               [--threads N] [--force]
+#include "models/Customer.h"
+#include "models/Order.h"
+#include "models/Product.h"
+#include "models/User.h"
+#include "utils/Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct Settings
+    {
+        std::string outDir = "generated_data/";
+        long long customers = 10000;
+        long long products = 1000;
+        long long orders = 100000;
+        long long users = 10;
+        int maxItems = 5;
+        double skew = 1.0; // Zipf exponent; 0 picks customers and products uniformly
+        int days = 365;    // orders are spread over this many days before END_DATE
+        std::uint64_t seed = 42;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency()); // order blocks made at once
+        bool force = false;
+    };
+
+    // Fixed rather than today, so a seed always gives the same dates
+    const std::time_t END_DATE = 1767225600; // 2026-01-01 00:00:00 UTC
+
+    const char *const FIRST_NAMES[] = {"James", "Mary", "Ahmed", "Fatima", "Wei", "Yuki", "Carlos", "Sofia",
+                                       "Ivan", "Olga", "Liam", "Emma", "Noah", "Amara", "Ravi", "Priya"};
+    const char *const LAST_NAMES[] = {"Smith", "Garcia", "Hassan", "Chen", "Tanaka", "Silva", "Ivanov",
+                                      "Muller", "Okafor", "Patel", "Brown", "Rossi", "Kim", "Nguyen"};
+    const char *const STREETS[] = {"Main", "Oak", "Pine", "Maple", "Cedar", "Elm", "Lake", "Hill", "Park"};
+    const char *const CITIES[][2] = {{"New York", "USA"},  {"Chicago", "USA"},    {"London", "UK"},
+                                     {"Cairo", "Egypt"},   {"Berlin", "Germany"}, {"Tokyo", "Japan"},
+                                     {"Sao Paulo", "Brazil"}, {"Mumbai", "India"}, {"Toronto", "Canada"}};
+    const char *const CATEGORIES[] = {"Electronics", "Books", "Clothing", "Home", "Garden",
+                                      "Toys", "Sports", "Grocery", "Beauty", "Office"};
+    const char *const ADJECTIVES[] = {"Compact", "Deluxe", "Classic", "Wireless", "Portable",
+                                      "Smart", "Eco", "Pro", "Mini", "Ultra"};
+    const char *const NOUNS[] = {"Lamp", "Backpack", "Speaker", "Kettle", "Notebook", "Jacket",
+                                 "Drill", "Puzzle", "Bottle", "Chair", "Monitor", "Blender"};
+
+    template <typename T, size_t N>
+    constexpr size_t countOf(const T (&)[N]) { return N; }
+
+    // mt19937_64 is specified exactly by the standard; the distributions are not,
+    // so the draws are made here to keep files identical across compilers
+    class Random
+    {
+    private:
+        std::mt19937_64 engine;
+
+    public:
+        explicit Random(std::uint64_t seed) : engine(seed) {}
+
+        double uniform() { return static_cast<double>(engine() >> 11) * 0x1.0p-53; } // [0, 1)
+        size_t below(size_t n) { return static_cast<size_t>(engine() % n); }
+        bool chance(double p) { return uniform() < p; }
+        template <typename T, size_t N>
+        const T &pick(const T (&values)[N]) { return values[below(N)]; }
+    };
+
+    // Draws ids 1..n with P(rank k) proportional to 1 / k^skew. Ranks map to ids
+    // through a shuffle, so the popular records are spread over the id range.
+    class ZipfSampler
+    {
+    private:
+        std::vector<double> cdf;
+        std::vector<int> ids;
+
+    public:
+        ZipfSampler(size_t n, double skew, Random &random) : cdf(n), ids(n)
+        {
+            double total = 0.0;
+            for (size_t k = 0; k < n; ++k)
+            {
+                total += 1.0 / std::pow(static_cast<double>(k + 1), skew);
+                cdf[k] = total;
+                ids[k] = static_cast<int>(k + 1);
+            }
+            for (double &c : cdf)
+            {
+                c /= total;
+            }
+            for (size_t i = n; i > 1; --i)
+            {
+                std::swap(ids[i - 1], ids[random.below(i)]);
+            }
+        }
+
+        int sample(Random &random) const
+        {
+            size_t rank = static_cast<size_t>(std::upper_bound(cdf.begin(), cdf.end(), random.uniform()) - cdf.begin());
+            return ids[std::min(rank, ids.size() - 1)];
+        }
+    };
+
+    std::string formatDate(std::time_t time)
+    {
+        std::tm tm{};
+#ifdef _WIN32
+        gmtime_s(&tm, &time);
+#else
+        gmtime_r(&time, &tm);
+#endif
+        char text[20];
+        std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm);
+        return text;
+    }
+
+    // Large writes for files of millions of lines
+    class LineWriter
+    {
+    private:
+        std::vector<char> buffer;
+        std::ofstream out;
+        size_t lines;
+
+    public:
+        explicit LineWriter(const std::string &path) : buffer(1 << 20), lines(0)
+        {
+            out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            out.open(path, std::ios::binary | std::ios::trunc);
+        }
+
+        bool isOpen() const { return out.is_open(); }
+        void write(const std::string &line)
+        {
+            out << line << '\n';
+            ++lines;
+        }
+        // Several lines at once, already ending in line breaks
+        void writeBlock(const std::string &text, size_t lineCount)
+        {
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            lines += lineCount;
+        }
+        size_t getLines() const { return lines; }
+        bool close()
+        {
+            out.close();
+            return static_cast<bool>(out);
+        }
+    };
+
+    class Generator
+    {
+    private:
+        const Settings &settings;
+        Random random;
+        std::chrono::steady_clock::time_point started;
+
+        // What orders need to know about customers and products
+        std::vector<std::string> customerNames;
+        std::vector<std::string> customerAddresses;
+        std::vector<Product> catalogue;
+        std::vector<int> reserved; // per product, by confirmed and processing orders
+
+        double elapsed() const
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        }
+
+        bool finish(LineWriter &writer, const std::string &name)
+        {
+            if (!writer.close())
+            {
+                std::cerr << "Cannot write " << settings.outDir + name << std::endl;
+                return false;
+            }
+            std::printf("%-14s %10zu records  (%.1f s)\n", name.c_str(), writer.getLines(), elapsed());
+            return true;
+        }
+
+        bool open(LineWriter &writer, const std::string &name)
+        {
+            if (!writer.isOpen())
+            {
+                std::cerr << "Cannot create " << settings.outDir + name << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        static OrderStatus statusFor(Random &random, double ageDays)
+        {
+            double roll = random.uniform();
+            if (roll < 0.07)
+            {
+                return OrderStatus::CANCELLED;
+            }
+            if (ageDays > 14)
+            {
+                return roll < 0.97 ? OrderStatus::DELIVERED : OrderStatus::SHIPPED;
+            }
+            if (ageDays > 3)
+            {
+                return roll < 0.6 ? OrderStatus::DELIVERED : roll < 0.85 ? OrderStatus::SHIPPED
+                                                                          : OrderStatus::PROCESSING;
+            }
+            return roll < 0.3 ? OrderStatus::PENDING : roll < 0.6 ? OrderStatus::CONFIRMED
+                                                     : roll < 0.85 ? OrderStatus::PROCESSING
+                                                                   : OrderStatus::SHIPPED;
+        }
+
+    public:
+        explicit Generator(const Settings &settings)
+            : settings(settings), random(settings.seed), started(std::chrono::steady_clock::now())
+        {
+        }
+
+        bool writeUsers()
+        {
+            LineWriter writer(settings.outDir + "users.txt");
+            if (!open(writer, "users.txt"))
+            {
+                return false;
+            }
+
+            // The same admin/admin account UserManager creates for an empty file
+            User admin(1, "admin", Utils::hashPassword("admin"), "System Administrator", "admin@orderms.com",
+                       UserRole::ADMIN);
+            // User::deserialize needs every field, so users are written as having logged in
+            std::string lastLogin = formatDate(END_DATE);
+            admin.setIsActive(true);
+            admin.setLastLoginDate(lastLogin);
+            writer.write(admin.serialize());
+
+            const UserRole roles[] = {UserRole::MANAGER, UserRole::EMPLOYEE, UserRole::EMPLOYEE, UserRole::GUEST};
+            std::string password = Utils::hashPassword("password");
+            for (long long i = 2; i <= settings.users + 1; ++i)
+            {
+                std::string id = std::to_string(i);
+                User user(static_cast<int>(i), "user" + id, password,
+                          std::string(random.pick(FIRST_NAMES)) + " " + random.pick(LAST_NAMES),
+                          "user" + id + "@orderms.com", roles[i % countOf(roles)]);
+                user.setIsActive(true);
+                user.setLastLoginDate(lastLogin);
+                writer.write(user.serialize());
+            }
+            return finish(writer, "users.txt");
+        }
+
+        bool writeCustomers()
+        {
+            LineWriter writer(settings.outDir + "customers.txt");
+            if (!open(writer, "customers.txt"))
+            {
+                return false;
+            }
+
+            customerNames.reserve(static_cast<size_t>(settings.customers));
+            customerAddresses.reserve(static_cast<size_t>(settings.customers));
+            for (long long i = 1; i <= settings.customers; ++i)
+            {
+                std::string first = random.pick(FIRST_NAMES);
+                std::string last = random.pick(LAST_NAMES);
+                std::string id = std::to_string(i);
+                const auto &place = random.pick(CITIES);
+                std::string address = std::to_string(1 + random.below(9999)) + " " + random.pick(STREETS) + " St";
+
+                // Emails and phones carry the id, so they stay unique at any scale
+                char phone[32];
+                std::snprintf(phone, sizeof(phone), "+1-555-%08lld", i);
+                Customer customer(static_cast<int>(i), first + " " + last,
+                                  Utils::toLower(first + "." + last) + "." + id + "@example.com", phone, address,
+                                  place[0], place[1]);
+                customer.setIsActive(!random.chance(0.03));
+                writer.write(customer.serialize());
+
+                customerNames.push_back(customer.getName());
+                customerAddresses.push_back(address + " " + place[0]);
+            }
+            return finish(writer, "customers.txt");
+        }
+
+        // Products are drawn up front but written after the orders, once their
+        // reserved quantities are known
+        void drawProducts()
+        {
+            catalogue.reserve(static_cast<size_t>(settings.products));
+            for (long long i = 1; i <= settings.products; ++i)
+            {
+                std::string name = std::string(random.pick(ADJECTIVES)) + " " + random.pick(NOUNS) + " " +
+                                   std::to_string(i);
+                double price = static_cast<double>(100 + random.below(99900)) / 100.0;
+                Product product(static_cast<int>(i), name, "Synthetic " + Utils::toLower(name),
+                                random.pick(CATEGORIES), price, static_cast<int>(random.below(500)),
+                                static_cast<int>(5 + random.below(16)));
+                product.setIsActive(!random.chance(0.02));
+                catalogue.push_back(product);
+            }
+            reserved.assign(catalogue.size(), 0);
+        }
+
+        // Orders are made in fixed-size blocks, each with its own random stream seeded
+        // from the block number, so the file is the same for any --threads
+        static const long long ORDER_BLOCK = 65536;
+
+        struct OrderBlock
+        {
+            std::string text;
+            std::vector<std::pair<int, int>> reservations; // product id, quantity
+            size_t count = 0;
+        };
+
+        OrderBlock makeOrders(long long first, long long last, const ZipfSampler &customerPicker,
+                              const ZipfSampler &productPicker) const
+        {
+            Random random(settings.seed ^ (0x9E3779B97F4A7C15ull * static_cast<std::uint64_t>(first)));
+            double span = settings.days * 86400.0;
+            std::vector<int> chosen;
+            OrderBlock block;
+
+            for (long long i = first; i <= last; ++i)
+            {
+                int customerId = customerPicker.sample(random);
+                Order order(static_cast<int>(i), customerId, customerNames[customerId - 1]);
+                order.setShippingAddress(customerAddresses[customerId - 1]);
+
+                // Ids rise with time, as they do when orders are placed
+                double ageSeconds = span * (1.0 - static_cast<double>(i) / settings.orders) +
+                                    random.uniform() * 3600.0;
+                order.setOrderDate(formatDate(END_DATE - static_cast<std::time_t>(ageSeconds)));
+
+                int itemCount = 1 + static_cast<int>(random.below(static_cast<size_t>(settings.maxItems)));
+                chosen.clear();
+                for (int attempt = 0; attempt < itemCount * 3 && static_cast<int>(chosen.size()) < itemCount;
+                     ++attempt)
+                {
+                    int productId = productPicker.sample(random);
+                    if (std::find(chosen.begin(), chosen.end(), productId) != chosen.end())
+                    {
+                        continue;
+                    }
+                    chosen.push_back(productId);
+                    const Product &product = catalogue[productId - 1];
+                    order.addItem(OrderItem(productId, product.getName(), 1 + static_cast<int>(random.below(3)),
+                                            product.getPrice()));
+                }
+
+                if (random.chance(0.1))
+                {
+                    order.applyDiscount(random.chance(0.5) ? 5.0 : 10.0);
+                }
+                if (random.chance(0.05))
+                {
+                    order.setNotes("Leave at the front desk");
+                }
+
+                OrderStatus status = statusFor(random, ageSeconds / 86400.0);
+                order.setStatus(status);
+                if (status == OrderStatus::CONFIRMED || status == OrderStatus::PROCESSING)
+                {
+                    for (const auto &item : order.getItems())
+                    {
+                        block.reservations.emplace_back(item.productId, item.quantity);
+                    }
+                }
+                block.text += order.serialize();
+                block.text += '\n';
+                ++block.count;
+            }
+            return block;
+        }
+
+        bool writeOrders()
+        {
+            LineWriter writer(settings.outDir + "orders.txt");
+            if (!open(writer, "orders.txt"))
+            {
+                return false;
+            }
+            if (settings.orders == 0 || catalogue.empty() || customerNames.empty())
+            {
+                return finish(writer, "orders.txt");
+            }
+
+            ZipfSampler customerPicker(customerNames.size(), settings.skew, random);
+            ZipfSampler productPicker(catalogue.size(), settings.skew, random);
+
+            std::deque<std::future<OrderBlock>> inFlight;
+            auto writeOldest = [&]()
+            {
+                OrderBlock block = inFlight.front().get();
+                inFlight.pop_front();
+                writer.writeBlock(block.text, block.count);
+                for (const auto &reservation : block.reservations)
+                {
+                    reserved[reservation.first - 1] += reservation.second;
+                }
+            };
+
+            for (long long first = 1; first <= settings.orders; first += ORDER_BLOCK)
+            {
+                if (inFlight.size() >= settings.threads)
+                {
+                    writeOldest();
+                }
+                long long last = std::min(settings.orders, first + ORDER_BLOCK - 1);
+                inFlight.push_back(std::async(std::launch::async,
+                                              [&, first, last]()
+                                              { return makeOrders(first, last, customerPicker, productPicker); }));
+            }
+            while (!inFlight.empty())
+            {
+                writeOldest();
+            }
+            return finish(writer, "orders.txt");
+        }
+
+        bool writeProducts()
+        {
+            LineWriter writer(settings.outDir + "products.txt");
+            if (!open(writer, "products.txt"))
+            {
+                return false;
+            }
+
+            for (size_t i = 0; i < catalogue.size(); ++i)
+            {
+                // Reserved stock is part of on-hand stock, so keep enough on hand for it
+                Product &product = catalogue[i];
+                product.setStockQuantity(product.getStockQuantity() + reserved[i]);
+                product.setReservedQuantity(reserved[i]);
+                writer.write(product.serialize());
+            }
+            return finish(writer, "products.txt");
+        }
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: OrderManagementDataGen [options]\n"
+                  << "  --out DIR          Directory to write (default generated_data/)\n"
+                  << "  --customers N      Number of customers (default 10000)\n"
+                  << "  --products N       Number of products (default 1000)\n"
+                  << "  --orders N         Number of orders (default 100000)\n"
+                  << "  --users N          Users besides admin; their password is \"password\" (default 10)\n"
+                  << "  --max-items N      Most items in one order (default 5)\n"
+                  << "  --skew S           Zipf exponent for picking customers and products; 0 is uniform\n"
+                  << "                     (default 1.0)\n"
+                  << "  --days N           Days of order history before 2026-01-01 (default 365)\n"
+                  << "  --seed N           Random seed (default 42)\n"
+                  << "  --threads N        Order blocks generated at once (default: one per core);\n"
+                  << "                     the output does not depend on it\n"
+                  << "  --force            Overwrite data files already in DIR\n";
+    }
+
+    bool parseCount(const char *text, long long max, long long &value)
+    {
+        char *end = nullptr;
+        long long parsed = std::strtoll(text, &end, 10);
+        if (*text == '\0' || *end != '\0' || parsed < 0 || parsed > max)
+        {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Settings settings;
+    const long long MAX_ID = 2000000000; // ids are ints
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        long long number = 0;
+
+        if (arg == "--out" && hasValue)
+        {
+            settings.outDir = argv[++i];
+            if (settings.outDir.back() != '/' && settings.outDir.back() != '\\')
+            {
+                settings.outDir += '/';
+            }
+        }
+        else if (arg == "--customers" && hasValue)
+        {
+            valid = parseCount(argv[++i], MAX_ID, settings.customers);
+        }
+        else if (arg == "--products" && hasValue)
+        {
+            valid = parseCount(argv[++i], MAX_ID, settings.products);
+        }
+        else if (arg == "--orders" && hasValue)
+        {
+            valid = parseCount(argv[++i], MAX_ID, settings.orders);
+        }
+        else if (arg == "--users" && hasValue)
+        {
+            valid = parseCount(argv[++i], MAX_ID - 1, settings.users);
+        }
+        else if (arg == "--max-items" && hasValue)
+        {
+            valid = parseCount(argv[++i], 1000, number) && number > 0;
+            settings.maxItems = static_cast<int>(number);
+        }
+        else if (arg == "--days" && hasValue)
+        {
+            valid = parseCount(argv[++i], 36500, number) && number > 0;
+            settings.days = static_cast<int>(number);
+        }
+        else if (arg == "--skew" && hasValue)
+        {
+            char *end = nullptr;
+            settings.skew = std::strtod(argv[++i], &end);
+            valid = *end == '\0' && settings.skew >= 0.0;
+        }
+        else if (arg == "--seed" && hasValue)
+        {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            valid = parseCount(argv[++i], 1024, number) && number > 0;
+            settings.threads = static_cast<unsigned>(number);
+        }
+        else if (arg == "--force")
+        {
+            settings.force = true;
+        }
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+
+        if (!valid)
+        {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(settings.outDir, error);
+    if (error)
+    {
+        std::cerr << "Cannot create " << settings.outDir << ": " << error.message() << std::endl;
+        return 1;
+    }
+    if (!settings.force)
+    {
+        for (const char *name : {"users.txt", "customers.txt", "products.txt", "orders.txt"})
+        {
+            if (std::filesystem::exists(settings.outDir + name))
+            {
+                std::cerr << settings.outDir << name << " already exists; pass --force to overwrite it" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    Generator generator(settings);
+    generator.drawProducts();
+    bool ok = generator.writeUsers() && generator.writeCustomers() && generator.writeOrders() &&
+              generator.writeProducts();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+// Filters and replays the binary audit log written by EventLog.
+//
+// Usage: OrderManagementEventReader [--file logs/events.bin] [--type order_created|order_status|stock|login|logout]
+//                                   [--entity ID] [--from "YYYY-MM-DD[ HH:MM:SS]"] [--to "..."]
+//                                   [--limit N] [--count] [--replay]
+#include "utils/EventLog.h"
+#include "models/Order.h"
+#include <iostream>
+#include <map>
+#include <string>
+#include <ctime>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: OrderManagementEventReader [options]\n"
+                  << "  --file PATH        Event log to read (default logs/events.bin)\n"
+                  << "  --type NAME        order_created, order_status, stock, login or logout\n"
+                  << "  --entity ID        Order or product id\n"
+                  << "  --from DATETIME    Earliest event, \"YYYY-MM-DD\" or \"YYYY-MM-DD HH:MM:SS\"\n"
+                  << "  --to DATETIME      Latest event\n"
+                  << "  --limit N          Print at most N events\n"
+                  << "  --count            Only print the number of matching events\n"
+                  << "  --replay           Rebuild final order statuses and stock levels\n";
+    }
+
+    bool parseDateTime(const std::string &text, bool endOfDay, std::int64_t &epoch)
+    {
+        std::tm tm{};
+        int matched = std::sscanf(text.c_str(), "%d-%d-%d %d:%d:%d",
+                                  &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                                  &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+        if (matched != 3 && matched != 6)
+        {
+            return false;
+        }
+        if (matched == 3 && endOfDay)
+        {
+            tm.tm_hour = 23;
+            tm.tm_min = 59;
+            tm.tm_sec = 59;
+        }
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        tm.tm_isdst = -1;
+        epoch = static_cast<std::int64_t>(std::mktime(&tm));
+        return true;
+    }
+
+    struct ReplayState
+    {
+        std::map<int, OrderStatus> orderStatus;
+        std::map<int, int> productStock;
+        std::map<std::string, int> logins;
+        size_t ordersCreated = 0;
+
+        void apply(const EventRecord &event)
+        {
+            switch (event.type)
+            {
+            case EventType::ORDER_CREATED:
+                orderStatus[event.entityId] = OrderStatus::PENDING;
+                ++ordersCreated;
+                break;
+            case EventType::ORDER_STATUS_CHANGED:
+                orderStatus[event.entityId] = static_cast<OrderStatus>(event.newValue);
+                break;
+            case EventType::STOCK_UPDATED:
+                productStock[event.entityId] = event.newValue;
+                break;
+            case EventType::USER_LOGIN:
+                ++logins[event.text];
+                break;
+            case EventType::USER_LOGOUT:
+                break;
+            }
+        }
+
+        void print() const
+        {
+            std::map<OrderStatus, int> distribution;
+            for (const auto &entry : orderStatus)
+            {
+                ++distribution[entry.second];
+            }
+
+            std::cout << "Orders created: " << ordersCreated << "\n"
+                      << "Orders seen: " << orderStatus.size() << "\n";
+            for (const auto &entry : distribution)
+            {
+                std::cout << "  " << Order::statusToString(entry.first) << ": " << entry.second << "\n";
+            }
+
+            std::cout << "Products with stock changes: " << productStock.size() << "\n";
+            for (const auto &entry : productStock)
+            {
+                std::cout << "  product " << entry.first << ": " << entry.second << "\n";
+            }
+
+            std::cout << "Logins:\n";
+            for (const auto &entry : logins)
+            {
+                std::cout << "  " << entry.first << ": " << entry.second << "\n";
+            }
+        }
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    std::string filename = "logs/events.bin";
+    EventFilter filter;
+    long long limit = -1;
+    bool countOnly = false;
+    bool replay = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--file" && hasValue)
+        {
+            filename = argv[++i];
+        }
+        else if (arg == "--type" && hasValue)
+        {
+            filter.hasType = EventRecord::stringToType(argv[++i], filter.type);
+            if (!filter.hasType)
+            {
+                std::cerr << "Unknown event type: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--entity" && hasValue)
+        {
+            filter.entityId = std::atoi(argv[++i]);
+        }
+        else if ((arg == "--from" || arg == "--to") && hasValue)
+        {
+            std::int64_t &bound = arg == "--from" ? filter.fromTimestamp : filter.toTimestamp;
+            if (!parseDateTime(argv[++i], arg == "--to", bound))
+            {
+                std::cerr << "Invalid date: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--limit" && hasValue)
+        {
+            limit = std::atoll(argv[++i]);
+        }
+        else if (arg == "--count")
+        {
+            countOnly = true;
+        }
+        else if (arg == "--replay")
+        {
+            replay = true;
+        }
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    EventLogReader reader(filename);
+    ReplayState state;
+    size_t matched = 0;
+
+    bool ok = reader.forEach([&](const EventRecord &event)
+                             {
+                                 ++matched;
+                                 if (replay)
+                                 {
+                                     state.apply(event);
+                                 }
+                                 else if (!countOnly)
+                                 {
+                                     std::cout << event.toString() << '\n';
+                                 }
+                                 return limit < 0 || static_cast<long long>(matched) < limit; },
+                             filter);
+
+    if (!ok)
+    {
+        std::cerr << "Cannot read event log: " << filename << std::endl;
+        return 1;
+    }
+
+    if (replay)
+    {
+        state.print();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << matched << " matching events in " << seconds << "s";
+    if (reader.getCorruptRecordCount() > 0)
+    {
+        std::cerr << " (" << reader.getCorruptRecordCount() << " corrupt records skipped)";
+    }
+    std::cerr << std::endl;
+
+    if (countOnly)
+    {
+        std::cout << matched << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,551 @@
+// Replays a mix of operations against the managers from several threads and reports
+// throughput and latency percentiles per operation. This is the reference for
+// performance work: run it on the same data before and after a change and compare.
+// It changes the data directory it runs against, so point it at a copy.
+//
+// Usage: OrderManagementLoad [--data DIR] [--threads N] [--duration SECONDS | --ops N]
+//                            [--mix create=15,add=25,status=20,search=20,stock=10,login=10]
+//                            [--user NAME] [--password TEXT] [--seed N] [--json FILE] [--trace FILE]
+#include "managers/CustomerManager.h"
+#include "managers/OrderManager.h"
+#include "managers/ProductManager.h"
+#include "managers/UserManager.h"
+#include "utils/Database.h"
+#include "utils/EventLog.h"
+#include "utils/Histogram.h"
+#include "utils/Logger.h"
+#include "utils/Trace.h"
+#include "utils/Utils.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    enum Operation
+    {
+        CREATE,
+        ADD_ITEM,
+        STATUS,
+        SEARCH,
+        STOCK,
+        LOGIN,
+        OPERATION_COUNT
+    };
+
+    const char *const OPERATION_NAMES[OPERATION_COUNT] = {"create", "add", "status", "search", "stock", "login"};
+
+    struct Settings
+    {
+        std::string dataDir = "load_data/";
+        unsigned threads = 4;
+        double duration = 10.0;
+        long long ops = 0; // total operations; 0 runs for duration instead
+        std::array<int, OPERATION_COUNT> mix = {15, 25, 20, 20, 10, 10};
+        std::string username = "admin";
+        std::string password = "admin";
+        std::uint64_t seed = 1;
+        std::string jsonFile;
+        std::string traceFile;
+    };
+
+    struct Managers
+    {
+        ProductManager *products;
+        CustomerManager *customers;
+        OrderManager *orders;
+        UserManager *users;
+        int customerCount;
+        int productCount;
+    };
+
+    // An order this thread created and is moving through its life cycle
+    struct OpenOrder
+    {
+        int id;
+        OrderStatus status;
+        int items;
+    };
+
+    const char *const SEARCH_TERMS[] = {"an", "er", "li", "mo", "sa", "1", "2", "7"};
+
+    class Worker
+    {
+    private:
+        const Settings &settings;
+        const Managers &managers;
+        std::mt19937_64 random;
+        std::deque<OpenOrder> pending;     // taking items
+        std::deque<OpenOrder> progressing; // confirmed, on their way to delivery
+
+        int below(int n) { return static_cast<int>(random() % static_cast<std::uint64_t>(n)); }
+        int anyCustomer() { return 1 + below(managers.customerCount); }
+        int anyProduct() { return 1 + below(managers.productCount); }
+
+        Operation pick()
+        {
+            int total = 0;
+            for (int weight : settings.mix)
+            {
+                total += weight;
+            }
+            int roll = below(total);
+            for (int op = 0; op < OPERATION_COUNT; ++op)
+            {
+                roll -= settings.mix[op];
+                if (roll < 0)
+                {
+                    return static_cast<Operation>(op);
+                }
+            }
+            return SEARCH;
+        }
+
+        bool create()
+        {
+            int orderId = 0;
+            if (!managers.orders->createOrder(anyCustomer(), orderId))
+            {
+                return false;
+            }
+            pending.push_back({orderId, OrderStatus::PENDING, 0});
+            return true;
+        }
+
+        bool addItem()
+        {
+            OpenOrder &order = pending.back();
+            if (!managers.orders->addItemToOrder(order.id, anyProduct(), 1 + below(3)))
+            {
+                return false;
+            }
+            ++order.items;
+            return true;
+        }
+
+        // Confirms (or, if empty, cancels) the oldest pending order, or moves the
+        // oldest confirmed one a step towards delivery
+        bool advance()
+        {
+            if (!pending.empty() && (progressing.empty() || below(2) == 0))
+            {
+                OpenOrder order = pending.front();
+                pending.pop_front();
+                if (order.items == 0 || !managers.orders->confirmOrder(order.id))
+                {
+                    return managers.orders->cancelOrder(order.id) && order.items == 0;
+                }
+                order.status = OrderStatus::CONFIRMED;
+                progressing.push_back(order);
+                return true;
+            }
+
+            OpenOrder &order = progressing.front();
+            OrderStatus next = order.status == OrderStatus::CONFIRMED    ? OrderStatus::PROCESSING
+                               : order.status == OrderStatus::PROCESSING ? OrderStatus::SHIPPED
+                                                                         : OrderStatus::DELIVERED;
+            bool ok = managers.orders->updateOrderStatus(order.id, next);
+            order.status = next;
+            if (!ok || next == OrderStatus::DELIVERED)
+            {
+                progressing.pop_front();
+            }
+            return ok;
+        }
+
+        bool search()
+        {
+            const char *term = SEARCH_TERMS[below(static_cast<int>(sizeof(SEARCH_TERMS) / sizeof(SEARCH_TERMS[0])))];
+            switch (below(3))
+            {
+            case 0:
+                managers.products->searchByName(term);
+                break;
+            case 1:
+                managers.customers->searchByName(term);
+                break;
+            default:
+                managers.orders->getOrdersByCustomer(anyCustomer());
+                break;
+            }
+            return true;
+        }
+
+    public:
+        std::array<Histogram, OPERATION_COUNT> latency;
+        std::array<std::uint64_t, OPERATION_COUNT> errors{};
+
+        Worker(const Settings &settings, const Managers &managers, std::uint64_t seed)
+            : settings(settings), managers(managers), random(seed)
+        {
+        }
+
+        void step()
+        {
+            Operation op = pick();
+            // Item and status operations need an order to work on; make one first
+            if ((op == ADD_ITEM && pending.empty()) || (op == STATUS && pending.empty() && progressing.empty()))
+            {
+                op = CREATE;
+            }
+
+            TraceSpan span(OPERATION_NAMES[op]);
+            auto started = std::chrono::steady_clock::now();
+            bool ok = true;
+            switch (op)
+            {
+            case CREATE:
+                ok = create();
+                break;
+            case ADD_ITEM:
+                ok = addItem();
+                break;
+            case STATUS:
+                ok = advance();
+                break;
+            case SEARCH:
+                ok = search();
+                break;
+            case STOCK:
+                ok = managers.products->updateStock(anyProduct(), 1000 + below(1000));
+                break;
+            default:
+                ok = managers.users->login(settings.username, settings.password);
+                break;
+            }
+            auto elapsed = std::chrono::steady_clock::now() - started;
+
+            latency[op].record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            if (!ok)
+            {
+                ++errors[op];
+            }
+        }
+    };
+
+    // Gives an empty data directory something to work on
+    void seedData(Managers &managers)
+    {
+        if (managers.customers->getTotalCustomers() == 0)
+        {
+            std::vector<Customer> customers;
+            for (int i = 1; i <= 1000; ++i)
+            {
+                std::string id = std::to_string(i);
+                customers.push_back(Customer(0, "Load Customer " + id, "load" + id + "@example.com",
+                                             "+1-555-" + std::string(7 - id.size(), '0') + id,
+                                             id + " Load St", "Cairo", "Egypt"));
+            }
+            managers.customers->addCustomers(customers);
+        }
+        if (managers.products->getTotalProducts() == 0)
+        {
+            std::vector<Product> products;
+            for (int i = 1; i <= 200; ++i)
+            {
+                products.push_back(Product(0, "Load Product " + std::to_string(i), "Load test product",
+                                           i % 2 ? "Books" : "Electronics", 5.0 + i, 1000000, 10));
+            }
+            managers.products->addProducts(products);
+        }
+        managers.customerCount = managers.customers->getTotalCustomers();
+        managers.productCount = managers.products->getTotalProducts();
+    }
+
+    double micros(std::uint64_t nanos) { return nanos / 1000.0; }
+
+    void printReport(const std::array<Histogram, OPERATION_COUNT> &latency,
+                     const std::array<std::uint64_t, OPERATION_COUNT> &errors, const Histogram &all,
+                     std::uint64_t allErrors, double seconds)
+    {
+        std::printf("%-8s %10s %8s %10s %10s %10s %10s %10s %10s\n", "op", "count", "errors", "ops/s", "mean us",
+                    "p50 us", "p99 us", "p999 us", "max us");
+        auto row = [seconds](const char *name, const Histogram &h, std::uint64_t errorCount)
+        {
+            std::printf("%-8s %10llu %8llu %10.0f %10.1f %10.1f %10.1f %10.1f %10.1f\n", name,
+                        static_cast<unsigned long long>(h.getCount()), static_cast<unsigned long long>(errorCount),
+                        h.getCount() / seconds, h.getMean() / 1000.0, micros(h.percentile(50)),
+                        micros(h.percentile(99)), micros(h.percentile(99.9)), micros(h.getMax()));
+        };
+        for (int op = 0; op < OPERATION_COUNT; ++op)
+        {
+            if (latency[op].getCount() > 0)
+            {
+                row(OPERATION_NAMES[op], latency[op], errors[op]);
+            }
+        }
+        row("all", all, allErrors);
+    }
+
+    bool writeJson(const std::string &filename, const Settings &settings,
+                   const std::array<Histogram, OPERATION_COUNT> &latency,
+                   const std::array<std::uint64_t, OPERATION_COUNT> &errors, const Histogram &all,
+                   std::uint64_t allErrors, double seconds)
+    {
+        std::ofstream out(filename);
+        if (!out)
+        {
+            return false;
+        }
+
+        auto entry = [&out, seconds](const char *name, const Histogram &h, std::uint64_t errorCount)
+        {
+            char text[512];
+            std::snprintf(text, sizeof(text),
+                          "{\"name\":\"%s\",\"count\":%llu,\"errors\":%llu,\"ops_per_second\":%.1f,"
+                          "\"mean_us\":%.2f,\"p50_us\":%.2f,\"p99_us\":%.2f,\"p999_us\":%.2f,\"max_us\":%.2f}",
+                          name, static_cast<unsigned long long>(h.getCount()),
+                          static_cast<unsigned long long>(errorCount), h.getCount() / seconds, h.getMean() / 1000.0,
+                          micros(h.percentile(50)), micros(h.percentile(99)), micros(h.percentile(99.9)),
+                          micros(h.getMax()));
+            out << text;
+        };
+
+        out << "{\"threads\":" << settings.threads << ",\"seconds\":" << seconds << ",\"operations\":[";
+        for (int op = 0; op < OPERATION_COUNT; ++op)
+        {
+            if (latency[op].getCount() > 0)
+            {
+                entry(OPERATION_NAMES[op], latency[op], errors[op]);
+                out << ",";
+            }
+        }
+        entry("all", all, allErrors);
+        out << "]}\n";
+        return static_cast<bool>(out);
+    }
+
+    bool parseMix(const std::string &text, std::array<int, OPERATION_COUNT> &mix)
+    {
+        std::array<int, OPERATION_COUNT> parsed{};
+        for (const auto &part : Utils::split(text, ','))
+        {
+            std::vector<std::string> pair = Utils::split(part, '=');
+            if (pair.size() != 2)
+            {
+                return false;
+            }
+            int op = 0;
+            while (op < OPERATION_COUNT && pair[0] != OPERATION_NAMES[op])
+            {
+                ++op;
+            }
+            int weight = std::atoi(pair[1].c_str());
+            if (op == OPERATION_COUNT || weight < 0)
+            {
+                return false;
+            }
+            parsed[op] = weight;
+        }
+        int total = 0;
+        for (int weight : parsed)
+        {
+            total += weight;
+        }
+        if (total == 0)
+        {
+            return false;
+        }
+        mix = parsed;
+        return true;
+    }
+
+    // Loads the managers, runs the workers and prints the report. The managers are saved
+    // when this returns, before the logs are closed.
+    int run(const Settings &settings)
+    {
+        auto loadStarted = std::chrono::steady_clock::now();
+        ProductManager productManager;
+        CustomerManager customerManager;
+        UserManager userManager;
+        OrderManager orderManager(&productManager, &customerManager);
+        Managers managers{&productManager, &customerManager, &orderManager, &userManager, 0, 0};
+        seedData(managers);
+        std::printf("Loaded %d customers, %d products and %d orders from %s in %.2f s\n", managers.customerCount,
+                    managers.productCount, orderManager.getTotalOrders(), settings.dataDir.c_str(),
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStarted).count());
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (unsigned t = 0; t < settings.threads; ++t)
+        {
+            workers.push_back(std::make_unique<Worker>(settings, managers, settings.seed * 1000003 + t));
+        }
+
+        if (!settings.traceFile.empty())
+        {
+            Tracer::getInstance().start();
+        }
+
+        std::atomic<bool> stop(false);
+        std::atomic<long long> remaining(settings.ops);
+        auto started = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (auto &worker : workers)
+        {
+            threads.emplace_back([&, w = worker.get()]()
+                                 {
+                                     while (!stop.load(std::memory_order_relaxed))
+                                     {
+                                         if (settings.ops > 0 && remaining.fetch_sub(1, std::memory_order_relaxed) <= 0)
+                                         {
+                                             break;
+                                         }
+                                         w->step();
+                                     } });
+        }
+        if (settings.ops == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(settings.duration));
+            stop = true;
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        Tracer::getInstance().stop();
+
+        std::array<Histogram, OPERATION_COUNT> latency;
+        std::array<std::uint64_t, OPERATION_COUNT> errors{};
+        Histogram all;
+        std::uint64_t allErrors = 0;
+        for (const auto &worker : workers)
+        {
+            for (int op = 0; op < OPERATION_COUNT; ++op)
+            {
+                latency[op].merge(worker->latency[op]);
+                errors[op] += worker->errors[op];
+                all.merge(worker->latency[op]);
+                allErrors += worker->errors[op];
+            }
+        }
+
+        std::printf("%u threads, %.2f s\n", settings.threads, seconds);
+        printReport(latency, errors, all, allErrors, seconds);
+        if (!settings.jsonFile.empty() && !writeJson(settings.jsonFile, settings, latency, errors, all, allErrors, seconds))
+        {
+            std::cerr << "Cannot write " << settings.jsonFile << std::endl;
+            return 1;
+        }
+        if (!settings.traceFile.empty() && !Tracer::getInstance().writeChromeTrace(settings.traceFile))
+        {
+            std::cerr << "Cannot write " << settings.traceFile << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: OrderManagementLoad [options]\n"
+                  << "  --data DIR         Data directory to run against; it is modified (default load_data/).\n"
+                  << "                     An empty one is seeded with 1000 customers and 200 products.\n"
+                  << "  --threads N        Worker threads (default 4)\n"
+                  << "  --duration S       Seconds to run (default 10)\n"
+                  << "  --ops N            Run N operations in total instead of for a duration\n"
+                  << "  --mix LIST         Relative weights, e.g. create=15,add=25,status=20,search=20,stock=10,login=10\n"
+                  << "  --user NAME        Account for login operations (default admin)\n"
+                  << "  --password TEXT    Its password (default admin)\n"
+                  << "  --seed N           Random seed (default 1)\n"
+                  << "  --json FILE        Also write the report as JSON\n"
+                  << "  --trace FILE       Record a timeline of the run as Chrome trace JSON\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+
+        if (arg == "--data" && hasValue)
+        {
+            settings.dataDir = argv[++i];
+            if (settings.dataDir.back() != '/' && settings.dataDir.back() != '\\')
+            {
+                settings.dataDir += '/';
+            }
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            int threads = std::atoi(argv[++i]);
+            valid = threads > 0;
+            settings.threads = static_cast<unsigned>(threads);
+        }
+        else if (arg == "--duration" && hasValue)
+        {
+            settings.duration = std::atof(argv[++i]);
+            valid = settings.duration > 0;
+        }
+        else if (arg == "--ops" && hasValue)
+        {
+            settings.ops = std::atoll(argv[++i]);
+            valid = settings.ops > 0;
+        }
+        else if (arg == "--mix" && hasValue)
+        {
+            valid = parseMix(argv[++i], settings.mix);
+        }
+        else if (arg == "--user" && hasValue)
+        {
+            settings.username = argv[++i];
+        }
+        else if (arg == "--password" && hasValue)
+        {
+            settings.password = argv[++i];
+        }
+        else if (arg == "--seed" && hasValue)
+        {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--json" && hasValue)
+        {
+            settings.jsonFile = argv[++i];
+        }
+        else if (arg == "--trace" && hasValue)
+        {
+            settings.traceFile = argv[++i];
+        }
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+
+        if (!valid)
+        {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // The same set-up as the application, so logging and auditing are part of the cost
+    Logger &logger = Logger::getInstance();
+    logger.initialize("load_logs/application.log", LogLevel::INFO);
+    EventLog::getInstance().initialize("load_logs/events.bin");
+    if (!Database::getInstance().initialize(settings.dataDir))
+    {
+        std::cerr << "Cannot use data directory " << settings.dataDir << std::endl;
+        return 1;
+    }
+
+    int status = run(settings);
+
+    EventLog::getInstance().close();
+    logger.close();
+    return status;
+}